@@ -0,0 +1,218 @@
+/** @file   Arena.h
+    @author Philip Abbet
+
+    Declaration of the class 'Athena::Inputs::Arena'
+*/
+
+#ifndef _ATHENA_INPUTS_ARENA_H_
+#define _ATHENA_INPUTS_ARENA_H_
+
+#include <Athena-Inputs/Prerequisites.h>
+#include <stddef.h>
+#include <new>
+
+
+namespace Athena {
+namespace Inputs {
+
+//---------------------------------------------------------------------------------------
+/// @brief  Allocates memory blocks from big chunks, all released at once
+///
+/// The blocks are carved sequentially in chunks of a fixed size (a bigger block gets
+/// its own chunk). A released block is kept in a free list for the next block of the
+/// same size, so a container which inserts and erases elements stops using new
+/// memory once it reached its maximum size. The small blocks have a free list per
+/// size, the big ones share a list searched for the exact size.
+///
+/// The chunks are only given back to the heap by release() or by the destructor.
+///
+/// The blocks are aligned on 16 bytes, whatever the alignment of the memory returned
+/// by malloc().
+//---------------------------------------------------------------------------------------
+class ATHENA_INPUTS_SYMBOL Arena
+{
+    //_____ Internal types __________
+public:
+    //-----------------------------------------------------------------------------------
+    /// @brief  Statistics about an arena
+    //-----------------------------------------------------------------------------------
+    struct tStats
+    {
+        unsigned int    uiNbChunks;         ///< Number of chunks allocated from the heap
+        unsigned long   ulReservedSize;     ///< Total size of the chunks, in bytes
+        unsigned long   ulUsedSize;         ///< Size of the blocks in use, in bytes
+        unsigned long   ulNbAllocations;    ///< Number of blocks allocated (since the last release)
+        unsigned long   ulNbReuses;         ///< Number of blocks taken from the free lists
+    };
+
+
+    //_____ Construction / Destruction __________
+public:
+    //-----------------------------------------------------------------------------------
+    /// @brief  Constructor
+    ///
+    /// @param  uiChunkSize Size of the chunks, in bytes
+    //-----------------------------------------------------------------------------------
+    Arena(unsigned int uiChunkSize = 4096);
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Destructor
+    //-----------------------------------------------------------------------------------
+    ~Arena();
+
+
+    //_____ Methods __________
+public:
+    //-----------------------------------------------------------------------------------
+    /// @brief  Allocate a block
+    ///
+    /// @param  size    Size of the block, in bytes
+    /// @return         The block (aligned on 16 bytes)
+    //-----------------------------------------------------------------------------------
+    void* allocate(size_t size);
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Release a block (its memory is reused by the next block of the same
+    ///         size)
+    ///
+    /// @param  pBlock  The block
+    /// @param  size    Size of the block, in bytes (as given to allocate())
+    //-----------------------------------------------------------------------------------
+    void deallocate(void* pBlock, size_t size);
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Give all the chunks back to the heap
+    ///
+    /// @remark All the blocks allocated from the arena become invalid
+    //-----------------------------------------------------------------------------------
+    void release();
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Returns the statistics of the arena
+    //-----------------------------------------------------------------------------------
+    inline const tStats& getStats() const { return m_stats; }
+
+
+    //_____ Constants __________
+private:
+    static const unsigned int ALIGNMENT         = 16;   ///< Alignment of the blocks
+    static const unsigned int NB_SIZE_CLASSES   = 32;   ///< Number of free lists (blocks of up to 512 bytes)
+
+
+    //_____ Internal types __________
+private:
+    /// Header of a chunk
+    struct tChunk
+    {
+        tChunk* pNext;
+        size_t  size;
+    };
+
+    /// A released block, in a free list
+    struct tFreeBlock
+    {
+        tFreeBlock* pNext;
+        size_t      size;       ///< Size of the block (only set for the big blocks)
+    };
+
+
+    //_____ Attributes __________
+private:
+    unsigned int    m_uiChunkSize;                  ///< Size of the chunks
+    tChunk*         m_pChunks;                      ///< The chunks (the current one first)
+    char*           m_pCurrent;                     ///< Next free byte of the current chunk
+    char*           m_pEnd;                         ///< End of the current chunk
+    tFreeBlock*     m_freeLists[NB_SIZE_CLASSES];   ///< Released small blocks, by size class
+    tFreeBlock*     m_pBigFreeBlocks;               ///< Released big blocks
+    tStats          m_stats;                        ///< The statistics
+
+
+    //_____ Forbidden __________
+private:
+    Arena(const Arena&);
+    Arena& operator=(const Arena&);
+};
+
+
+//---------------------------------------------------------------------------------------
+/// @brief  STL allocator taking its memory from an arena
+//---------------------------------------------------------------------------------------
+template <typename T>
+class ArenaAllocator
+{
+    //_____ Internal types __________
+public:
+    typedef T           value_type;
+    typedef T*          pointer;
+    typedef const T*    const_pointer;
+    typedef T&          reference;
+    typedef const T&    const_reference;
+    typedef size_t      size_type;
+    typedef ptrdiff_t   difference_type;
+
+    template <typename U>
+    struct rebind
+    {
+        typedef ArenaAllocator<U> other;
+    };
+
+
+    //_____ Construction / Destruction __________
+public:
+    ArenaAllocator(Arena* pArena)
+    : m_pArena(pArena)
+    {
+    }
+
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other)
+    : m_pArena(other.getArena())
+    {
+    }
+
+
+    //_____ Methods __________
+public:
+    inline pointer address(reference x) const { return &x; }
+    inline const_pointer address(const_reference x) const { return &x; }
+
+    inline pointer allocate(size_type n, const void* = 0)
+    {
+        return static_cast<pointer>(m_pArena->allocate(n * sizeof(T)));
+    }
+
+    inline void deallocate(pointer p, size_type n)
+    {
+        m_pArena->deallocate(p, n * sizeof(T));
+    }
+
+    inline size_type max_size() const { return size_type(-1) / sizeof(T); }
+
+    inline void construct(pointer p, const T& value) { new ((void*) p) T(value); }
+    inline void destroy(pointer p) { p->~T(); }
+
+    inline Arena* getArena() const { return m_pArena; }
+
+
+    //_____ Attributes __________
+private:
+    Arena* m_pArena;
+};
+
+
+template <typename T, typename U>
+inline bool operator==(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b)
+{
+    return (a.getArena() == b.getArena());
+}
+
+template <typename T, typename U>
+inline bool operator!=(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b)
+{
+    return (a.getArena() != b.getArena());
+}
+
+}
+}
+
+#endif
@@ -0,0 +1,125 @@
+/** @file   CaptureDaemon.h
+    @author Philip Abbet
+
+    Declaration of the class 'Athena::Inputs::CaptureDaemon'
+*/
+
+#ifndef _ATHENA_INPUTS_CAPTUREDAEMON_H_
+#define _ATHENA_INPUTS_CAPTUREDAEMON_H_
+
+#include <Athena-Inputs/Prerequisites.h>
+#include <Athena-Inputs/Declarations.h>
+#include <Athena-Inputs/IEventsListener.h>
+#include <Athena-Inputs/SharedEventsRing.h>
+#include <OIS/OISInputManager.h>
+#include <vector>
+#include <map>
+
+
+namespace Athena {
+namespace Inputs {
+
+//---------------------------------------------------------------------------------------
+/// @brief  Owns the controllers in a dedicated process, and writes their events in a
+///         shared events ring
+///
+/// The game process connects to the ring with InputsUnit::connect(): the capture of
+/// the controllers is then never delayed by the frames of the game.
+///
+/// Usage (in the daemon process):
+/// @code
+/// CaptureDaemon daemon;
+/// daemon.init("MyGameInputs");
+/// daemon.createDevices(windowHandle);
+///
+/// while (bRunning)
+/// {
+///     daemon.capture();
+///     Thread::sleep(1);
+/// }
+/// @endcode
+///
+/// Instead of createDevices(), any controller can be added with addController() (for
+/// instance, one producing events without real devices).
+//---------------------------------------------------------------------------------------
+class ATHENA_INPUTS_SYMBOL CaptureDaemon: public IEventsListener
+{
+    //_____ Construction / Destruction __________
+public:
+    //-----------------------------------------------------------------------------------
+    /// @brief  Constructor
+    //-----------------------------------------------------------------------------------
+    CaptureDaemon();
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Destructor
+    //-----------------------------------------------------------------------------------
+    virtual ~CaptureDaemon();
+
+
+    //_____ Methods __________
+public:
+    //-----------------------------------------------------------------------------------
+    /// @brief  Create the shared events ring
+    ///
+    /// @param  strRingName Name of the shared events ring
+    /// @param  uiCapacity  Number of events in the ring
+    /// @return             'true' if successful
+    //-----------------------------------------------------------------------------------
+    bool init(const std::string& strRingName, unsigned int uiCapacity = 4096);
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Create the controllers corresponding to the devices of the machine (the
+    ///         keyboard, the mouse and the gamepads)
+    ///
+    /// @param  mainWindowHandle    Platform-specific handle of the window receiving the
+    ///                             inputs (see InputsUnit::init())
+    /// @return                     'true' if successful
+    //-----------------------------------------------------------------------------------
+    bool createDevices(void* mainWindowHandle);
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Add a controller, and declare it in the shared events ring
+    ///
+    /// The daemon takes the ownership of the controller. The controllers must be added
+    /// before the first call to capture().
+    ///
+    /// @param  pController     The controller
+    /// @return                 'true' if successful
+    //-----------------------------------------------------------------------------------
+    bool addController(Controller* pController);
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Read the inputs of the controllers, and write them in the shared events
+    ///         ring
+    //-----------------------------------------------------------------------------------
+    void capture();
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Returns the shared events ring
+    //-----------------------------------------------------------------------------------
+    inline const SharedEventsRing& getRing() const { return m_ring; }
+
+
+    //_____ Implementation of IEventsListener __________
+public:
+    //-----------------------------------------------------------------------------------
+    /// @brief  Called when an event occured on one of the controllers
+    ///
+    /// @param  pEvent  The event
+    //-----------------------------------------------------------------------------------
+    void onEvent(tInputEvent* pEvent);
+
+
+    //_____ Attributes __________
+private:
+    SharedEventsRing                        m_ring;         ///< The shared events ring
+    OIS::InputManager*                      m_pManager;     ///< The OIS input manager (if createDevices() was called)
+    std::vector<Controller*>                m_controllers;  ///< The controllers
+    std::map<Controller*, unsigned int>     m_devices;      ///< Index of each controller in the ring
+};
+
+}
+}
+
+#endif
@@ -0,0 +1,184 @@
+/** @file   ComboRecognizer.h
+    @author Philip Abbet
+
+    Declaration of the class 'Athena::Inputs::ComboRecognizer'
+*/
+
+#ifndef _ATHENA_INPUTS_COMBORECOGNIZER_H_
+#define _ATHENA_INPUTS_COMBORECOGNIZER_H_
+
+#include <Athena-Inputs/Prerequisites.h>
+#include <Athena-Inputs/Declarations.h>
+#include <vector>
+
+
+namespace Athena {
+namespace Inputs {
+
+//---------------------------------------------------------------------------------------
+/// @brief  Recognizes sequences of virtual events (combos)
+///
+/// A combo is a sequence of steps, each one being the press of a virtual key or a
+/// position of a virtual POV, with a maximum delay since the previous step (the
+/// timing window).
+///
+/// All the combos are compiled into one automaton (Aho-Corasick), which advances in
+/// constant time for each virtual event, whatever the number of combos. The
+/// automaton can be shared by several virtual controllers (see
+/// VirtualController::setComboRecognizer()), each one keeping its own state.
+///
+/// When a timing window is exceeded, the automaton restarts from the event that
+/// exceeded it. A combo that is the suffix of another one is recognized with the
+/// timing windows of the longest combo matched.
+//---------------------------------------------------------------------------------------
+class ATHENA_INPUTS_SYMBOL ComboRecognizer
+{
+    //_____ Internal types __________
+public:
+    //-----------------------------------------------------------------------------------
+    /// @brief  Represents a step of a combo
+    //-----------------------------------------------------------------------------------
+    struct tStep
+    {
+        tVirtualID      virtualID;      ///< The virtual key or POV
+        tControllerPart part;           ///< PART_KEY or PART_POV
+        tPOVPosition    position;       ///< Position of the POV (if part == PART_POV)
+        unsigned long   ulMaxDelay;     ///< Maximum delay since the previous step (ignored for the first step)
+    };
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  State of the automaton, kept by each virtual controller
+    //-----------------------------------------------------------------------------------
+    struct tState
+    {
+        unsigned int    uiNode;         ///< Current node of the automaton
+        unsigned int    uiLastSymbol;   ///< Last symbol consumed
+        unsigned long   ulTimestamp;    ///< Timestamp of the last symbol consumed
+        unsigned int    uiEpoch;        ///< Compilation of the automaton the state belongs to
+    };
+
+
+    //_____ Construction / Destruction __________
+public:
+    //-----------------------------------------------------------------------------------
+    /// @brief  Constructor
+    //-----------------------------------------------------------------------------------
+    ComboRecognizer();
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Destructor
+    //-----------------------------------------------------------------------------------
+    ~ComboRecognizer();
+
+
+    //_____ Management of the combos __________
+public:
+    //-----------------------------------------------------------------------------------
+    /// @brief  Add a combo
+    ///
+    /// The automaton must be compiled again before use (done automatically by the
+    /// virtual controllers).
+    ///
+    /// The combos starting with the same steps share their timing windows: a combo
+    /// using other maximum delays for those steps is rejected.
+    ///
+    /// @param  comboID     Virtual ID of the combo, fired as a virtual key pressed when
+    ///                     the combo is recognized
+    /// @param  steps       The steps of the combo
+    /// @return             'true' if successful
+    //-----------------------------------------------------------------------------------
+    bool addCombo(tVirtualID comboID, const std::vector<tStep>& steps);
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Remove all the combos
+    //-----------------------------------------------------------------------------------
+    void clear();
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Returns the number of combos
+    //-----------------------------------------------------------------------------------
+    inline unsigned int getNbCombos() const { return (unsigned int) m_combos.size(); }
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Build the automaton from the combos
+    //-----------------------------------------------------------------------------------
+    void compile();
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Indicates if the automaton is up-to-date with the combos
+    //-----------------------------------------------------------------------------------
+    inline bool isCompiled() const { return m_bCompiled; }
+
+
+    //_____ Recognition __________
+public:
+    //-----------------------------------------------------------------------------------
+    /// @brief  Reset a state of the automaton
+    ///
+    /// @retval state   The state
+    //-----------------------------------------------------------------------------------
+    void reset(tState &state) const;
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Advance a state of the automaton with a virtual event
+    ///
+    /// The events that aren't part of any combo (including the releases of the virtual
+    /// keys and the axes) are ignored. A state from a previous compilation of the
+    /// automaton is reset first.
+    ///
+    /// @remark The automaton must be compiled
+    /// @retval state   The state
+    /// @param  event   The virtual event
+    /// @retval pCombos The virtual IDs of the recognized combos
+    /// @return         The number of recognized combos
+    //-----------------------------------------------------------------------------------
+    unsigned int advance(tState &state, const tVirtualEvent& event,
+                         const tVirtualID* &pCombos) const;
+
+
+    //_____ Internal methods __________
+private:
+    //-----------------------------------------------------------------------------------
+    /// @brief  Returns the first symbol of a virtual ID, or allocates it
+    //-----------------------------------------------------------------------------------
+    unsigned int getOrCreateSymbol(tVirtualID virtualID, tControllerPart part);
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Returns the symbol corresponding to a virtual event, NO_SYMBOL if none
+    //-----------------------------------------------------------------------------------
+    unsigned int getSymbol(const tVirtualEvent& event) const;
+
+
+    //_____ Internal types __________
+private:
+    struct tCombo
+    {
+        tVirtualID                  comboID;        ///< Virtual ID of the combo
+        std::vector<unsigned int>   symbols;        ///< Symbols of the steps
+        std::vector<unsigned long>  maxDelays;      ///< Maximum delays of the steps
+    };
+
+
+    //_____ Attributes __________
+private:
+    std::vector<tCombo>         m_combos;           ///< The combos
+    bool                        m_bCompiled;        ///< Indicates if the automaton is up-to-date
+    unsigned int                m_uiEpoch;          ///< Number of compilations of the automaton
+
+    // Symbols
+    std::vector<unsigned int>   m_firstSymbols;     ///< First symbol of each virtual ID, indexed by virtual ID
+    std::vector<tControllerPart> m_parts;           ///< Part of each virtual ID, indexed by virtual ID
+    unsigned int                m_uiNbSymbols;      ///< Number of symbols
+
+    // Automaton
+    std::vector<unsigned int>   m_transitions;      ///< Transitions (nb nodes x nb symbols)
+    std::vector<unsigned int>   m_depths;           ///< Depth of each node
+    std::vector<unsigned long>  m_maxDelays;        ///< Maximum delay to reach each node
+    std::vector<unsigned int>   m_outputOffsets;    ///< Index of the first combo recognized at each node (+ 1 entry)
+    std::vector<tVirtualID>     m_outputs;          ///< Combos recognized at each node, flattened
+};
+
+}
+}
+
+#endif
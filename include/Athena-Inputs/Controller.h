@@ -27,7 +27,12 @@ namespace Inputs {
 /// report them (there can be more than one listener per controller).
 ///
 /// A controller can be activated and deactivated, in which case its inputs will
-/// not be read.
+/// not be read. The Inputs Unit only activates its controllers while a virtual part
+/// is bound to them, or while they have other listeners than the unit (see
+/// registerListener()).
+///
+/// A controller isn't necessarily backed by an OIS object: the controllers whose
+/// inputs are read elsewhere (see RemoteController) only provide a type and a name.
 //---------------------------------------------------------------------------------------
 class ATHENA_INPUTS_SYMBOL Controller
 {
@@ -40,6 +45,14 @@ public:
     //-----------------------------------------------------------------------------------
     Controller(OIS::Object* pOISObject, unsigned int uiIndex);
 
+    //-----------------------------------------------------------------------------------
+    /// @brief  Constructor, for a controller without OIS object
+    /// @param  type        The type of the controller
+    /// @param  uiIndex     The index of the controller
+    /// @param  strName     The name of the controller
+    //-----------------------------------------------------------------------------------
+    Controller(OIS::Type type, unsigned int uiIndex, const std::string& strName);
+
     //-----------------------------------------------------------------------------------
     /// @brief  Destructor
     //-----------------------------------------------------------------------------------
@@ -52,7 +65,7 @@ public:
     /// @brief  Return the type of the controller (keyboard, mouse or gamepad)
     /// @return The type of the controller
     //-----------------------------------------------------------------------------------
-    inline const OIS::Type getType() const { return m_pOISObject->type(); }
+    inline const OIS::Type getType() const { return m_type; }
 
     //-----------------------------------------------------------------------------------
     /// @brief  Returns the index of the controller. The couple (type, index) uniquely
@@ -65,7 +78,24 @@ public:
     /// @brief  Returns the name of the controller (reported by its driver)
     /// @return The name of the controller
     //-----------------------------------------------------------------------------------
-    inline const std::string& getName() const { return m_pOISObject->vendor(); }
+    inline const std::string& getName() const { return m_strName; }
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Returns the identity of the controller
+    ///
+    /// Unlike the index, the identity of a controller doesn't depend on the order in
+    /// which the controllers were connected. It is used to rebind the virtual
+    /// controllers when a gamepad is replugged.
+    /// @return The identity of the controller
+    //-----------------------------------------------------------------------------------
+    inline const std::string& getIdentity() const { return m_strIdentity; }
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Set the identity of the controller
+    ///
+    /// @param  strIdentity The identity of the controller
+    //-----------------------------------------------------------------------------------
+    inline void setIdentity(const std::string& strIdentity) { m_strIdentity = strIdentity; }
 
     // //-----------------------------------------------------------------------------------
     // /// @brief  Returns the number of keys on the controller
@@ -89,14 +119,20 @@ public:
     /// @brief  Indicates if the controller is activated
     /// @return 'true' if the controller is activated
     //-----------------------------------------------------------------------------------
-    inline bool isActive() const { return m_pOISObject->buffered(); }
+    inline bool isActive() const { return (m_pOISObject ? m_pOISObject->buffered() : m_bActive); }
 
     //-----------------------------------------------------------------------------------
     /// @brief  Activate/Deactivate the controller
     ///
     /// @param  bActivate   Indicates if the controller must be activated
     //-----------------------------------------------------------------------------------
-    inline void activate(bool bActivate = true) { m_pOISObject->setBuffered(bActivate); }
+    virtual void activate(bool bActivate = true)
+    {
+        if (m_pOISObject)
+            m_pOISObject->setBuffered(bActivate);
+        else
+            m_bActive = bActivate;
+    }
 
     //-----------------------------------------------------------------------------------
     /// @brief  Read the inputs of the controller
@@ -104,7 +140,13 @@ public:
     /// Must be overriden by each controller
     /// @return 'true' if successful
     //-----------------------------------------------------------------------------------
-    virtual void capture() { m_pOISObject->capture(); }
+    virtual void capture() { if (m_pOISObject) m_pOISObject->capture(); }
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Returns the number of events dropped by the controller itself (for
+    ///         instance, because they repeated the previous value of a part)
+    //-----------------------------------------------------------------------------------
+    virtual unsigned long getNbSuppressedEvents() const { return 0; }
 
     //-----------------------------------------------------------------------------------
     /// @brief  Returns a string representation of the controller
@@ -154,6 +196,9 @@ public:
     //-----------------------------------------------------------------------------------
     /// @brief  Register an events listener
     ///
+    /// A controller of the Inputs Unit is activated while it has other listeners than
+    /// the unit, even if no virtual part is bound to it.
+    ///
     /// @param  pListener   The listener
     //-----------------------------------------------------------------------------------
     void registerListener(IEventsListener* pListener);
@@ -165,6 +210,31 @@ public:
     //-----------------------------------------------------------------------------------
     void removeListener(IEventsListener* pListener);
 
+    //-----------------------------------------------------------------------------------
+    /// @brief  Returns the number of events listeners registered
+    //-----------------------------------------------------------------------------------
+    inline unsigned int getNbListeners() const { return (unsigned int) m_listeners.size(); }
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Returns the current time, in milliseconds, used to timestamp the events
+    ///
+    /// The clock is monotonic and shared by all the processes of the machine (the
+    /// origin is unspecified).
+    ///
+    /// @remark OIS doesn't report the moment of the events: they are timestamped when
+    ///         capture() reads them, so all the events of a capture share about the
+    ///         same timestamp. A capture daemon (see CaptureDaemon) reading the
+    ///         controllers more often than the frames gives finer timestamps.
+    //-----------------------------------------------------------------------------------
+    static unsigned long getTimestamp();
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Returns the current time, in microseconds, used to measure durations
+    ///
+    /// The clock is monotonic (the origin is unspecified).
+    //-----------------------------------------------------------------------------------
+    static unsigned long getPreciseTimestamp();
+
 
     //_____ Internal types __________
 protected:
@@ -176,8 +246,12 @@ protected:
 
     //_____ Attributes __________
 protected:
-    OIS::Object*    m_pOISObject;   ///< The OIS controller object
+    OIS::Object*    m_pOISObject;   ///< The OIS controller object (can be 0)
+    OIS::Type       m_type;         ///< Type of the controller
     unsigned int    m_uiIndex;      ///< Index of the controller
+    std::string     m_strName;      ///< Name of the controller
+    std::string     m_strIdentity;  ///< Identity of the controller
+    bool            m_bActive;      ///< Indicates if the controller is activated (without OIS object)
 
     unsigned int    m_uiNbKeys;     ///< Number of keys
     unsigned int    m_uiNbAxes;     ///< Number of axes
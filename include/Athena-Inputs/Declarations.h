@@ -85,18 +85,68 @@ struct tVirtualEvent
 };
 
 
+//-----------------------------------------------------------------------------------
+/// @brief  Identifies a virtual part (on a virtual controller)
+///
+/// The virtual keys, axes and POVs have separate IDs: the same virtual ID can be used
+/// by several parts.
+//-----------------------------------------------------------------------------------
+struct tVirtualPart
+{
+    tControllerPart     part;           ///< Part type
+    tVirtualID          virtualID;      ///< Virtual ID of the part
+};
+
+
 //-----------------------------------------------------------------------------------
 /// @brief  Represents a virtual key (on a virtual controller)
+///
+/// The real key to which the virtual key is bound isn't stored in the virtual key,
+/// which only contains what the frames use (see tVirtualKeySource).
 //-----------------------------------------------------------------------------------
 struct tVirtualKey
 {
-    Controller*     pController;        ///< The real controller
-    tKey            key;                ///< The real key
+    // Ordered by alignment (no padding between the fields)
+    unsigned long   ulPressTimestamp;   ///< Timestamp of the last press of the key
+    unsigned long   ulReleaseTimestamp; ///< Timestamp of the last release of the key
+    unsigned int    uiGeneration;       ///< Generation of the virtual controller the state belongs to
     bool            bPressed;           ///< Indicates if the virtual key is pressed or not
     bool            bToggled;           ///< Indicates if the virtual key was just toggled
+};
+
+
+//-----------------------------------------------------------------------------------
+/// @brief  Represents the real key to which a virtual key is bound (see
+///         VirtualController::getVirtualKeySource())
+//-----------------------------------------------------------------------------------
+struct tVirtualKeySource
+{
+    Controller*     pController;        ///< The real controller (0 if unbound, or for a chord)
+    tKey            key;                ///< The real key
     bool            bHasShortcut;       ///< Indicates if the virtual key has a shortcut
-    unsigned long   ulPressTimestamp;   ///< Timestamp of the last press of the key
-    unsigned long   ulReleaseTimestamp; ///< Timestamp of the last release of the key
+};
+
+
+//-----------------------------------------------------------------------------------
+/// @brief  Represents a real key used by a chord (see
+///         VirtualController::addVirtualChord())
+//-----------------------------------------------------------------------------------
+struct tChordKey
+{
+    Controller*     pController;        ///< The real controller
+    tKey            key;                ///< The real key
+};
+
+
+//-----------------------------------------------------------------------------------
+/// @brief  Represents a virtual key to add (see VirtualController::addVirtualKeys())
+//-----------------------------------------------------------------------------------
+struct tVirtualKeyBinding
+{
+    tVirtualID      virtualID;          ///< ID of the virtual key
+    Controller*     pController;        ///< Controller on which is the real key
+    tKey            key;                ///< The real key
+    std::string     strShortcut;        ///< Shortcut of the virtual key (can be empty)
 };
 
 
@@ -122,6 +172,41 @@ union tVirtualAxisRealPart
 };
 
 
+//-----------------------------------------------------------------------------------
+/// @brief  Conditioning applied to the value of a virtual axis
+///
+/// The raw value of the axis is normalized (using iRange), then the dead zone, the
+/// saturation, the response curve, the inversion and the scale are applied, in that
+/// order. The result is clamped to [-1, 1].
+///
+/// When 'radialPair' is set, the dead zone and the saturation are computed from the
+/// magnitude of the vector made of the axis and its paired axis (radial dead zone)
+/// instead of the value of the axis alone (axial dead zone).
+//-----------------------------------------------------------------------------------
+struct tAxisConditioning
+{
+    int         iRange;         ///< Raw value corresponding to a normalized value of 1
+    float       fDeadZone;      ///< Normalized dead zone, in [0, 1[
+    float       fSaturation;    ///< Normalized value above which the output is maximal, in ]fDeadZone, 1]
+    float       fCurve;         ///< Response curve: 0 = linear, 1 = cubic
+    float       fScale;         ///< Scale applied to the output
+    bool        bInverted;      ///< Indicates if the axis is inverted
+    tVirtualID  radialPair;     ///< Axis paired with this one for a radial dead zone (0: none)
+};
+
+
+//-----------------------------------------------------------------------------------
+/// @brief  Enumerates the ways the changes of a virtual axis made from a real axis are
+///         reported (see VirtualController::setAxisChangePolicy())
+//-----------------------------------------------------------------------------------
+enum tAxisChangePolicy
+{
+    AXIS_CHANGE_ALWAYS,         ///< Each move is reported
+    AXIS_CHANGE_THRESHOLD,      ///< Moves since the last report of at least a threshold are reported
+    AXIS_CHANGE_QUANTIZED,      ///< Moves to another bucket of values are reported
+};
+
+
 //-----------------------------------------------------------------------------------
 /// @brief  Represents a virtual axis (on a virtual controller)
 ///
@@ -129,15 +214,25 @@ union tVirtualAxisRealPart
 ///    - A real axis
 ///    - A POV (either the up/down part, or the left/right one)
 ///    - Two keys
+///
+/// Besides its raw value, a virtual axis has a conditioned value (see
+/// tAxisConditioning), updated at the end of each frame.
 //-----------------------------------------------------------------------------------
 struct tVirtualAxis
 {
     Controller*             pController;        ///< The real controller
     tControllerPart         part;               ///< Indicates from which part(s) this virtual axis is made
     bool                    bChanged;           ///< Indicates if the axis value has changed
+    bool                    bQueued;            ///< Indicates if the conditioned value must be computed at the end of the frame
     tVirtualAxisRealPart    realPart;
     int                     iValue;             ///< Value of the axis
+    float                   fValue;             ///< Conditioned value of the axis, in [-1, 1]
     unsigned long           ulTimestamp;        ///< Timestamp of the last change
+    unsigned int            uiGeneration;       ///< Generation of the virtual controller the state belongs to
+    int                     iReportedValue;     ///< Value of the axis when its last change was reported
+    tAxisConditioning       conditioning;       ///< Conditioning of the value of the axis
+    tAxisChangePolicy       changePolicy;       ///< How the changes of the axis are reported
+    int                     iChangeStep;        ///< Threshold or size of the buckets (see changePolicy)
 };
 
 
@@ -152,10 +247,11 @@ struct tVirtualPOVShortcuts
 
 struct tVirtualPOVRealPartKeys
 {
-    tKey    keyUp;                      ///< The real key mapped to the UP side of the virtual POV
-    tKey    keyDown;                    ///< The real key mapped to the DOWN side of the virtual POV
-    tKey    keyLeft;                    ///< The real key mapped to the LEFT side of the virtual POV
-    tKey    keyRight;                   ///< The real key mapped to the RIGHT side of the virtual POV
+    tKey            keyUp;              ///< The real key mapped to the UP side of the virtual POV
+    tKey            keyDown;            ///< The real key mapped to the DOWN side of the virtual POV
+    tKey            keyLeft;            ///< The real key mapped to the LEFT side of the virtual POV
+    tKey            keyRight;           ///< The real key mapped to the RIGHT side of the virtual POV
+    unsigned int    uiHeld;             ///< Directions held, and which one of each pair was pressed last
 };
 
 
@@ -165,7 +261,9 @@ struct tVirtualPOVRealPartAxes
     tAxis           axisLeftRight;      ///< The real axis mapped to the LEFT/RIGHT part of the virtual POV
     int             iUpDownPos;         ///< Store the UP/DOWN axis position
     int             iLeftRightPos;      ///< Store the ULEFT/RIGHT axis position
-    tPOVPosition    tempPosition;       ///< Temporary value used by the computation of the POV position
+    int             iThreshold;         ///< Axis value from which a direction is engaged
+    int             iHysteresis;        ///< An engaged direction is released below (iThreshold - iHysteresis)
+    unsigned long   ulTimestamp;        ///< Timestamp of the last move of the axes
 };
 
 
@@ -185,19 +283,25 @@ union tVirtualPOVRealPart
 ///    - Two axes
 ///    - Four keys
 ///
-/// The shortcuts of a POV can be combined to make 'diagonals' shortcuts.
+/// The shortcuts of a POV can be combined to make 'diagonals' shortcuts. They aren't
+/// stored in the virtual POV, which only contains what the frames use (see
+/// VirtualController::getPOVShortcuts()).
 //-----------------------------------------------------------------------------------
 struct tVirtualPOV
 {
-    Controller*             pController;                ///< The real controller
-    tControllerPart         part;                       ///< Indicates from which part(s) this virtual POV is made
+    // State (updated each frame)
     bool                    bChanged;                   ///< Indicates if the POV value has changed
-    tVirtualPOVRealPart     realPart;
-    tVirtualPOVShortcuts    shortcuts;                  ///< Shortcut of the virtual POV
+    bool                    bQueued;                    ///< Indicates if the position must be computed at the end of the frame (made from axes)
     tPOVPosition            position;                   ///< Current position of the virtual POV
     tPOVPosition            previousPosition;           ///< Previous position of the virtual POV
     unsigned long           ulLastChangeTimestamp;      ///< Timestamp of the last change of position
     unsigned long           ulPreviousChangeTimestamp;  ///< Timestamp of the previous change of position
+    unsigned int            uiGeneration;               ///< Generation of the virtual controller the state belongs to
+
+    // Source
+    Controller*             pController;                ///< The real controller
+    tControllerPart         part;                       ///< Indicates from which part(s) this virtual POV is made
+    tVirtualPOVRealPart     realPart;
 };
 
 
@@ -225,6 +329,13 @@ const tAxis SLIDER_0        = 64;                           ///< Slider 0
 const tAxis SLIDER_1        = 128;                          ///< Slider 1
 const tAxis AXIS_ALL        = 255;                          ///< All the axes
 
+// Ranges of the raw values of the axes
+const int AXIS_RANGE_ANALOG     = 32768;                    ///< Range of an analog axis (gamepad)
+const int AXIS_RANGE_DIGITAL    = 255;                      ///< Range of an axis made from keys or a POV
+
+// Chords
+const unsigned int MAX_CHORD_KEYS   = 32;                   ///< Maximum number of different real keys used by the chords of a virtual controller
+
 // Mouse keys
 const tKey MOUSEKEY_LEFT    = 0x01;                         ///< Left mouse key
 const tKey MOUSEKEY_RIGHT   = 0x02;                         ///< Right mouse key
@@ -9,23 +9,33 @@
 
 #include <Athena-Inputs/Controller.h>
 #include <OIS/OISJoyStick.h>
+#include <vector>
 
 
 namespace Athena {
 namespace Inputs {
 
 //---------------------------------------------------------------------------------------
-/// @brief  Represents a mouse
+/// @brief  Represents a gamepad
+///
+/// OIS reports the axes and POVs of a joystick again even when their value didn't
+/// change: the repeated values are dropped here, before reaching the listeners.
 //---------------------------------------------------------------------------------------
 class ATHENA_INPUTS_SYMBOL Gamepad: public Controller, public OIS::JoyStickListener
 {
+    //_____ Constants __________
+public:
+    static const unsigned int MAX_POVS  = 4;    ///< Number of POVs whose last value is remembered (the ones of OIS)
+
+
     //_____ Construction / Destruction __________
 public:
     //-----------------------------------------------------------------------------------
     /// @brief  Constructor
     /// @param  pOISObject  The OIS controller object
+    /// @param  uiIndex     The index of the gamepad
     //-----------------------------------------------------------------------------------
-    Gamepad(OIS::Object* pOISObject);
+    Gamepad(OIS::Object* pOISObject, unsigned int uiIndex = 1);
 
     //-----------------------------------------------------------------------------------
     /// @brief  Destructor
@@ -40,6 +50,38 @@ public:
         return static_cast<OIS::JoyStick*>(m_pOISObject);
     }
 
+    //-----------------------------------------------------------------------------------
+    /// @brief  Returns the number of axis events dropped because the value of the axis
+    ///         didn't change
+    //-----------------------------------------------------------------------------------
+    inline unsigned long getNbSuppressedAxisEvents() const { return m_ulNbSuppressedAxisEvents; }
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Returns the number of POV events dropped because the direction of the
+    ///         POV didn't change
+    //-----------------------------------------------------------------------------------
+    inline unsigned long getNbSuppressedPOVEvents() const { return m_ulNbSuppressedPOVEvents; }
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Returns the number of axis and POV events dropped because their value
+    ///         didn't change
+    //-----------------------------------------------------------------------------------
+    virtual unsigned long getNbSuppressedEvents() const
+    {
+        return m_ulNbSuppressedAxisEvents + m_ulNbSuppressedPOVEvents;
+    }
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Activate/Deactivate the gamepad
+    ///
+    /// The values of the axes and POVs sent before are forgotten when the gamepad is
+    /// activated, so their first events aren't dropped (the virtual parts bound since
+    /// don't know them). The values of all the axes reported by OIS are remembered.
+    ///
+    /// @param  bActivate   Indicates if the gamepad must be activated
+    //-----------------------------------------------------------------------------------
+    virtual void activate(bool bActivate = true);
+
 
     //_____ Implementation of OIS::MouseListener __________
 public:
@@ -48,6 +90,16 @@ public:
     virtual bool axisMoved(const OIS::JoyStickEvent &arg, int axis);
     virtual bool sliderMoved(const OIS::JoyStickEvent &arg, int index);
     virtual bool povMoved(const OIS::JoyStickEvent &arg, int index);
+
+
+    //_____ Attributes __________
+protected:
+    std::vector<int>    m_axisValues;           ///< Last value sent for each axis
+    std::vector<bool>   m_knownAxes;            ///< Indicates if a value was sent for each axis
+    int                 m_povValues[MAX_POVS];  ///< Last direction sent for each POV
+    unsigned int        m_uiKnownPOVs;          ///< Bits of the POVs with a direction sent
+    unsigned long       m_ulNbSuppressedAxisEvents; ///< Number of axis events dropped (repeated value)
+    unsigned long       m_ulNbSuppressedPOVEvents;  ///< Number of POV events dropped (repeated direction)
 };
 
 }
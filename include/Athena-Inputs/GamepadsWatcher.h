@@ -0,0 +1,159 @@
+/** @file   GamepadsWatcher.h
+    @author Philip Abbet
+
+    Declaration of the class 'Athena::Inputs::GamepadsWatcher'
+*/
+
+#ifndef _ATHENA_INPUTS_GAMEPADSWATCHER_H_
+#define _ATHENA_INPUTS_GAMEPADSWATCHER_H_
+
+#include <Athena-Inputs/Prerequisites.h>
+#include <Athena-Inputs/Threading.h>
+#include <OIS/OISPrereqs.h>
+#include <vector>
+#include <string>
+
+
+namespace Athena {
+namespace Inputs {
+
+//---------------------------------------------------------------------------------------
+/// @brief  Detects the gamepads plugged or unplugged during the session
+///
+/// The enumeration of the gamepads and the opening of the new ones is done by a
+/// background thread, using its own OIS input managers, so the frame is never stalled
+/// by it.
+///
+/// Enumerating the gamepads means creating an OIS input manager and opening all of
+/// them, so it is only done when a cheap check (the list of the raw input devices on
+/// Windows, of the event devices on Linux) reports a change. On the other platforms,
+/// the gamepads are enumerated at each interval.
+///
+/// The Inputs Unit retrieves the changes at a safe point of its process() method,
+/// without waiting for the background thread (see retrieveChanges()).
+///
+/// The gamepads are identified by their identity (see getIdentity()), which is used
+/// to rebind the virtual controllers to a replugged gamepad. It is given when the
+/// gamepad is plugged, and kept until it is unplugged. The vanished gamepads are
+/// detected with their device key (see getDeviceKey()), so unplugging one of two
+/// identical gamepads doesn't change the identity of the other one.
+//---------------------------------------------------------------------------------------
+class ATHENA_INPUTS_SYMBOL GamepadsWatcher: public Thread
+{
+    //_____ Internal types __________
+public:
+    //-----------------------------------------------------------------------------------
+    /// @brief  Represents a gamepad opened by the background thread
+    //-----------------------------------------------------------------------------------
+    struct tDevice
+    {
+        std::string         strIdentity;    ///< Identity of the gamepad
+        OIS::JoyStick*      pJoyStick;      ///< The OIS object of the gamepad
+        OIS::InputManager*  pManager;       ///< The OIS input manager owning the object
+    };
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Represents a gamepad already opened
+    //-----------------------------------------------------------------------------------
+    struct tKnownDevice
+    {
+        std::string         strIdentity;    ///< Identity of the gamepad
+        std::string         strDeviceKey;   ///< Device key of the gamepad (see getDeviceKey())
+    };
+
+
+    //_____ Construction / Destruction __________
+public:
+    //-----------------------------------------------------------------------------------
+    /// @brief  Constructor
+    ///
+    /// @param  mainWindowHandle    Platform-specific handle of the main window of the
+    ///                             application
+    /// @param  known               The gamepads already opened
+    /// @param  uiInterval          Delay between two checks of the devices, in
+    ///                             milliseconds
+    //-----------------------------------------------------------------------------------
+    GamepadsWatcher(void* mainWindowHandle, const std::vector<tKnownDevice>& known,
+                    unsigned int uiInterval);
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Destructor
+    ///
+    /// Stop the background thread, and destroy the gamepads that weren't retrieved
+    //-----------------------------------------------------------------------------------
+    virtual ~GamepadsWatcher();
+
+
+    //_____ Methods __________
+public:
+    //-----------------------------------------------------------------------------------
+    /// @brief  Stop the background thread, and wait for its end
+    //-----------------------------------------------------------------------------------
+    void stop();
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Retrieve the gamepads plugged and unplugged since the last call
+    ///
+    /// Never waits for the background thread: if it is busy, nothing is retrieved and
+    /// the changes will be available at the next call.
+    ///
+    /// @retval added       The new gamepads (their OIS objects and managers now belong
+    ///                     to the caller)
+    /// @retval removed     Identities of the gamepads that vanished
+    /// @return             'true' if something was retrieved
+    //-----------------------------------------------------------------------------------
+    bool retrieveChanges(std::vector<tDevice> &added, std::vector<std::string> &removed);
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Returns the identity of a gamepad
+    ///
+    /// @param  strVendor   The name of the gamepad (reported by its driver)
+    /// @param  uiOrdinal   Number of gamepads with the same name enumerated before this
+    ///                     one
+    /// @return             The identity
+    //-----------------------------------------------------------------------------------
+    static std::string getIdentity(const std::string& strVendor, unsigned int uiOrdinal);
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Returns the device key of a gamepad
+    ///
+    /// Made from the name of the gamepad and the device ID given by OIS (the number of
+    /// its event device on Linux). It doesn't change while the gamepad stays plugged.
+    ///
+    /// @param  pObject     The OIS object of the gamepad
+    /// @return             The device key
+    //-----------------------------------------------------------------------------------
+    static std::string getDeviceKey(const OIS::Object* pObject);
+
+
+    //_____ Implementation of Thread __________
+protected:
+    virtual void run();
+
+
+    //_____ Internal methods __________
+private:
+    //-----------------------------------------------------------------------------------
+    /// @brief  Enumerate the gamepads and compare them with the known ones
+    //-----------------------------------------------------------------------------------
+    void scan();
+
+
+    //_____ Attributes __________
+private:
+    void*                       m_mainWindowHandle; ///< Handle of the main window
+    unsigned int                m_uiInterval;       ///< Delay between two checks of the devices
+    std::vector<tKnownDevice>   m_known;            ///< The known gamepads (background thread only)
+    std::string                 m_strSignature;     ///< Signature of the input devices at the last enumeration (background thread only)
+    bool                        m_bSignatureValid;  ///< Indicates if the signature was retrieved
+
+    Mutex                       m_mutex;            ///< Protects the following attributes
+    bool                        m_bStop;            ///< Indicates if the thread must stop
+    std::vector<tDevice>        m_added;            ///< Gamepads plugged since the last retrieval
+    std::vector<std::string>    m_removed;          ///< Gamepads unplugged since the last retrieval
+};
+
+}
+}
+
+#endif
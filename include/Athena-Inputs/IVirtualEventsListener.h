@@ -34,6 +34,11 @@ public:
     ///         attached to
     ///
     /// Must be overriden by each listener
+    ///
+    /// The events of a virtual axis bound to a relative axis of a mouse carry the
+    /// movement since the previous event of the axis, not the position: the movements
+    /// summed over the frame are given by the state of the virtual axis (see
+    /// VirtualController::getAxisValue()) and by Mouse::getFrameDelta().
     /// @param  pEvent  The event
     //-----------------------------------------------------------------------------------
     virtual void onEvent(tVirtualEvent* pEvent) = 0;
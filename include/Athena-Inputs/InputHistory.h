@@ -0,0 +1,176 @@
+/** @file   InputHistory.h
+    @author Philip Abbet
+
+    Declaration of the class 'Athena::Inputs::InputHistory'
+*/
+
+#ifndef _ATHENA_INPUTS_INPUTHISTORY_H_
+#define _ATHENA_INPUTS_INPUTHISTORY_H_
+
+#include <Athena-Inputs/Prerequisites.h>
+#include <Athena-Inputs/Declarations.h>
+#include <vector>
+
+
+namespace Athena {
+namespace Inputs {
+
+//---------------------------------------------------------------------------------------
+/// @brief  Keeps the state of a virtual controller during the last frames (rollback)
+///
+/// The state of each frame (the virtual keys as bits, the values of the virtual axes
+/// and the positions of the virtual POVs) is stored in a compact ring, allocated once
+/// at construction: recording a frame never allocates memory.
+///
+/// Each frame is identified by its number (chosen by the caller, usually a frame
+/// counter): the frame N is stored in the slot N % (number of frames). Recording,
+/// restoring and comparing a frame don't depend on the length of the history.
+///
+/// The layout of the frames is computed from the virtual parts of the virtual
+/// controller at construction, and the history keeps pointers to those virtual parts:
+/// it must not outlive the virtual controller, and rebuild() must be called when the
+/// virtual parts are remapped (added or bound again), which discards the history.
+//---------------------------------------------------------------------------------------
+class ATHENA_INPUTS_SYMBOL InputHistory
+{
+    //_____ Construction / Destruction __________
+public:
+    //-----------------------------------------------------------------------------------
+    /// @brief  Constructor
+    ///
+    /// @param  pVirtualController  The virtual controller
+    /// @param  uiNbFrames          Number of frames to keep
+    //-----------------------------------------------------------------------------------
+    InputHistory(VirtualController* pVirtualController, unsigned int uiNbFrames);
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Destructor
+    //-----------------------------------------------------------------------------------
+    ~InputHistory();
+
+
+    //_____ Methods __________
+public:
+    //-----------------------------------------------------------------------------------
+    /// @brief  Compute the layout of the frames again, from the current virtual parts
+    ///         of the virtual controller, and discard the history
+    //-----------------------------------------------------------------------------------
+    void rebuild();
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Returns the number of frames kept
+    //-----------------------------------------------------------------------------------
+    inline unsigned int getNbFrames() const { return m_uiNbFrames; }
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Store the current state of the virtual controller
+    ///
+    /// Overwrites the oldest frame of the ring.
+    ///
+    /// @param  ulFrame     Number of the frame
+    //-----------------------------------------------------------------------------------
+    void recordFrame(unsigned long ulFrame);
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Indicates if a frame is still in the history
+    ///
+    /// @param  ulFrame     Number of the frame
+    //-----------------------------------------------------------------------------------
+    bool hasFrame(unsigned long ulFrame) const;
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Set the state of the virtual controller to the one of a frame
+    ///
+    /// The virtual parts whose value differs from the current one are marked as
+    /// toggled/changed, so the game code can simulate the frame again. The state
+    /// derived from the values is restored too: the conditioned values of the axes,
+    /// and the real keys or axes the POVs are made from.
+    ///
+    /// @param  ulFrame     Number of the frame
+    /// @return             'false' if the frame isn't in the history anymore
+    //-----------------------------------------------------------------------------------
+    bool restoreFrame(unsigned long ulFrame);
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Indicates if two frames have the same state
+    ///
+    /// @param  ulFrame1    Number of the first frame
+    /// @param  ulFrame2    Number of the second frame
+    /// @return             'true' if both frames are in the history and are identical
+    //-----------------------------------------------------------------------------------
+    bool compareFrames(unsigned long ulFrame1, unsigned long ulFrame2) const;
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Indicates if a frame has the same state than the virtual controller
+    ///
+    /// @param  ulFrame     Number of the frame
+    /// @return             'true' if the frame is in the history and is identical
+    //-----------------------------------------------------------------------------------
+    bool compareFrame(unsigned long ulFrame) const;
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Modify the state of a virtual key in a frame (for instance, with the
+    ///         corrected input of a remote player)
+    ///
+    /// @param  ulFrame     Number of the frame
+    /// @param  virtualKey  The virtual key
+    /// @param  bPressed    Indicates if the key is pressed
+    /// @return             'true' if the state was modified (a rollback is needed)
+    //-----------------------------------------------------------------------------------
+    bool patchKey(unsigned long ulFrame, tVirtualID virtualKey, bool bPressed);
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Modify the value of a virtual axis in a frame
+    ///
+    /// @param  ulFrame     Number of the frame
+    /// @param  virtualAxis The virtual axis
+    /// @param  iValue      The value
+    /// @return             'true' if the state was modified (a rollback is needed)
+    //-----------------------------------------------------------------------------------
+    bool patchAxis(unsigned long ulFrame, tVirtualID virtualAxis, int iValue);
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Modify the position of a virtual POV in a frame
+    ///
+    /// @param  ulFrame     Number of the frame
+    /// @param  virtualPOV  The virtual POV
+    /// @param  position    The position
+    /// @return             'true' if the state was modified (a rollback is needed)
+    //-----------------------------------------------------------------------------------
+    bool patchPOV(unsigned long ulFrame, tVirtualID virtualPOV, tPOVPosition position);
+
+
+    //_____ Internal methods __________
+private:
+    //-----------------------------------------------------------------------------------
+    /// @brief  Returns the slot of a frame, or NO_SLOT if the frame isn't in the history
+    //-----------------------------------------------------------------------------------
+    unsigned int getSlot(unsigned long ulFrame) const;
+
+
+    //_____ Attributes __________
+private:
+    VirtualController*          m_pVirtualController;   ///< The virtual controller
+    unsigned int                m_uiNbFrames;           ///< Number of frames kept
+
+    // Layout
+    std::vector<tVirtualKey*>   m_keys;                 ///< The virtual keys, in the order of the frames
+    std::vector<tVirtualAxis*>  m_axes;                 ///< The virtual axes, in the order of the frames
+    std::vector<tVirtualPOV*>   m_povs;                 ///< The virtual POVs, in the order of the frames
+    std::vector<unsigned int>   m_keyIndices;           ///< Index of each virtual key in the frames, by virtual ID
+    std::vector<unsigned int>   m_axisIndices;          ///< Index of each virtual axis in the frames, by virtual ID
+    std::vector<unsigned int>   m_povIndices;           ///< Index of each virtual POV in the frames, by virtual ID
+    unsigned int                m_uiNbKeyWords;         ///< Number of words used by the keys of a frame
+
+    // Ring
+    std::vector<unsigned long>  m_frameNumbers;         ///< Number of the frame stored in each slot
+    std::vector<bool>           m_validSlots;           ///< Indicates if each slot contains a frame
+    std::vector<unsigned int>   m_keyBits;              ///< Keys of the frames (m_uiNbKeyWords per frame)
+    std::vector<int>            m_axisValues;           ///< Values of the axes of the frames
+    std::vector<tPOVPosition>   m_povPositions;         ///< Positions of the POVs of the frames
+};
+
+}
+}
+
+#endif
@@ -12,6 +12,8 @@
 #include <Athena-Inputs/Controller.h>
 #include <Athena-Inputs/VirtualController.h>
 #include <Athena-Inputs/IEventsListener.h>
+#include <Athena-Inputs/GamepadsWatcher.h>
+#include <Athena-Inputs/SharedEventsRing.h>
 #include <OIS/OISObject.h>
 #include <OIS/OISMouse.h>
 #include <OIS/OISJoyStick.h>
@@ -53,6 +55,69 @@ namespace Inputs {
 class ATHENA_INPUTS_SYMBOL InputsUnit: public Utils::Singleton<InputsUnit>,
                                        public IEventsListener
 {
+    //_____ Internal types __________
+public:
+    //-----------------------------------------------------------------------------------
+    /// @brief  Statistics about a controller
+    //-----------------------------------------------------------------------------------
+    struct tControllerStats
+    {
+        Controller*     pController;            ///< The controller
+        unsigned long   ulNbKeyEvents;          ///< Number of key events captured
+        unsigned long   ulNbAxisEvents;         ///< Number of axis events captured
+        unsigned long   ulNbPOVEvents;          ///< Number of POV events captured
+        unsigned long   ulNbSuppressedEvents;   ///< Number of events dropped by the controller
+    };
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Statistics about a virtual controller
+    //-----------------------------------------------------------------------------------
+    struct tVirtualControllerStats
+    {
+        std::string     strName;                ///< Name of the virtual controller
+        unsigned long   ulNbVirtualEvents;      ///< Number of virtual events notified
+        unsigned long   ulNbCoalescedEvents;    ///< Number of moves of the virtual axes not reported
+    };
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Statistics about the unit, refreshed at the end of each process()
+    ///
+    /// The numbers of events are counted since the initialisation, the times are in
+    /// microseconds.
+    //-----------------------------------------------------------------------------------
+    struct tStats
+    {
+        unsigned long                           ulNbFrames;             ///< Number of frames processed
+        std::vector<tControllerStats>           controllers;            ///< Statistics of the controllers
+        std::vector<tVirtualControllerStats>    virtualControllers;     ///< Statistics of the virtual controllers
+        unsigned long                           ulNbLostRemoteEvents;   ///< Number of events of the capture daemon overwritten before being read
+        unsigned long                           ulCaptureTime;          ///< Time spent reading the controllers during the last frame
+        unsigned long                           ulProcessTime;          ///< Time spent updating the virtual controllers during the last frame
+        unsigned long                           ulTotalCaptureTime;     ///< Time spent reading the controllers
+        unsigned long                           ulTotalProcessTime;     ///< Time spent updating the virtual controllers
+        unsigned int                            uiQueueDepth;           ///< Number of input events of the last frame
+        unsigned int                            uiPeakQueueDepth;       ///< Highest number of input events in a frame
+    };
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  A virtual ID to register (see registerVirtualIDs())
+    //-----------------------------------------------------------------------------------
+    struct tVirtualIDRegistration
+    {
+        std::string     strName;                ///< The name of the ID
+        tVirtualID      virtualID;              ///< The ID (0 to use a free one)
+    };
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  A shortcut to register (see registerShortcuts())
+    //-----------------------------------------------------------------------------------
+    struct tShortcutRegistration
+    {
+        std::string     strShortcut;            ///< The shortcut
+        tVirtualID      virtualID;              ///< The virtual ID associated with the shortcut
+    };
+
+
     //_____ Construction / Destruction __________
 public:
     //-----------------------------------------------------------------------------------
@@ -83,18 +148,72 @@ public:
     //-----------------------------------------------------------------------------------
     /// @brief  Initialise the Inputs Unit
     ///
+    /// The keyboard, the mouse and the gamepads plugged at startup are added as
+    /// controllers (see getController()).
+    ///
     /// @param  mainWindowHandle    Platform-specific handle of the main window of the
     ///                             application (Windows: the HWND, MacOS X: not used)
     /// @return                     'true' if successful
     //-----------------------------------------------------------------------------------
     bool init(void* mainWindowHandle);
 
+    //-----------------------------------------------------------------------------------
+    /// @brief  Initialise the Inputs Unit with the controllers of a capture daemon
+    ///         running in another process (see CaptureDaemon), instead of init()
+    ///
+    /// One remote controller is created for each controller declared in the shared
+    /// events ring of the daemon. Their events are read from the ring at the beginning
+    /// of process().
+    ///
+    /// @param  strRingName Name of the shared events ring of the daemon
+    /// @return             'true' if successful
+    //-----------------------------------------------------------------------------------
+    bool connect(const std::string& strRingName);
+
     //-----------------------------------------------------------------------------------
     /// @brief  Read the inputs on each active controller, and transmit them to the
     ///         virtual controllers
     //-----------------------------------------------------------------------------------
     void process();
 
+    //-----------------------------------------------------------------------------------
+    /// @brief  Enable/Disable the detection of the gamepads plugged or unplugged during
+    ///         the session
+    ///
+    /// The enumeration of the gamepads is done by a background thread (see
+    /// GamepadsWatcher). The new gamepads are added and the vanished ones removed at
+    /// the beginning of process(). The virtual parts bound to a vanished gamepad are
+    /// detached, and bound again when a gamepad with the same identity is plugged.
+    ///
+    /// @param  bEnable     'true' to enable the detection
+    /// @param  uiInterval  Delay between two checks of the devices, in milliseconds
+    //-----------------------------------------------------------------------------------
+    void enableHotPlug(bool bEnable, unsigned int uiInterval = 1000);
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Indicates if the detection of the gamepads plugged or unplugged during
+    ///         the session is enabled
+    //-----------------------------------------------------------------------------------
+    inline bool isHotPlugEnabled() const { return (m_pGamepadsWatcher != 0); }
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Returns the statistics of the unit
+    //-----------------------------------------------------------------------------------
+    inline const tStats& getStats() const { return m_stats; }
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Write the statistics of the unit in the log
+    //-----------------------------------------------------------------------------------
+    void logStats() const;
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Save the statistics of the unit in a JSON file
+    ///
+    /// @param  strFile     The name of the file
+    /// @return             'true' if successful
+    //-----------------------------------------------------------------------------------
+    bool saveStats(const std::string& strFile) const;
+
     //-----------------------------------------------------------------------------------
     /// @brief  Scan the inputs state of all the controllers. The purpose of this fonction
     ///         is to implement an 'Inputs configuration' screen
@@ -134,6 +253,47 @@ public:
     //-----------------------------------------------------------------------------------
     void _removeController(Controller* pController);
 
+    //-----------------------------------------------------------------------------------
+    /// @brief  Indicates that a virtual part is now bound to a controller
+    ///
+    /// The controller is activated when its first binding appears (see
+    /// _updateActivation()).
+    ///
+    /// @remark Called by the virtual controllers
+    /// @param  pController     The controller
+    //-----------------------------------------------------------------------------------
+    void _retainController(Controller* pController);
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Indicates that a virtual part isn't bound to a controller anymore
+    ///
+    /// The controller is deactivated (and not captured anymore) when its last binding
+    /// disappears, unless it has other listeners (see _updateActivation()).
+    ///
+    /// @remark Called by the virtual controllers
+    /// @param  pController     The controller
+    //-----------------------------------------------------------------------------------
+    void _releaseController(Controller* pController);
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Activate or deactivate a controller of the unit
+    ///
+    /// A controller is activated while a virtual part is bound to it, or while it has
+    /// other events listeners than the unit (see Controller::registerListener()).
+    ///
+    /// @remark Called by the controllers when a listener is registered or removed
+    /// @param  pController     The controller
+    //-----------------------------------------------------------------------------------
+    void _updateActivation(Controller* pController);
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Returns the number of virtual parts bound to a controller
+    ///
+    /// @param  pController     The controller
+    /// @return                 The number of bindings
+    //-----------------------------------------------------------------------------------
+    unsigned int getNbBindings(Controller* pController) const;
+
     //-----------------------------------------------------------------------------------
     /// @brief  Returns a controller
     ///
@@ -204,6 +364,16 @@ public:
     //-----------------------------------------------------------------------------------
     void destroyVirtualController(VirtualController* pVirtualController);
 
+    //-----------------------------------------------------------------------------------
+    /// @brief  Returns the statistics of the memory used by the virtual controllers
+    ///         themselves (the virtual parts of each one have their own, see
+    ///         VirtualController::getArenaStats())
+    //-----------------------------------------------------------------------------------
+    inline const Arena::tStats& getVirtualControllersArenaStats() const
+    {
+        return m_controllersArena.getStats();
+    }
+
     //-----------------------------------------------------------------------------------
     /// @brief  Register a virtual ID in the list
     ///
@@ -213,6 +383,18 @@ public:
     //-----------------------------------------------------------------------------------
     bool registerVirtualID(const std::string& strName, tVirtualID virtualID = 0);
 
+    //-----------------------------------------------------------------------------------
+    /// @brief  Register several virtual IDs at once
+    ///
+    /// Each registration follows the rules of registerVirtualID(), in order, but only
+    /// one summary is written in the log for the whole list (a lot faster for big
+    /// profiles).
+    ///
+    /// @param  registrations   The virtual IDs
+    /// @return                 The number of virtual IDs registered
+    //-----------------------------------------------------------------------------------
+    unsigned int registerVirtualIDs(const std::vector<tVirtualIDRegistration>& registrations);
+
     //-----------------------------------------------------------------------------------
     /// @brief  Returns a virtual ID
     ///
@@ -238,6 +420,17 @@ public:
     //-----------------------------------------------------------------------------------
     bool registerShortcut(const std::string& strShortcut, tVirtualID virtualID);
 
+    //-----------------------------------------------------------------------------------
+    /// @brief  Register several shortcuts at once
+    ///
+    /// Each registration follows the rules of registerShortcut(), in order, but only
+    /// one summary is written in the log for the whole list.
+    ///
+    /// @param  registrations   The shortcuts
+    /// @return                 The number of shortcuts registered
+    //-----------------------------------------------------------------------------------
+    unsigned int registerShortcuts(const std::vector<tShortcutRegistration>& registrations);
+
     //-----------------------------------------------------------------------------------
     /// @brief  Returns the virtual ID associated with a shortcut
     ///
@@ -272,15 +465,92 @@ public:
     // bool saveVirtualControllers(const std::string& strFile);
 
 
+    //_____ Internal methods __________
+private:
+    //-----------------------------------------------------------------------------------
+    /// @brief  Add the gamepads plugged and remove the ones unplugged since the last
+    ///         frame
+    //-----------------------------------------------------------------------------------
+    void processHotPlug();
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Returns the lowest index not used by a connected gamepad
+    ///
+    /// The index of an unplugged gamepad is given to the next one plugged, so the
+    /// indices stay between 1 and the number of gamepads
+    //-----------------------------------------------------------------------------------
+    unsigned int getFreeGamepadIndex() const;
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Forget the virtual parts of a virtual controller detached from the
+    ///         unplugged gamepads
+    ///
+    /// @param  pVirtualController  The virtual controller
+    //-----------------------------------------------------------------------------------
+    void forgetDetachedBindings(VirtualController* pVirtualController);
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Destroy a virtual controller and give its memory back to the arena
+    ///
+    /// @param  pVirtualController  The virtual controller
+    //-----------------------------------------------------------------------------------
+    void deleteVirtualController(VirtualController* pVirtualController);
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Transmit the events written by the capture daemon since the last frame
+    ///         to the remote controllers
+    //-----------------------------------------------------------------------------------
+    void processRemoteEvents();
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Refresh the statistics at the end of a frame
+    ///
+    /// @param  ulCaptureTime   Time spent reading the controllers, in microseconds
+    /// @param  ulProcessTime   Time spent updating the virtual controllers, in
+    ///                         microseconds
+    //-----------------------------------------------------------------------------------
+    void updateStats(unsigned long ulCaptureTime, unsigned long ulProcessTime);
+
+
+    //_____ Internal types __________
+private:
+    //-----------------------------------------------------------------------------------
+    /// @brief  Virtual parts of a virtual controller detached from an unplugged gamepad
+    //-----------------------------------------------------------------------------------
+    struct tDetachedBindings
+    {
+        VirtualController*          pVirtualController; ///< The virtual controller
+        std::vector<tVirtualPart>   parts;              ///< The detached virtual parts
+    };
+
+    typedef std::map<std::string, std::vector<tDetachedBindings> >  tDetachedBindingsList;
+
+
     //_____ Attributes __________
 private:
     OIS::InputManager*                          m_pManager;
+    void*                                       m_mainWindowHandle;     ///< Handle of the main window
     std::vector<Controller*>                    m_controllers;          ///< List of the connected controllers
+    Arena                                       m_controllersArena;     ///< Memory of the virtual controllers
     std::map<std::string, VirtualController*>   m_virtualControllers;   ///< List of the virtual controllers
     std::map<std::string, tVirtualID>           m_virtualIDs;           ///< List of the virtual IDs
     std::map<std::string, tVirtualID>           m_shortcuts;            ///< List of the shortcuts
     unsigned int                                m_uiNbGamepads;         ///< Number of gamepads
+    std::map<Controller*, unsigned int>         m_bindings;             ///< Number of virtual parts bound to each controller
     std::deque<tInputEvent>                     m_events;               ///< List of input events (used when reading the inputs)
+
+    GamepadsWatcher*                            m_pGamepadsWatcher;     ///< Detects the gamepads plugged or unplugged
+    std::vector<OIS::InputManager*>             m_hotPlugManagers;      ///< Input managers owning the gamepads plugged during the session
+    tDetachedBindingsList                       m_detachedBindings;     ///< Virtual parts detached from unplugged gamepads, by identity
+    std::vector<GamepadsWatcher::tDevice>       m_pluggedGamepads;      ///< Used when retrieving the plugged gamepads
+    std::vector<std::string>                    m_unpluggedGamepads;    ///< Used when retrieving the unplugged gamepads
+
+    SharedEventsRing*                           m_pRemoteEvents;        ///< Events of the capture daemon (if connected)
+    std::vector<RemoteController*>              m_remoteControllers;    ///< The remote controllers, by index in the ring
+    std::vector<SharedEventsRing::tEvent>       m_remoteEventsBuffer;   ///< Used when reading the events of the capture daemon
+
+    tStats                                      m_stats;                ///< The statistics
+    unsigned int                                m_uiLastStatsController;///< Index of the statistics of the controller of the last event
 };
 
 }
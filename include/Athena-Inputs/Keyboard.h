@@ -19,6 +19,11 @@ namespace Inputs {
 //---------------------------------------------------------------------------------------
 class ATHENA_INPUTS_SYMBOL Keyboard: public Controller, public OIS::KeyListener
 {
+    //_____ Constants __________
+public:
+    static const unsigned int TEXT_BUFFER_SIZE = 256;   ///< Maximum number of characters entered during a frame
+
+
     //_____ Construction / Destruction __________
 public:
     //-----------------------------------------------------------------------------------
@@ -40,11 +45,60 @@ public:
         return static_cast<OIS::Keyboard*>(m_pOISObject);
     }
 
-    inline void setCharacterMode(bool enabled)
+    //-----------------------------------------------------------------------------------
+    /// @brief  Enable or disable the character mode
+    ///
+    /// In character mode, no key event is fired: the characters entered are stored in
+    /// a preallocated buffer instead (see getText()). The keyboard stays active while
+    /// the character mode is enabled.
+    ///
+    /// @param  enabled     Indicates if the character mode must be enabled
+    //-----------------------------------------------------------------------------------
+    void setCharacterMode(bool enabled);
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Indicates if the character mode is enabled
+    //-----------------------------------------------------------------------------------
+    inline bool isCharacterModeEnabled() const
+    {
+        return m_bCharacterMode;
+    }
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Returns the characters entered during the last capture, as UTF-32 code
+    ///         points (see getTextLength())
+    ///
+    /// The buffer is only valid until the next capture.
+    //-----------------------------------------------------------------------------------
+    inline const unsigned int* getText() const
+    {
+        return m_text;
+    }
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Returns the number of characters entered during the last capture
+    //-----------------------------------------------------------------------------------
+    inline unsigned int getTextLength() const
     {
-        m_bCharacterMode = enabled;
+        return m_uiTextLength;
     }
 
+    //-----------------------------------------------------------------------------------
+    /// @brief  Returns the number of characters dropped because the buffer was full
+    ///         (since the character mode was enabled)
+    //-----------------------------------------------------------------------------------
+    inline unsigned long getNbDroppedCharacters() const
+    {
+        return m_ulNbDroppedCharacters;
+    }
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Capture the events of the keyboard
+    ///
+    /// The characters entered during the previous frame are discarded.
+    //-----------------------------------------------------------------------------------
+    virtual void capture();
+
 
     //_____ Implementation of OIS::KeyListener __________
 public:
@@ -52,9 +106,23 @@ public:
     virtual bool keyReleased(const OIS::KeyEvent &arg);
 
 
+    //_____ Internal methods __________
+private:
+    //-----------------------------------------------------------------------------------
+    /// @brief  Append a character to the buffer
+    ///
+    /// @param  uiText  The character (UTF-32 code point, or UTF-16 code unit)
+    //-----------------------------------------------------------------------------------
+    void appendCharacter(unsigned int uiText);
+
+
     //_____ Attributes __________
 protected:
-    bool m_bCharacterMode;
+    bool            m_bCharacterMode;
+    unsigned int    m_text[TEXT_BUFFER_SIZE];   ///< Characters entered during the last capture
+    unsigned int    m_uiTextLength;             ///< Number of characters in the buffer
+    unsigned int    m_uiHighSurrogate;          ///< First half of a UTF-16 surrogate pair (0 if none)
+    unsigned long   m_ulNbDroppedCharacters;    ///< Number of characters dropped because the buffer was full
 };
 
 }
@@ -9,6 +9,7 @@
 
 #include <Athena-Inputs/Controller.h>
 #include <OIS/OISMouse.h>
+#include <vector>
 
 
 namespace Athena {
@@ -19,6 +20,20 @@ namespace Inputs {
 //---------------------------------------------------------------------------------------
 class ATHENA_INPUTS_SYMBOL Mouse: public Controller, public OIS::MouseListener
 {
+    //_____ Internal types __________
+public:
+    //-----------------------------------------------------------------------------------
+    /// @brief  A movement of the mouse, as reported by the system
+    //-----------------------------------------------------------------------------------
+    struct tSample
+    {
+        unsigned long   ulTimestamp;    ///< Moment the movement was read by capture()
+        int             iX;             ///< Relative movement on the X axis
+        int             iY;             ///< Relative movement on the Y axis
+        int             iZ;             ///< Relative movement on the Z axis (wheel)
+    };
+
+
     //_____ Construction / Destruction __________
 public:
     //-----------------------------------------------------------------------------------
@@ -40,12 +55,73 @@ public:
         return static_cast<OIS::Mouse*>(m_pOISObject);
     }
 
+    //-----------------------------------------------------------------------------------
+    /// @brief  Capture the events of the mouse
+    ///
+    /// The movements of the previous frame are forgotten (but stay in the history).
+    //-----------------------------------------------------------------------------------
+    virtual void capture();
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Retrieve the sum of the movements of the mouse during the last capture
+    ///
+    /// @retval iX  Movement on the X axis
+    /// @retval iY  Movement on the Y axis
+    /// @retval iZ  Movement on the Z axis (wheel)
+    //-----------------------------------------------------------------------------------
+    void getFrameDelta(int &iX, int &iY, int &iZ) const;
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Enable or disable the history of the movements of the mouse
+    ///
+    /// Each movement reported by the system is kept (with its timestamp) in a ring
+    /// allocated once, the oldest ones being overwritten.
+    ///
+    /// @remark OIS doesn't report the moment of the movements: the ones read by the
+    ///         same capture share its timestamp (see Controller::getTimestamp()), only
+    ///         their order is kept.
+    ///
+    /// @param  uiCapacity  Maximum number of movements kept (0 to disable the
+    ///                     history)
+    //-----------------------------------------------------------------------------------
+    void enableSamplesHistory(unsigned int uiCapacity);
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Returns the number of movements in the history
+    //-----------------------------------------------------------------------------------
+    inline unsigned int getNbSamples() const { return m_uiNbSamples; }
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Returns the number of movements received during the last capture (the
+    ///         most recent ones of the history)
+    //-----------------------------------------------------------------------------------
+    inline unsigned int getNbFrameSamples() const { return m_uiNbFrameSamples; }
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Returns a movement of the history
+    ///
+    /// @param  uiIndex     Index of the movement (0: the oldest one)
+    /// @return             The movement
+    //-----------------------------------------------------------------------------------
+    const tSample& getSample(unsigned int uiIndex) const;
+
 
     //_____ Implementation of OIS::MouseListener __________
 public:
     virtual bool mouseMoved(const OIS::MouseEvent &arg);
     virtual bool mousePressed(const OIS::MouseEvent &arg, OIS::MouseButtonID id);
     virtual bool mouseReleased(const OIS::MouseEvent &arg, OIS::MouseButtonID id);
+
+
+    //_____ Attributes __________
+protected:
+    int                     m_iFrameDeltaX;         ///< Sum of the movements on the X axis during the last capture
+    int                     m_iFrameDeltaY;         ///< Sum of the movements on the Y axis during the last capture
+    int                     m_iFrameDeltaZ;         ///< Sum of the movements on the Z axis during the last capture
+    std::vector<tSample>    m_samples;              ///< Ring of the last movements (empty if the history is disabled)
+    unsigned int            m_uiFirstSample;        ///< Index of the oldest movement in the ring
+    unsigned int            m_uiNbSamples;          ///< Number of movements in the ring
+    unsigned int            m_uiNbFrameSamples;     ///< Number of movements received during the last capture
 };
 
 }
@@ -34,12 +34,22 @@ namespace Athena
     //------------------------------------------------------------------------------------
     namespace Inputs
     {
+        class Arena;
+        class CaptureDaemon;
+        class ComboRecognizer;
         class Controller;
         class Gamepad;
+        class InputHistory;
         class InputsUnit;
         class Keyboard;
         class Mouse;
+        class RemoteController;
+        class SharedEventsRing;
+        class StateEncoder;
+        class TimerWheel;
+        class Tracer;
         class VirtualController;
+        class VirtualEventsFilter;
 
         class IEventsListener;
         class IVirtualEventsListener;
@@ -0,0 +1,60 @@
+/** @file   RemoteController.h
+    @author Philip Abbet
+
+    Declaration of the class 'Athena::Inputs::RemoteController'
+*/
+
+#ifndef _ATHENA_INPUTS_REMOTECONTROLLER_H
+#define _ATHENA_INPUTS_REMOTECONTROLLER_H
+
+#include <Athena-Inputs/Controller.h>
+#include <Athena-Inputs/SharedEventsRing.h>
+
+
+namespace Athena {
+namespace Inputs {
+
+//---------------------------------------------------------------------------------------
+/// @brief  Represents a controller owned by another process (see CaptureDaemon)
+///
+/// Its events are read from a shared events ring by the Inputs Unit (see
+/// InputsUnit::connect()), so capture() doesn't do anything.
+//---------------------------------------------------------------------------------------
+class ATHENA_INPUTS_SYMBOL RemoteController: public Controller
+{
+    //_____ Construction / Destruction __________
+public:
+    //-----------------------------------------------------------------------------------
+    /// @brief  Constructor
+    /// @param  device      Description of the controller in the shared events ring
+    //-----------------------------------------------------------------------------------
+    RemoteController(const SharedEventsRing::tDevice& device);
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Destructor
+    //-----------------------------------------------------------------------------------
+    virtual ~RemoteController();
+
+
+    //_____ Methods __________
+public:
+    //-----------------------------------------------------------------------------------
+    /// @brief  Read the inputs of the controller
+    ///
+    /// Does nothing: the events are transmitted by the Inputs Unit
+    //-----------------------------------------------------------------------------------
+    virtual void capture() {}
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Report an event read from the shared events ring to the listeners
+    ///
+    /// @remark Called by the Inputs Unit
+    /// @param  event   The event
+    //-----------------------------------------------------------------------------------
+    void _fireEvent(const SharedEventsRing::tEvent& event);
+};
+
+}
+}
+
+#endif
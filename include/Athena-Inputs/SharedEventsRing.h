@@ -0,0 +1,196 @@
+/** @file   SharedEventsRing.h
+    @author Philip Abbet
+
+    Declaration of the class 'Athena::Inputs::SharedEventsRing'
+*/
+
+#ifndef _ATHENA_INPUTS_SHAREDEVENTSRING_H_
+#define _ATHENA_INPUTS_SHAREDEVENTSRING_H_
+
+#include <Athena-Inputs/Prerequisites.h>
+#include <Athena-Inputs/Declarations.h>
+#include <OIS/OISPrereqs.h>
+
+
+namespace Athena {
+namespace Inputs {
+
+//---------------------------------------------------------------------------------------
+/// @brief  A ring of input events in shared memory, written by one process (see
+///         CaptureDaemon) and read by others (see InputsUnit::connect())
+///
+/// The shared memory contains a header describing the controllers of the writer,
+/// followed by the events. The writer never waits for the readers: each reader keeps
+/// its own position in the ring, and the events overwritten before a reader could
+/// read them are counted as lost.
+///
+/// The controllers must be declared before the first event is written.
+//---------------------------------------------------------------------------------------
+class ATHENA_INPUTS_SYMBOL SharedEventsRing
+{
+    //_____ Constants __________
+public:
+    static const unsigned int MAX_DEVICES       = 16;   ///< Maximum number of controllers
+    static const unsigned int MAX_NAME_LENGTH   = 64;   ///< Maximum length of the names (including the terminal 0)
+
+
+    //_____ Internal types __________
+public:
+    //-----------------------------------------------------------------------------------
+    /// @brief  A controller of the writer
+    //-----------------------------------------------------------------------------------
+    struct tDevice
+    {
+        unsigned int    uiType;                         ///< Type of the controller (OIS::Type)
+        unsigned int    uiIndex;                        ///< Index of the controller
+        char            strName[MAX_NAME_LENGTH];       ///< Name of the controller
+        char            strIdentity[MAX_NAME_LENGTH];   ///< Identity of the controller
+    };
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  An event, as stored in the ring
+    ///
+    /// The timestamp is split in two 32-bit halves, so the layout is the same for the
+    /// 32-bit and 64-bit processes.
+    //-----------------------------------------------------------------------------------
+    struct tEvent
+    {
+        unsigned int    uiTimeStampLow;     ///< Low 32 bits of the timestamp of the event (see Controller::getTimestamp())
+        unsigned int    uiTimeStampHigh;    ///< High 32 bits of the timestamp of the event
+        int             iValue;             ///< Value (1/0 for a key, position for a POV)
+        unsigned char   device;             ///< Index of the controller in the ring
+        unsigned char   part;               ///< Part of the controller (tControllerPart)
+        unsigned char   partID;             ///< ID of the part
+        unsigned char   reserved;
+
+        //-------------------------------------------------------------------------------
+        /// @brief  Returns the timestamp of the event
+        //-------------------------------------------------------------------------------
+        inline unsigned long getTimeStamp() const
+        {
+            // Shifted in two steps: 'unsigned long' may only have 32 bits
+            return ((((unsigned long) uiTimeStampHigh) << 16) << 16) | uiTimeStampLow;
+        }
+    };
+
+
+    //_____ Construction / Destruction __________
+public:
+    //-----------------------------------------------------------------------------------
+    /// @brief  Constructor
+    //-----------------------------------------------------------------------------------
+    SharedEventsRing();
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Destructor
+    //-----------------------------------------------------------------------------------
+    ~SharedEventsRing();
+
+
+    //_____ Methods __________
+public:
+    //-----------------------------------------------------------------------------------
+    /// @brief  Create the shared memory (writer side)
+    ///
+    /// @param  strName     Name of the shared memory
+    /// @param  uiCapacity  Number of events in the ring (rounded up to a power of 2)
+    /// @return             'true' if successful
+    //-----------------------------------------------------------------------------------
+    bool create(const std::string& strName, unsigned int uiCapacity);
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Open an existing shared memory (reader side)
+    ///
+    /// The events written before are ignored.
+    ///
+    /// @param  strName     Name of the shared memory
+    /// @return             'true' if successful
+    //-----------------------------------------------------------------------------------
+    bool open(const std::string& strName);
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Close the shared memory (destroyed if it was created by this object)
+    //-----------------------------------------------------------------------------------
+    void close();
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Indicates if the shared memory is opened
+    //-----------------------------------------------------------------------------------
+    inline bool isOpen() const { return (m_pHeader != 0); }
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Returns the number of events in the ring
+    //-----------------------------------------------------------------------------------
+    unsigned int getCapacity() const;
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Declare a controller (writer side)
+    ///
+    /// @param  type        Type of the controller
+    /// @param  uiIndex     Index of the controller
+    /// @param  strName     Name of the controller
+    /// @param  strIdentity Identity of the controller
+    /// @return             Index of the controller in the ring, MAX_DEVICES if there is
+    ///                     no room left
+    //-----------------------------------------------------------------------------------
+    unsigned int addDevice(OIS::Type type, unsigned int uiIndex, const std::string& strName,
+                           const std::string& strIdentity);
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Returns the number of controllers declared by the writer
+    //-----------------------------------------------------------------------------------
+    unsigned int getNbDevices() const;
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Returns a controller declared by the writer
+    ///
+    /// @param  uiDevice    Index of the controller in the ring
+    //-----------------------------------------------------------------------------------
+    const tDevice& getDevice(unsigned int uiDevice) const;
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Write an event in the ring (writer side)
+    ///
+    /// Never waits: the oldest event of the ring is overwritten.
+    ///
+    /// @param  uiDevice    Index of the controller in the ring
+    /// @param  event       The event
+    //-----------------------------------------------------------------------------------
+    void write(unsigned int uiDevice, const tInputEvent& event);
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Read the events written since the last call (reader side)
+    ///
+    /// @retval pEvents     Array receiving the events
+    /// @param  uiMaxEvents Size of the array
+    /// @return             Number of events read (call again if it is uiMaxEvents)
+    //-----------------------------------------------------------------------------------
+    unsigned int read(tEvent* pEvents, unsigned int uiMaxEvents);
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Returns the number of events overwritten before they could be read
+    //-----------------------------------------------------------------------------------
+    inline unsigned long getNbLostEvents() const { return m_ulNbLostEvents; }
+
+
+    //_____ Internal types __________
+private:
+    struct tHeader;
+
+
+    //_____ Attributes __________
+private:
+    tHeader*        m_pHeader;          ///< The header of the shared memory (0 if not opened)
+    tEvent*         m_pEvents;          ///< The events of the shared memory
+    unsigned int    m_uiSize;           ///< Size of the shared memory, in bytes
+    unsigned int    m_uiReadIndex;      ///< Number of events read (reader side)
+    unsigned long   m_ulNbLostEvents;   ///< Number of events lost (reader side)
+    bool            m_bOwner;           ///< Indicates if the shared memory was created by this object
+    std::string     m_strName;          ///< Name of the shared memory
+    void*           m_handle;           ///< Platform-specific handle of the shared memory
+};
+
+}
+}
+
+#endif
@@ -0,0 +1,145 @@
+/** @file   StateEncoder.h
+    @author Philip Abbet
+
+    Declaration of the class 'Athena::Inputs::StateEncoder'
+*/
+
+#ifndef _ATHENA_INPUTS_STATEENCODER_H_
+#define _ATHENA_INPUTS_STATEENCODER_H_
+
+#include <Athena-Inputs/Prerequisites.h>
+#include <Athena-Inputs/Declarations.h>
+#include <vector>
+
+
+namespace Athena {
+namespace Inputs {
+
+//---------------------------------------------------------------------------------------
+/// @brief  Encodes the state of a virtual controller as a bit-packed delta from a
+///         reference state
+///
+/// The encoded state is made of:
+///    - a header of 3 bits, indicating if some keys, axes or POVs changed
+///    - the bitmask of the changed keys (if any)
+///    - for each axis, a bit indicating if it changed, followed by the difference with
+///      the reference (quantized, zigzag-encoded, and written by groups of 4 bits
+///      with a continuation bit)
+///    - for each POV, a bit indicating if it changed, followed by its position on 4 bits
+///
+/// An unchanged state fits in one byte.
+///
+/// The encoder and the decoder must be created from virtual controllers with the same
+/// virtual parts, and use the same quantization.
+//---------------------------------------------------------------------------------------
+class ATHENA_INPUTS_SYMBOL StateEncoder
+{
+    //_____ Internal types __________
+public:
+    //-----------------------------------------------------------------------------------
+    /// @brief  A (quantized) state of a virtual controller
+    ///
+    /// @remark Use initState() to allocate it once, the other methods don't allocate
+    ///         memory
+    //-----------------------------------------------------------------------------------
+    struct tState
+    {
+        std::vector<unsigned int>   keyBits;        ///< States of the keys (one bit per key)
+        std::vector<int>            axisValues;     ///< Quantized values of the axes
+        std::vector<tPOVPosition>   povPositions;   ///< Positions of the POVs
+    };
+
+
+    //_____ Construction / Destruction __________
+public:
+    //-----------------------------------------------------------------------------------
+    /// @brief  Constructor
+    ///
+    /// @param  pVirtualController  The virtual controller
+    /// @param  uiAxisQuantization  Number of low bits of the axis values dropped by the
+    ///                             encoding
+    //-----------------------------------------------------------------------------------
+    StateEncoder(VirtualController* pVirtualController, unsigned int uiAxisQuantization = 0);
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Destructor
+    //-----------------------------------------------------------------------------------
+    ~StateEncoder();
+
+
+    //_____ Methods __________
+public:
+    //-----------------------------------------------------------------------------------
+    /// @brief  Compute the layout of the states again, from the current virtual parts
+    ///         of the virtual controller
+    //-----------------------------------------------------------------------------------
+    void rebuild();
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Allocate a state (all the keys released, the axes at 0 and the POVs
+    ///         centered)
+    ///
+    /// @retval state   The state
+    //-----------------------------------------------------------------------------------
+    void initState(tState &state) const;
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Retrieve the current state of the virtual controller
+    ///
+    /// @retval state   The state
+    //-----------------------------------------------------------------------------------
+    void capture(tState &state) const;
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Set the state of the virtual controller
+    ///
+    /// The virtual parts whose value differs are marked as toggled/changed, and the
+    /// conditioned values of the axes are computed.
+    ///
+    /// @param  state   The state
+    //-----------------------------------------------------------------------------------
+    void apply(const tState& state) const;
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Returns the maximum size of an encoded state, in bytes
+    //-----------------------------------------------------------------------------------
+    unsigned int getMaxEncodedSize() const;
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Encode a state as a delta from a reference state
+    ///
+    /// @param  reference   The reference state
+    /// @param  state       The state to encode
+    /// @retval pBuffer     The buffer receiving the encoded state
+    /// @param  uiCapacity  Size of the buffer, in bytes
+    /// @return             Number of bytes written, 0 if the buffer is too small
+    //-----------------------------------------------------------------------------------
+    unsigned int encode(const tState& reference, const tState& state,
+                        unsigned char* pBuffer, unsigned int uiCapacity) const;
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Decode a state encoded as a delta from a reference state
+    ///
+    /// @param  reference   The reference state
+    /// @param  pBuffer     The encoded state
+    /// @param  uiSize      Size of the encoded state, in bytes
+    /// @retval state       The decoded state
+    /// @return             Number of bytes read, 0 if the encoded state is invalid
+    //-----------------------------------------------------------------------------------
+    unsigned int decode(const tState& reference, const unsigned char* pBuffer,
+                        unsigned int uiSize, tState &state) const;
+
+
+    //_____ Attributes __________
+private:
+    VirtualController*          m_pVirtualController;   ///< The virtual controller
+    unsigned int                m_uiAxisQuantization;   ///< Number of low bits dropped from the axis values
+    std::vector<tVirtualKey*>   m_keys;                 ///< The virtual keys, in the order of the states
+    std::vector<tVirtualAxis*>  m_axes;                 ///< The virtual axes, in the order of the states
+    std::vector<tVirtualPOV*>   m_povs;                 ///< The virtual POVs, in the order of the states
+};
+
+}
+}
+
+#endif
@@ -0,0 +1,179 @@
+/** @file   Threading.h
+    @author Philip Abbet
+
+    Declaration of the classes 'Athena::Inputs::Mutex', 'Athena::Inputs::ScopedLock'
+    and 'Athena::Inputs::Thread'
+*/
+
+#ifndef _ATHENA_INPUTS_THREADING_H_
+#define _ATHENA_INPUTS_THREADING_H_
+
+#include <Athena-Inputs/Prerequisites.h>
+
+#if ATHENA_PLATFORM != ATHENA_PLATFORM_WIN32
+#   include <pthread.h>
+#endif
+
+
+namespace Athena {
+namespace Inputs {
+
+//---------------------------------------------------------------------------------------
+/// @brief  A (non-recursive) mutex
+//---------------------------------------------------------------------------------------
+class ATHENA_INPUTS_SYMBOL Mutex
+{
+    //_____ Construction / Destruction __________
+public:
+    //-----------------------------------------------------------------------------------
+    /// @brief  Constructor
+    //-----------------------------------------------------------------------------------
+    Mutex();
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Destructor
+    //-----------------------------------------------------------------------------------
+    ~Mutex();
+
+
+    //_____ Methods __________
+public:
+    //-----------------------------------------------------------------------------------
+    /// @brief  Lock the mutex, waiting for it if necessary
+    //-----------------------------------------------------------------------------------
+    void lock();
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Try to lock the mutex, without waiting
+    /// @return 'true' if the mutex was locked
+    //-----------------------------------------------------------------------------------
+    bool tryLock();
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Unlock the mutex
+    //-----------------------------------------------------------------------------------
+    void unlock();
+
+
+    //_____ Attributes __________
+private:
+#if ATHENA_PLATFORM == ATHENA_PLATFORM_WIN32
+    void*           m_handle;       ///< The critical section
+#else
+    pthread_mutex_t m_mutex;        ///< The mutex
+#endif
+};
+
+
+//---------------------------------------------------------------------------------------
+/// @brief  Lock a mutex for the lifetime of the object
+//---------------------------------------------------------------------------------------
+class ScopedLock
+{
+public:
+    ScopedLock(Mutex &mutex)
+    : m_mutex(mutex)
+    {
+        m_mutex.lock();
+    }
+
+    ~ScopedLock()
+    {
+        m_mutex.unlock();
+    }
+
+private:
+    Mutex& m_mutex;
+};
+
+
+//---------------------------------------------------------------------------------------
+/// @brief  Base class for the threads
+///
+/// The subclasses must implement the run() method, executed by the thread.
+//---------------------------------------------------------------------------------------
+class ATHENA_INPUTS_SYMBOL Thread
+{
+    //_____ Construction / Destruction __________
+public:
+    //-----------------------------------------------------------------------------------
+    /// @brief  Constructor
+    //-----------------------------------------------------------------------------------
+    Thread();
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Destructor
+    ///
+    /// @remark The thread must have been joined before
+    //-----------------------------------------------------------------------------------
+    virtual ~Thread();
+
+
+    //_____ Methods __________
+public:
+    //-----------------------------------------------------------------------------------
+    /// @brief  Start the thread
+    /// @return 'true' if successful
+    //-----------------------------------------------------------------------------------
+    bool start();
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Wait for the end of the thread
+    //-----------------------------------------------------------------------------------
+    void join();
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Indicates if the thread is running
+    //-----------------------------------------------------------------------------------
+    inline bool isRunning() const { return m_bRunning; }
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Suspend the calling thread
+    ///
+    /// @param  uiMilliseconds  The duration of the suspension
+    //-----------------------------------------------------------------------------------
+    static void sleep(unsigned int uiMilliseconds);
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Returns an identifier of the calling thread
+    //-----------------------------------------------------------------------------------
+    static unsigned long getCurrentThreadID();
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Ensures that the memory operations before the barrier are visible to the
+    ///         other threads (and processes) before the ones after it
+    //-----------------------------------------------------------------------------------
+    static void memoryBarrier();
+
+
+    //_____ Methods to override __________
+protected:
+    //-----------------------------------------------------------------------------------
+    /// @brief  Executed by the thread
+    //-----------------------------------------------------------------------------------
+    virtual void run() = 0;
+
+
+    //_____ Internal methods __________
+private:
+#if ATHENA_PLATFORM == ATHENA_PLATFORM_WIN32
+    static unsigned long __stdcall entryPoint(void* pThread);
+#else
+    static void* entryPoint(void* pThread);
+#endif
+
+
+    //_____ Attributes __________
+private:
+#if ATHENA_PLATFORM == ATHENA_PLATFORM_WIN32
+    void*       m_handle;       ///< Handle of the thread
+#else
+    pthread_t   m_thread;       ///< The thread
+#endif
+    bool        m_bRunning;     ///< Indicates if the thread was started and not joined
+};
+
+}
+}
+
+#endif
@@ -0,0 +1,161 @@
+/** @file   TimerWheel.h
+    @author Philip Abbet
+
+    Declaration of the class 'Athena::Inputs::TimerWheel'
+*/
+
+#ifndef _ATHENA_INPUTS_TIMERWHEEL_H_
+#define _ATHENA_INPUTS_TIMERWHEEL_H_
+
+#include <Athena-Inputs/Prerequisites.h>
+#include <vector>
+
+
+namespace Athena {
+namespace Inputs {
+
+//---------------------------------------------------------------------------------------
+/// @brief  Schedules timers with a resolution of one millisecond (hierarchical timing
+///         wheel)
+///
+/// The timers are stored in 4 wheels: the first one has a slot for each of the next
+/// 256 milliseconds, the other ones have 64 slots each covering 64 times the span of
+/// a slot of the previous wheel. When the first wheel has done a full turn, the next
+/// slot of the second wheel is redistributed in it (and so on).
+///
+/// Scheduling and cancelling a timer are O(1), and a timer costs nothing until it
+/// expires (apart from being redistributed at most 3 times). The deadlines farther
+/// than about 18 hours are rescheduled when they are reached.
+///
+/// The nodes of the timers are kept in a pool: once the pool has grown to the
+/// maximum number of simultaneous timers, no memory is allocated anymore.
+//---------------------------------------------------------------------------------------
+class ATHENA_INPUTS_SYMBOL TimerWheel
+{
+    //_____ Internal types __________
+public:
+    typedef unsigned int tTimerID;      ///< Identifies a timer
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  A timer that expired
+    //-----------------------------------------------------------------------------------
+    struct tExpiredTimer
+    {
+        unsigned int    uiData;         ///< The data of the timer
+        unsigned long   ulDeadline;     ///< The deadline of the timer
+    };
+
+    static const tTimerID INVALID_TIMER = 0xFFFFFFFF;   ///< Identifies no timer
+
+
+    //_____ Construction / Destruction __________
+public:
+    //-----------------------------------------------------------------------------------
+    /// @brief  Constructor
+    //-----------------------------------------------------------------------------------
+    TimerWheel();
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Destructor
+    //-----------------------------------------------------------------------------------
+    ~TimerWheel();
+
+
+    //_____ Methods __________
+public:
+    //-----------------------------------------------------------------------------------
+    /// @brief  Schedule a timer
+    ///
+    /// A deadline already reached expires at the next call to advance(). When no timer
+    /// is scheduled, the wheels restart from the deadline, so the first call to
+    /// advance() doesn't process the milliseconds elapsed before it.
+    ///
+    /// @remark advance() should be called regularly: the wheels process each
+    ///         millisecond elapsed since the last call (unless there isn't any timer)
+    ///
+    /// @param  ulDeadline  The deadline, in milliseconds
+    /// @param  uiData      Data reported when the timer expires
+    /// @return             The timer
+    //-----------------------------------------------------------------------------------
+    tTimerID schedule(unsigned long ulDeadline, unsigned int uiData);
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Cancel a timer
+    ///
+    /// @param  timer   The timer
+    /// @return         'false' if the timer has already expired or was cancelled
+    //-----------------------------------------------------------------------------------
+    bool cancel(tTimerID timer);
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Cancel all the timers
+    //-----------------------------------------------------------------------------------
+    void clear();
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Advance the time, and retrieve the timers that expired
+    ///
+    /// @param  ulNow       The current time, in milliseconds
+    /// @retval expired     The expired timers are appended to this list, in the order
+    ///                     of their deadlines (the ones already reached when scheduled
+    ///                     come with the first millisecond processed)
+    //-----------------------------------------------------------------------------------
+    void advance(unsigned long ulNow, std::vector<tExpiredTimer> &expired);
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Returns the number of scheduled timers
+    //-----------------------------------------------------------------------------------
+    inline unsigned int getNbTimers() const { return m_uiNbTimers; }
+
+
+    //_____ Internal methods __________
+private:
+    //-----------------------------------------------------------------------------------
+    /// @brief  Put a node in the slot corresponding to its deadline
+    //-----------------------------------------------------------------------------------
+    void insert(unsigned int uiNode);
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Remove a node from its slot
+    //-----------------------------------------------------------------------------------
+    void unlink(unsigned int uiNode);
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Put the nodes of a slot in the slots corresponding to their deadlines
+    //-----------------------------------------------------------------------------------
+    void cascade(unsigned int uiSlot);
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Return a node to the pool
+    //-----------------------------------------------------------------------------------
+    void release(unsigned int uiNode);
+
+
+    //_____ Internal types __________
+private:
+    struct tNode
+    {
+        unsigned long   ulDeadline;     ///< The deadline
+        unsigned int    uiData;         ///< The data of the timer
+        unsigned int    uiSlot;         ///< The slot containing the node (NO_SLOT if free)
+        unsigned int    uiPrevious;     ///< Previous node of the slot
+        unsigned int    uiNext;         ///< Next node of the slot
+        unsigned int    uiGeneration;   ///< Incremented each time the node is released
+    };
+
+    static const unsigned int NB_SLOTS = 256 + 3 * 64;
+
+
+    //_____ Attributes __________
+private:
+    std::vector<tNode>          m_nodes;            ///< The pool of nodes
+    std::vector<unsigned int>   m_freeNodes;        ///< The unused nodes of the pool
+    unsigned int                m_slots[NB_SLOTS];  ///< First node of each slot
+    unsigned long               m_ulCurrent;        ///< Next millisecond to process
+    unsigned int                m_uiNbTimers;       ///< Number of scheduled timers
+};
+
+}
+}
+
+#endif
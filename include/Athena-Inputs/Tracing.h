@@ -0,0 +1,148 @@
+/** @file   Tracing.h
+    @author Philip Abbet
+
+    Declaration of the classes 'Athena::Inputs::Tracer' and 'Athena::Inputs::TraceScope'
+*/
+
+#ifndef _ATHENA_INPUTS_TRACING_H_
+#define _ATHENA_INPUTS_TRACING_H_
+
+#include <Athena-Inputs/Prerequisites.h>
+
+#if ATHENA_INPUTS_TRACING
+
+#include <Athena-Inputs/Controller.h>
+#include <Athena-Inputs/Threading.h>
+#include <fstream>
+
+
+namespace Athena {
+namespace Inputs {
+
+//---------------------------------------------------------------------------------------
+/// @brief  Writes the durations measured by the trace scopes (see TraceScope) in a file,
+///         in the trace-event format of Chrome (readable by chrome://tracing and
+///         Perfetto)
+///
+/// Each thread writes its measures in its own buffer, without locking anything: a
+/// background thread periodically moves them to the file. The measures overwritten
+/// before the background thread could save them are counted as lost.
+///
+/// Only available if the library was compiled with the ATHENA_INPUTS_TRACING option.
+//---------------------------------------------------------------------------------------
+class ATHENA_INPUTS_SYMBOL Tracer: public Thread
+{
+    //_____ Construction / Destruction __________
+private:
+    //-----------------------------------------------------------------------------------
+    /// @brief  Constructor
+    ///
+    /// @param  strFile     The name of the file
+    /// @param  uiInterval  Delay between two savings, in milliseconds
+    //-----------------------------------------------------------------------------------
+    Tracer(const std::string& strFile, unsigned int uiInterval);
+
+public:
+    //-----------------------------------------------------------------------------------
+    /// @brief  Destructor
+    //-----------------------------------------------------------------------------------
+    virtual ~Tracer();
+
+
+    //_____ Methods __________
+public:
+    //-----------------------------------------------------------------------------------
+    /// @brief  Start to save the measures of the trace scopes in a file
+    ///
+    /// @param  strFile     The name of the file
+    /// @param  uiInterval  Delay between two savings, in milliseconds
+    /// @return             'true' if successful
+    //-----------------------------------------------------------------------------------
+    static bool start(const std::string& strFile, unsigned int uiInterval = 100);
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Save the remaining measures and close the file
+    //-----------------------------------------------------------------------------------
+    static void stop();
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Indicates if the measures of the trace scopes are saved
+    //-----------------------------------------------------------------------------------
+    static inline bool isStarted() { return (ms_pInstance != 0); }
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Record a measure in the buffer of the calling thread
+    ///
+    /// @remark Called by the trace scopes
+    /// @param  strName     Name of the measured code (must stay valid until stop())
+    /// @param  ulStart     Beginning of the measure (see Controller::getPreciseTimestamp())
+    /// @param  ulEnd       End of the measure
+    //-----------------------------------------------------------------------------------
+    static void _record(const char* strName, unsigned long ulStart, unsigned long ulEnd);
+
+
+    //_____ Implementation of Thread __________
+protected:
+    virtual void run();
+
+
+    //_____ Internal methods __________
+private:
+    //-----------------------------------------------------------------------------------
+    /// @brief  Move the measures of all the threads to the file
+    //-----------------------------------------------------------------------------------
+    void flush();
+
+
+    //_____ Attributes __________
+private:
+    static Tracer* volatile ms_pInstance;   ///< The tracer started (0 if none)
+
+    std::ofstream   m_file;                 ///< The file
+    unsigned int    m_uiInterval;           ///< Delay between two savings
+    unsigned long   m_ulOrigin;             ///< Time at which the tracer was started
+    bool            m_bFirstEvent;          ///< Indicates if no measure was written yet
+    unsigned long   m_ulNbLostEvents;       ///< Number of measures overwritten before being saved
+    Mutex           m_mutex;                ///< Protects the following attributes
+    bool            m_bStop;                ///< Indicates if the thread must stop
+};
+
+
+//---------------------------------------------------------------------------------------
+/// @brief  Measure the duration of its lifetime, if the tracer is started
+//---------------------------------------------------------------------------------------
+class TraceScope
+{
+public:
+    TraceScope(const char* strName)
+    : m_strName(strName), m_bEnabled(Tracer::isStarted()), m_ulStart(0)
+    {
+        if (m_bEnabled)
+            m_ulStart = Controller::getPreciseTimestamp();
+    }
+
+    ~TraceScope()
+    {
+        if (m_bEnabled)
+            Tracer::_record(m_strName, m_ulStart, Controller::getPreciseTimestamp());
+    }
+
+private:
+    const char*     m_strName;
+    bool            m_bEnabled;
+    unsigned long   m_ulStart;
+};
+
+}
+}
+
+/// Measure the duration of the enclosing scope
+#define ATHENA_INPUTS_TRACE_SCOPE(name) Athena::Inputs::TraceScope __traceScope__(name)
+
+#else
+
+#define ATHENA_INPUTS_TRACE_SCOPE(name)
+
+#endif
+
+#endif
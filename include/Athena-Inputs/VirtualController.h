@@ -9,6 +9,10 @@
 
 #include <Athena-Inputs/Prerequisites.h>
 #include <Athena-Inputs/Declarations.h>
+#include <Athena-Inputs/ComboRecognizer.h>
+#include <Athena-Inputs/VirtualEventsFilter.h>
+#include <Athena-Inputs/TimerWheel.h>
+#include <Athena-Inputs/Arena.h>
 // #include <Athena-Inputs/Controller.h>
 #include <vector>
 #include <map>
@@ -67,9 +71,124 @@ public:
     //-----------------------------------------------------------------------------------
     void setEventsListener(IVirtualEventsListener* pEventsListener);
 
+    //-----------------------------------------------------------------------------------
+    /// @brief  Add an events listener, only notified of the virtual events it is
+    ///         interested in
+    ///
+    /// Any number of listeners can be added, besides the one set with
+    /// setEventsListener(). If the listener was already added, its filter is replaced.
+    ///
+    /// @param  pEventsListener The events listener
+    /// @param  filter          Describes the virtual events to notify
+    //-----------------------------------------------------------------------------------
+    void addEventsListener(IVirtualEventsListener* pEventsListener,
+                           const VirtualEventsFilter& filter);
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Remove an events listener added with addEventsListener()
+    ///
+    /// @param  pEventsListener The events listener
+    //-----------------------------------------------------------------------------------
+    void removeEventsListener(IVirtualEventsListener* pEventsListener);
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Enable/Disable the queue of the virtual events
+    ///
+    /// When enabled, the virtual events of the frame are appended to a contiguous
+    /// array, which can be read by any number of consumers once the Inputs Unit has
+    /// processed the frame (see getEvents()). The listener (if any) is still notified.
+    ///
+    /// @param  bEnable     'true' to enable the queue
+    /// @param  uiCapacity  Number of events to preallocate (the queue grows if needed,
+    ///                     and keeps its memory between the frames)
+    //-----------------------------------------------------------------------------------
+    void enableEventsQueue(bool bEnable, unsigned int uiCapacity = 256);
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Indicates if the queue of the virtual events is enabled
+    //-----------------------------------------------------------------------------------
+    inline bool isEventsQueueEnabled() const { return m_bEventsQueueEnabled; }
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Returns the virtual events of the last frame
+    ///
+    /// @remark Valid until the next call to process()
+    /// @return The events, in the order they occured (0 if there isn't any)
+    //-----------------------------------------------------------------------------------
+    inline const tVirtualEvent* getEvents() const
+    {
+        return (m_eventsQueue.empty() ? 0 : &m_eventsQueue[0]);
+    }
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Returns the number of virtual events of the last frame
+    //-----------------------------------------------------------------------------------
+    inline unsigned int getNbEvents() const { return (unsigned int) m_eventsQueue.size(); }
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Enable/Disable the log of the transitions of the frame
+    ///
+    /// When enabled, the timestamped transitions of the virtual parts during the last
+    /// frame are kept, along with the state of the virtual parts at the beginning of
+    /// the frame. This allows to retrieve the state of a virtual part at any moment of
+    /// the frame (see isKeyPressedAt(), getKeyPressedFraction(), getAxisValueAt() and
+    /// getPOVPositionAt()), for instance to simulate several substeps per frame.
+    ///
+    /// The transitions are only as precise as the timestamps of the events: the events
+    /// read by the same capture of a controller share the moment of that capture (see
+    /// Controller::getTimestamp()).
+    ///
+    /// @param  bEnable     'true' to enable the log
+    //-----------------------------------------------------------------------------------
+    void enableTransitionsLog(bool bEnable);
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Indicates if the log of the transitions of the frame is enabled
+    //-----------------------------------------------------------------------------------
+    inline bool isTransitionsLogEnabled() const { return m_bTransitionsLogEnabled; }
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Returns the timestamp of the beginning of the last frame (the end of the
+    ///         previous one)
+    ///
+    /// @remark The timestamps are the ones of Controller::getTimestamp()
+    //-----------------------------------------------------------------------------------
+    inline unsigned long getFrameStartTimestamp() const { return m_ulFrameStartTimestamp; }
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Returns the timestamp of the end of the last frame (when process() was
+    ///         called)
+    //-----------------------------------------------------------------------------------
+    inline unsigned long getFrameEndTimestamp() const { return m_ulFrameEndTimestamp; }
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Set the recognizer of the combos to use
+    ///
+    /// The recognizer isn't owned by the virtual controller, and can be shared by
+    /// several ones.
+    ///
+    /// When a combo is recognized, an event is fired for its virtual ID (as a virtual
+    /// key pressed). If the combo is registered as a virtual key (see
+    /// registerVirtualKey()), that key is pressed until the next frame.
+    ///
+    /// @param  pComboRecognizer    The recognizer, 0 to disable the combos
+    //-----------------------------------------------------------------------------------
+    void setComboRecognizer(ComboRecognizer* pComboRecognizer);
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Returns the recognizer of the combos used
+    //-----------------------------------------------------------------------------------
+    inline ComboRecognizer* getComboRecognizer() const { return m_pComboRecognizer; }
+
     //-----------------------------------------------------------------------------------
     /// @brief  Enable/Disable the virtual controller
     ///
+    /// When the virtual controller is disabled, the state of its virtual parts is only
+    /// reset when they are accessed for the first time. The timers of the held keys
+    /// (repeats, hold thresholds) and the chords are cancelled right away. The real
+    /// controllers stay activated as long as some virtual parts are bound to them (see
+    /// InputsUnit::_retainController()).
+    ///
     /// @param  bEnable 'true' to enable the controller
     //-----------------------------------------------------------------------------------
     void enable(bool bEnable);
@@ -126,6 +245,16 @@ public:
     void addVirtualKey(tVirtualID virtualID, Controller* pController, tKey key,
                        const std::string& strShortcut = "");
 
+    //-----------------------------------------------------------------------------------
+    /// @brief  Add several virtual keys at once
+    ///
+    /// Same as calling addVirtualKey() for each binding, but their shortcuts are
+    /// registered together (see InputsUnit::registerShortcuts()).
+    ///
+    /// @param  bindings    The virtual keys
+    //-----------------------------------------------------------------------------------
+    void addVirtualKeys(const std::vector<tVirtualKeyBinding>& bindings);
+
     //-----------------------------------------------------------------------------------
     /// @brief  Add a virtual axis
     ///
@@ -197,6 +326,9 @@ public:
     //-----------------------------------------------------------------------------------
     /// @brief  Add a virtual POV from two real axes
     ///
+    /// A direction is engaged when the value of its axis reaches 100 (see
+    /// setPOVThresholds()).
+    ///
     /// @param  virtualID           ID of the virtual POV
     /// @param  pController         Controller on which are the real axes
     /// @param  axisUpDown          The real UP/DOWN axis
@@ -213,6 +345,37 @@ public:
                        const std::string& strShortcutLeft = "",
                        const std::string& strShortcutRight = "");
 
+    //-----------------------------------------------------------------------------------
+    /// @brief  Set the thresholds of a virtual POV made from two real axes
+    ///
+    /// A direction is engaged when the value of its axis reaches the threshold, and
+    /// released when the value goes below (threshold - hysteresis), so an axis near the
+    /// threshold doesn't make the position flicker.
+    ///
+    /// @param  virtualPOV  The virtual POV
+    /// @param  iThreshold  The threshold (> 0)
+    /// @param  iHysteresis The hysteresis (in [0, iThreshold[)
+    //-----------------------------------------------------------------------------------
+    void setPOVThresholds(tVirtualID virtualPOV, int iThreshold, int iHysteresis = 0);
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Add a virtual key pressed while a set of real keys is held (chord)
+    ///
+    /// The real keys can be on different controllers (for instance, Shift + a mouse
+    /// button).
+    ///
+    /// When several chords are satisfied, only the most specific ones are pressed: a
+    /// chord is released when a chord using a superset of its keys is satisfied (for
+    /// instance, Ctrl+Shift+S releases Ctrl+S). The virtual keys bound to a single
+    /// real key with addVirtualKey() aren't affected.
+    ///
+    /// @param  virtualID   ID of the virtual key
+    /// @param  keys        The real keys of the chord
+    /// @param  strShortcut Shortcut of the virtual key
+    //-----------------------------------------------------------------------------------
+    void addVirtualChord(tVirtualID virtualID, const std::vector<tChordKey>& keys,
+                         const std::string& strShortcut = "");
+
     //-----------------------------------------------------------------------------------
     /// @brief  Indicates if a virtual key is pressed
     ///
@@ -221,6 +384,31 @@ public:
     //-----------------------------------------------------------------------------------
     bool isKeyPressed(tVirtualID virtualKey);
 
+    //-----------------------------------------------------------------------------------
+    /// @brief  Indicates if a virtual key was pressed at a given moment of the last
+    ///         frame
+    ///
+    /// @remark Without log of the transitions, returns the current state
+    /// @remark The precision is the one of the captures (see enableTransitionsLog())
+    /// @param  virtualKey  The virtual key
+    /// @param  ulTimestamp The moment
+    /// @return             'true' if the virtual key was pressed
+    //-----------------------------------------------------------------------------------
+    bool isKeyPressedAt(tVirtualID virtualKey, unsigned long ulTimestamp);
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Returns the fraction of an interval of the last frame during which a
+    ///         virtual key was pressed
+    ///
+    /// @remark Without log of the transitions, returns 0 or 1 (current state)
+    /// @remark The precision is the one of the captures (see enableTransitionsLog())
+    /// @param  virtualKey  The virtual key
+    /// @param  ulStart     Beginning of the interval
+    /// @param  ulEnd       End of the interval
+    /// @return             The fraction, in [0, 1]
+    //-----------------------------------------------------------------------------------
+    float getKeyPressedFraction(tVirtualID virtualKey, unsigned long ulStart, unsigned long ulEnd);
+
     //-----------------------------------------------------------------------------------
     /// @brief  Indicates if a virtual key was just toggled
     ///
@@ -248,11 +436,23 @@ public:
     //-----------------------------------------------------------------------------------
     /// @brief  Returns the value of a virtual axis
     ///
+    /// For a relative axis of a mouse, the sum of the movements of the last frame
     /// @param  virtualAxis The virtual axis
     /// @return             The value
     //-----------------------------------------------------------------------------------
     int getAxisValue(tVirtualID virtualAxis);
 
+    //-----------------------------------------------------------------------------------
+    /// @brief  Returns the value of a virtual axis at a given moment of the last frame
+    ///
+    /// @remark Without log of the transitions, returns the current value
+    /// @remark The precision is the one of the captures (see enableTransitionsLog())
+    /// @param  virtualAxis The virtual axis
+    /// @param  ulTimestamp The moment
+    /// @return             The value
+    //-----------------------------------------------------------------------------------
+    int getAxisValueAt(tVirtualID virtualAxis, unsigned long ulTimestamp);
+
     //-----------------------------------------------------------------------------------
     /// @brief  Indicates if the value of a virtual axis has changed since the last frame
     ///
@@ -261,6 +461,49 @@ public:
     //-----------------------------------------------------------------------------------
     bool wasAxisChanged(tVirtualID virtualAxis);
 
+    //-----------------------------------------------------------------------------------
+    /// @brief  Returns the conditioned value of a virtual axis
+    ///
+    /// @param  virtualAxis The virtual axis
+    /// @return             The conditioned value, in [-1, 1]
+    //-----------------------------------------------------------------------------------
+    float getAxisConditionedValue(tVirtualID virtualAxis);
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Set the conditioning of a virtual axis
+    ///
+    /// The conditioned values of all the axes changed during a frame are computed
+    /// together, at the end of process().
+    ///
+    /// @remark For a radial dead zone, the conditioning of the paired axis should
+    ///         reference this axis too
+    /// @param  virtualAxis     The virtual axis
+    /// @param  conditioning    The conditioning
+    //-----------------------------------------------------------------------------------
+    void setAxisConditioning(tVirtualID virtualAxis, const tAxisConditioning& conditioning);
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Returns the conditioning of a virtual axis
+    ///
+    /// @param  virtualAxis The virtual axis
+    /// @return             The conditioning, 0 if not an axis
+    //-----------------------------------------------------------------------------------
+    const tAxisConditioning* getAxisConditioning(tVirtualID virtualAxis);
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Set how the changes of a virtual axis made from a real axis are reported
+    ///
+    /// An unreported move still updates the value of the axis, but doesn't fire any
+    /// event, nor mark the axis as changed. By default, the moves of the mice are always
+    /// reported, and the other ones from a threshold of 10.
+    ///
+    /// @param  virtualAxis The virtual axis
+    /// @param  policy      The policy
+    /// @param  iStep       Threshold (AXIS_CHANGE_THRESHOLD) or size of the buckets
+    ///                     (AXIS_CHANGE_QUANTIZED), > 0
+    //-----------------------------------------------------------------------------------
+    void setAxisChangePolicy(tVirtualID virtualAxis, tAxisChangePolicy policy, int iStep = 1);
+
     //-----------------------------------------------------------------------------------
     /// @brief  Returns the duration of the press of a virtual key
     ///
@@ -269,6 +512,71 @@ public:
     //-----------------------------------------------------------------------------------
     unsigned int getKeyPressedDuration(tVirtualID virtualKey);
 
+    //-----------------------------------------------------------------------------------
+    /// @brief  Returns for how long a virtual key is held, at the end of the last frame
+    ///
+    /// @param  virtualKey  The virtual key
+    /// @return             The duration, in milliseconds (0 if the key isn't pressed)
+    //-----------------------------------------------------------------------------------
+    unsigned int getKeyHeldDuration(tVirtualID virtualKey);
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Add a threshold on the duration of the press of a virtual key
+    ///
+    /// When the virtual key has been held for the duration, an event is fired for the
+    /// virtual ID of the threshold (as a virtual key pressed), with the exact timestamp
+    /// of the moment the duration was reached. If that virtual ID is registered as a
+    /// virtual key (see registerVirtualKey()), it is pressed until the next frame.
+    ///
+    /// Several thresholds can be added on a virtual key (for instance, the levels of a
+    /// charged attack). The armed thresholds are kept in a timer wheel, so they don't
+    /// cost anything until they are reached.
+    ///
+    /// @param  virtualKey  The virtual key
+    /// @param  uiDuration  The duration, in milliseconds
+    /// @param  thresholdID Virtual ID of the threshold
+    //-----------------------------------------------------------------------------------
+    void addHoldThreshold(tVirtualID virtualKey, unsigned int uiDuration, tVirtualID thresholdID);
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Remove all the thresholds on the duration of the press of a virtual key
+    ///
+    /// @param  virtualKey  The virtual key
+    //-----------------------------------------------------------------------------------
+    void removeHoldThresholds(tVirtualID virtualKey);
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Set the auto-repeat of a virtual key (for instance, to navigate in a
+    ///         menu)
+    ///
+    /// Once the virtual key has been held for the delay, it is pressed again every
+    /// interval (without being released): wasKeyPressed() returns 'true' and an event is
+    /// fired for each repeat.
+    ///
+    /// The repeats are scheduled in a timer wheel, so they only cost something when
+    /// they fire. Replaces the turbo of the virtual key (if any).
+    ///
+    /// @param  virtualKey  The virtual key
+    /// @param  uiDelay     Delay before the first repeat, in milliseconds
+    /// @param  uiInterval  Interval between the repeats, in milliseconds (0 to disable
+    ///                     the auto-repeat)
+    //-----------------------------------------------------------------------------------
+    void setKeyRepeat(tVirtualID virtualKey, unsigned int uiDelay, unsigned int uiInterval);
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Set the turbo of a virtual key
+    ///
+    /// While the real key is held, the virtual key is alternatively released and
+    /// pressed every interval, with an event each time.
+    ///
+    /// Replaces the auto-repeat of the virtual key (if any).
+    ///
+    /// @param  virtualKey  The virtual key
+    /// @param  uiInterval  Interval between the changes, in milliseconds (0 to disable
+    ///                     the turbo)
+    //-----------------------------------------------------------------------------------
+    void setKeyTurbo(tVirtualID virtualKey, unsigned int uiInterval);
+
     //-----------------------------------------------------------------------------------
     /// @brief  Returns the position of a virtual POV
     ///
@@ -277,6 +585,17 @@ public:
     //-----------------------------------------------------------------------------------
     tPOVPosition getPOVPosition(tVirtualID virtualPOV);
 
+    //-----------------------------------------------------------------------------------
+    /// @brief  Returns the position of a virtual POV at a given moment of the last frame
+    ///
+    /// @remark Without log of the transitions, returns the current position
+    /// @remark The precision is the one of the captures (see enableTransitionsLog())
+    /// @param  virtualPOV  The virtual POV
+    /// @param  ulTimestamp The moment
+    /// @return             The position
+    //-----------------------------------------------------------------------------------
+    tPOVPosition getPOVPositionAt(tVirtualID virtualPOV, unsigned long ulTimestamp);
+
     //-----------------------------------------------------------------------------------
     /// @brief  Returns the previous position of a virtual POV
     ///
@@ -302,6 +621,22 @@ public:
     //-----------------------------------------------------------------------------------
     tPOVPosition getPOVPositionFromShortcut(tVirtualID virtualPOV, const std::string& strShortcut);
 
+    //-----------------------------------------------------------------------------------
+    /// @brief  Returns the real key to which a virtual key is bound
+    ///
+    /// @param  virtualKey  The virtual key
+    /// @return             The real key, 0 if the virtual key doesn't exist
+    //-----------------------------------------------------------------------------------
+    const tVirtualKeySource* getVirtualKeySource(tVirtualID virtualKey);
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Returns the shortcuts of a virtual POV
+    ///
+    /// @param  virtualPOV  The virtual POV
+    /// @return             The shortcuts, 0 if the virtual POV has none
+    //-----------------------------------------------------------------------------------
+    const tVirtualPOVShortcuts* getPOVShortcuts(tVirtualID virtualPOV);
+
     //-----------------------------------------------------------------------------------
     /// @brief  Returns the duration of the press of a virtual POV in its current position
     ///
@@ -310,6 +645,15 @@ public:
     //-----------------------------------------------------------------------------------
     unsigned int getPOVPressedDuration(tVirtualID virtualPOV);
 
+    //-----------------------------------------------------------------------------------
+    /// @brief  Returns for how long a virtual POV is held in its current position, at
+    ///         the end of the last frame
+    ///
+    /// @param  virtualPOV  The virtual POV
+    /// @return             The duration, in milliseconds (0 if the POV is centered)
+    //-----------------------------------------------------------------------------------
+    unsigned int getPOVHeldDuration(tVirtualID virtualPOV);
+
     //-----------------------------------------------------------------------------------
     /// @brief  Indicates if a virtual ID correspond to a virtual key
     ///
@@ -374,6 +718,9 @@ public:
     //-----------------------------------------------------------------------------------
     /// @brief  Return a virtual key
     ///
+    /// Its state is validated first (see validateVirtualKey()), so it can be written
+    /// directly.
+    ///
     /// @param  id      The virtual ID
     /// @return         The virtual key, 0 if not a key
     //-----------------------------------------------------------------------------------
@@ -382,6 +729,9 @@ public:
     //-----------------------------------------------------------------------------------
     /// @brief  Return a virtual axis
     ///
+    /// Its state is validated first (see validateVirtualAxis()), so it can be written
+    /// directly.
+    ///
     /// @param  id      The virtual ID
     /// @return         The virtual axis, 0 if not a axis
     //-----------------------------------------------------------------------------------
@@ -390,20 +740,577 @@ public:
     //-----------------------------------------------------------------------------------
     /// @brief  Return a virtual POV
     ///
+    /// Its state is validated first (see validateVirtualPOV()), so it can be written
+    /// directly.
+    ///
     /// @param  id      The virtual ID
     /// @return         The virtual POV, 0 if not a POV
     //-----------------------------------------------------------------------------------
     tVirtualPOV* getVirtualPOV(tVirtualID id);
 
+    //-----------------------------------------------------------------------------------
+    /// @brief  Returns the statistics of the memory used by the virtual parts
+    //-----------------------------------------------------------------------------------
+    inline const Arena::tStats& getArenaStats() const { return m_arena.getStats(); }
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Returns the number of virtual events notified since the creation of the
+    ///         virtual controller
+    //-----------------------------------------------------------------------------------
+    inline unsigned long getNbVirtualEvents() const { return m_ulNbVirtualEvents; }
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Returns the number of moves of the virtual axes not reported because of
+    ///         their change policy (see setAxisChangePolicy())
+    //-----------------------------------------------------------------------------------
+    inline unsigned long getNbCoalescedEvents() const { return m_ulNbCoalescedEvents; }
+
+
+    //_____ Management of the real controllers __________
+public:
+    //-----------------------------------------------------------------------------------
+    /// @brief  Detach the virtual parts bound to a real controller
+    ///
+    /// The detached parts are kept, but aren't bound to any real controller anymore,
+    /// and their state is reset.
+    ///
+    /// @remark Called by the Inputs Unit when a controller is removed
+    /// @param  pController The real controller
+    /// @retval parts       The detached parts are appended to this list
+    //-----------------------------------------------------------------------------------
+    void _detachController(Controller* pController, std::vector<tVirtualPart> &parts);
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Bind some detached virtual parts to a real controller
+    ///
+    /// @remark Called by the Inputs Unit when a controller is replugged
+    /// @param  pController The real controller
+    /// @param  parts       The detached parts (see _detachController()). The parts bound
+    ///                     to another controller since then are left untouched.
+    //-----------------------------------------------------------------------------------
+    void _attachController(Controller* pController, const std::vector<tVirtualPart> &parts);
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Indicates that the state of the virtual parts was modified directly
+    ///
+    /// Only the virtual parts modified during a frame are reset at the beginning of the
+    /// next one: after this call, they are all reset once.
+    ///
+    /// @remark Called by StateEncoder and InputHistory when they set the state
+    //-----------------------------------------------------------------------------------
+    void _markAllPartsDirty() { m_bAllPartsDirty = true; }
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Reset the state of all the virtual parts not accessed since the virtual
+    ///         controller was disabled
+    ///
+    /// Only needed before accessing the virtual parts through pointers kept from a
+    /// previous call to getVirtualKey(), getVirtualAxis() or getVirtualPOV().
+    ///
+    /// @remark Called by StateEncoder and InputHistory before they use the state
+    //-----------------------------------------------------------------------------------
+    void _validateVirtualParts();
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Set the state of a virtual key directly
+    ///
+    /// The virtual key is marked as toggled if its state changes.
+    ///
+    /// @remark Called by StateEncoder and InputHistory when they set the state (see
+    ///         _markAllPartsDirty())
+    /// @param  pVirtualKey The virtual key
+    /// @param  bPressed    Indicates if the virtual key is pressed
+    //-----------------------------------------------------------------------------------
+    void _setKeyState(tVirtualKey* pVirtualKey, bool bPressed);
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Set the value of a virtual axis directly
+    ///
+    /// The virtual axis is marked as changed if its value changes, and the value is
+    /// considered as reported. Its conditioned value is computed by _conditionAxes().
+    ///
+    /// @remark Called by StateEncoder and InputHistory when they set the state (see
+    ///         _markAllPartsDirty())
+    /// @param  pVirtualAxis    The virtual axis
+    /// @param  iValue          The value
+    //-----------------------------------------------------------------------------------
+    void _setAxisValue(tVirtualAxis* pVirtualAxis, int iValue);
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Set the position of a virtual POV directly
+    ///
+    /// The virtual POV is marked as changed if its position changes. The state of the
+    /// real keys or axes it is made from is set to match the position, so the next
+    /// events continue from it.
+    ///
+    /// @remark Called by StateEncoder and InputHistory when they set the state (see
+    ///         _markAllPartsDirty())
+    /// @param  pVirtualPOV The virtual POV
+    /// @param  position    The position
+    //-----------------------------------------------------------------------------------
+    void _setPOVPosition(tVirtualPOV* pVirtualPOV, tPOVPosition position);
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Compute the conditioned values of the virtual axes set by
+    ///         _setAxisValue()
+    ///
+    /// @remark Called by StateEncoder and InputHistory once they have set the state
+    //-----------------------------------------------------------------------------------
+    inline void _conditionAxes()
+    {
+        if (!m_modifiedAxes.empty())
+            conditionAxes();
+    }
+
+
+    //_____ Internal methods __________
+private:
+    //-----------------------------------------------------------------------------------
+    /// @brief  Notify the listener of a virtual event, and advance the recognition of
+    ///         the combos
+    ///
+    /// @param  event   The virtual event
+    //-----------------------------------------------------------------------------------
+    void fireEvent(tVirtualEvent &event);
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Append a virtual event to the queue (if enabled) and notify the listeners
+    ///         interested in it
+    ///
+    /// @param  event   The virtual event
+    //-----------------------------------------------------------------------------------
+    void notifyEvent(tVirtualEvent &event);
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Update the held keys of the chords with an event on a real key
+    ///
+    /// Only the chords using the real key, and the chords using a subset of their keys,
+    /// are checked.
+    ///
+    /// @param  pEvent  The event
+    //-----------------------------------------------------------------------------------
+    void processChordKey(tInputEvent* pEvent);
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Press or release the virtual key of a chord, according to the held keys
+    ///
+    /// @param  uiChord     Index of the chord
+    /// @param  ulTimestamp Timestamp of the event that triggered the update
+    //-----------------------------------------------------------------------------------
+    void updateChord(unsigned int uiChord, unsigned long ulTimestamp);
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Allocate the bits of the real keys used by the chords, and rebuild the
+    ///         lists of chords by key and the subsets and supersets of each chord
+    //-----------------------------------------------------------------------------------
+    void rebuildChords();
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Remove the chord bound to a virtual key, if any
+    ///
+    /// @remark rebuildChords() must be called afterwards
+    /// @param  virtualID   ID of the virtual key
+    /// @return             'true' if a chord was removed
+    //-----------------------------------------------------------------------------------
+    bool removeChord(tVirtualID virtualID);
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Press a virtual key until the next frame (used by the combos and the
+    ///         hold thresholds), and notify the listeners
+    ///
+    /// @param  virtualID   The virtual ID
+    /// @param  ulTimestamp Timestamp of the press
+    //-----------------------------------------------------------------------------------
+    void pulseKey(tVirtualID virtualID, unsigned long ulTimestamp);
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Arm or disarm the hold thresholds of a virtual key
+    ///
+    /// @param  event   The event of the virtual key
+    //-----------------------------------------------------------------------------------
+    void updateHoldThresholds(const tVirtualEvent& event);
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Fire the hold thresholds reached up to a moment
+    ///
+    /// @param  ulTimestamp The moment
+    //-----------------------------------------------------------------------------------
+    void processHoldThresholds(unsigned long ulTimestamp);
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Rebuild the list of hold thresholds by key, and arm the ones of the held
+    ///         keys
+    //-----------------------------------------------------------------------------------
+    void rebuildHoldThresholds();
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Set the auto-repeat or the turbo of a virtual key
+    ///
+    /// @param  virtualKey  The virtual key
+    /// @param  uiDelay     Delay before the first repeat, in milliseconds
+    /// @param  uiInterval  Interval between the repeats, in milliseconds (0 to disable)
+    /// @param  bTurbo      Indicates if the key is released between the repeats
+    //-----------------------------------------------------------------------------------
+    void configureKeyRepeat(tVirtualID virtualKey, unsigned int uiDelay,
+                            unsigned int uiInterval, bool bTurbo);
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Start or stop the repeats of a virtual key
+    ///
+    /// @param  event   The event of the virtual key
+    //-----------------------------------------------------------------------------------
+    void updateKeyRepeat(const tVirtualEvent& event);
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Stop the repeats of a virtual key released without event
+    ///
+    /// @param  virtualKey  The virtual key
+    //-----------------------------------------------------------------------------------
+    void stopKeyRepeat(tVirtualID virtualKey);
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Fire the repeats scheduled up to a moment
+    ///
+    /// @param  ulTimestamp The moment
+    //-----------------------------------------------------------------------------------
+    void processKeyRepeats(unsigned long ulTimestamp);
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Fire the repeats that expired, and schedule the next ones
+    //-----------------------------------------------------------------------------------
+    void processExpiredRepeats();
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Register the shortcuts of a virtual POV
+    ///
+    /// @param  virtualPOV          The virtual POV
+    /// @param  strShortcutUp       Shortcut for the UP position (empty: no shortcuts)
+    /// @param  strShortcutDown     Shortcut for the DOWN position
+    /// @param  strShortcutLeft     Shortcut for the LEFT position
+    /// @param  strShortcutRight    Shortcut for the RIGHT position
+    //-----------------------------------------------------------------------------------
+    void setPOVShortcuts(tVirtualID virtualPOV, const std::string& strShortcutUp,
+                         const std::string& strShortcutDown, const std::string& strShortcutLeft,
+                         const std::string& strShortcutRight);
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Remember the virtual part of an event, to reset it at the beginning of
+    ///         the next frame
+    ///
+    /// @param  event   The event
+    //-----------------------------------------------------------------------------------
+    void markDirty(const tVirtualEvent& event);
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Reset the state of a virtual key if it dates from before the last
+    ///         disabling of the virtual controller
+    //-----------------------------------------------------------------------------------
+    inline void validateVirtualKey(tVirtualKey* pVirtualKey)
+    {
+        if (pVirtualKey->uiGeneration != m_uiGeneration)
+        {
+            pVirtualKey->bToggled       = false;
+            pVirtualKey->bPressed       = false;
+            pVirtualKey->uiGeneration   = m_uiGeneration;
+        }
+    }
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Reset the state of a virtual axis if it dates from before the last
+    ///         disabling of the virtual controller
+    //-----------------------------------------------------------------------------------
+    inline void validateVirtualAxis(tVirtualAxis* pVirtualAxis)
+    {
+        if (pVirtualAxis->uiGeneration != m_uiGeneration)
+        {
+            pVirtualAxis->bChanged          = false;
+            pVirtualAxis->iValue            = 0;
+            pVirtualAxis->fValue            = 0.0f;
+            pVirtualAxis->iReportedValue    = 0;
+            pVirtualAxis->uiGeneration      = m_uiGeneration;
+        }
+    }
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Reset the state of a virtual POV if it dates from before the last
+    ///         disabling of the virtual controller
+    //-----------------------------------------------------------------------------------
+    inline void validateVirtualPOV(tVirtualPOV* pVirtualPOV)
+    {
+        if (pVirtualPOV->uiGeneration != m_uiGeneration)
+        {
+            pVirtualPOV->position           = POV_CENTER;
+            pVirtualPOV->previousPosition   = POV_CENTER;
+            pVirtualPOV->uiGeneration       = m_uiGeneration;
+
+            // The releases of the keys weren't processed while disabled
+            if (pVirtualPOV->part == PART_KEY)
+                pVirtualPOV->realPart.keys.uiHeld = 0;
+        }
+    }
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Reset the per-frame state of a virtual key
+    //-----------------------------------------------------------------------------------
+    void resetVirtualKey(tVirtualKey* pVirtualKey);
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Reset the per-frame state of a virtual axis
+    //-----------------------------------------------------------------------------------
+    void resetVirtualAxis(tVirtualAxis* pVirtualAxis);
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Reset the per-frame state of a virtual POV
+    //-----------------------------------------------------------------------------------
+    void resetVirtualPOV(tVirtualPOV* pVirtualPOV);
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Release the virtual keys of the combos recognized during the previous
+    ///         frame
+    //-----------------------------------------------------------------------------------
+    void releasePulsedKeys();
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Update the references on the real controllers when a virtual part is
+    ///         (re)bound
+    ///
+    /// @param  pPreviousPart   The virtual part previously bound to the virtual ID (if
+    ///                         any)
+    /// @param  pController     The real controller now bound to the virtual ID (if any)
+    //-----------------------------------------------------------------------------------
+    template<typename T>
+    void replaceReference(const T* pPreviousPart, Controller* pController);
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Add a virtual axis to the list of the ones to condition at the end of the
+    ///         frame (once per frame)
+    ///
+    /// @param  pVirtualAxis    The virtual axis
+    //-----------------------------------------------------------------------------------
+    inline void queueAxis(tVirtualAxis* pVirtualAxis)
+    {
+        if (!pVirtualAxis->bQueued)
+        {
+            pVirtualAxis->bQueued = true;
+            m_modifiedAxes.push_back(pVirtualAxis);
+        }
+    }
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Add a virtual POV made from axes to the list of the ones whose position
+    ///         is computed at the end of the frame (once per frame)
+    ///
+    /// @param  virtualID       ID of the virtual POV
+    /// @param  pVirtualPOV     The virtual POV
+    //-----------------------------------------------------------------------------------
+    inline void queuePOV(tVirtualID virtualID, tVirtualPOV* pVirtualPOV)
+    {
+        if (!pVirtualPOV->bQueued)
+        {
+            pVirtualPOV->bQueued = true;
+            m_povsBatch.virtualIDs.push_back(virtualID);
+            m_povsBatch.povs.push_back(pVirtualPOV);
+        }
+    }
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Compute the conditioned values of all the virtual axes modified during
+    ///         the current frame
+    //-----------------------------------------------------------------------------------
+    void conditionAxes();
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Compute the conditioned values of some virtual axes
+    ///
+    /// @param  pAxes       The virtual axes
+    /// @param  uiCount     Number of virtual axes
+    //-----------------------------------------------------------------------------------
+    void conditionAxes(tVirtualAxis* const* pAxes, unsigned int uiCount);
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Compute the positions of all the virtual POVs made from axes whose axes
+    ///         moved during the current frame
+    //-----------------------------------------------------------------------------------
+    void composePOVs();
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Update the state of the virtual parts at the beginning of the frame, for
+    ///         the log of the transitions
+    ///
+    /// Only the virtual parts with transitions during the previous frame are updated,
+    /// unless all of them must be.
+    ///
+    /// @param  bAllParts   'true' if the state of all the virtual parts may have
+    ///                     changed without transition (reset, restored, ...)
+    //-----------------------------------------------------------------------------------
+    void updateFrameStartStates(bool bAllParts);
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Returns the state of a virtual part at a given moment of the last frame,
+    ///         from the log of the transitions
+    ///
+    /// @param  part        The type of the virtual part
+    /// @param  virtualID   The virtual part
+    /// @param  ulTimestamp The moment
+    /// @return             The last transition before the moment, or the state at the
+    ///                     beginning of the frame (0 if the virtual part doesn't exist)
+    //-----------------------------------------------------------------------------------
+    const tVirtualEvent* getStateAt(tControllerPart part, tVirtualID virtualID,
+                                    unsigned long ulTimestamp) const;
+
+
+    //_____ Internal types __________
+private:
+    //-----------------------------------------------------------------------------------
+    /// @brief  Packed arrays used to compute the positions of the virtual POVs made from
+    ///         axes as a batch
+    //-----------------------------------------------------------------------------------
+    struct tPOVsBatch
+    {
+        std::vector<tVirtualID>     virtualIDs;         ///< IDs of the virtual POVs whose axes moved during the current frame
+        std::vector<tVirtualPOV*>   povs;               ///< The virtual POVs whose axes moved during the current frame
+        std::vector<int>            upDownValues;       ///< Values of the UP/DOWN axes
+        std::vector<int>            leftRightValues;    ///< Values of the LEFT/RIGHT axes
+        std::vector<int>            thresholds;         ///< Thresholds
+        std::vector<int>            hysteresis;         ///< Hysteresis
+        std::vector<unsigned int>   previousMasks;      ///< Directions engaged before the frame
+        std::vector<unsigned int>   masks;              ///< Directions engaged
+    };
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Packed arrays used to condition the virtual axes as a batch
+    //-----------------------------------------------------------------------------------
+    struct tAxesBatch
+    {
+        std::vector<float>          values;         ///< Normalized values of the axes
+        std::vector<float>          pairedValues;   ///< Normalized values of the paired axes (radial dead zones)
+        std::vector<float>          deadZones;      ///< Dead zones
+        std::vector<float>          invRanges;      ///< 1 / (saturation - dead zone)
+        std::vector<float>          curves;         ///< Response curves
+        std::vector<float>          scales;         ///< Scales (negative if inverted)
+        std::vector<float>          results;        ///< Conditioned values
+    };
+
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  A virtual key bound to a chord of real keys
+    //-----------------------------------------------------------------------------------
+    struct tChord
+    {
+        tVirtualID                  virtualID;      ///< The virtual key
+        unsigned int                uiMask;         ///< Bits of the real keys of the chord
+        std::vector<tChordKey>      keys;           ///< The real keys of the chord
+        std::vector<unsigned int>   subsets;        ///< Chords using a subset of the keys of this one
+        std::vector<unsigned int>   supersets;      ///< Chords using a superset of the keys of this one
+        bool                        bActive;        ///< Indicates if the virtual key is pressed by the chord
+    };
+
+    typedef std::map<Controller*, std::vector<unsigned char> >  tChordBitsList;
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  A threshold on the duration of the press of a virtual key
+    //-----------------------------------------------------------------------------------
+    struct tHoldThreshold
+    {
+        tVirtualID              virtualKey;     ///< The virtual key
+        unsigned int            uiDuration;     ///< The duration, in milliseconds
+        tVirtualID              thresholdID;    ///< Virtual ID of the threshold
+        TimerWheel::tTimerID    timer;          ///< Timer of the threshold (if armed)
+    };
+
+    typedef std::map<tVirtualID, tVirtualKey, std::less<tVirtualID>,
+                     ArenaAllocator<std::pair<const tVirtualID, tVirtualKey> > >             tVirtualKeysList;
+    typedef std::map<tVirtualID, tVirtualAxis, std::less<tVirtualID>,
+                     ArenaAllocator<std::pair<const tVirtualID, tVirtualAxis> > >            tVirtualAxesList;
+    typedef std::map<tVirtualID, tVirtualPOV, std::less<tVirtualID>,
+                     ArenaAllocator<std::pair<const tVirtualID, tVirtualPOV> > >             tVirtualPOVsList;
+    typedef std::map<tVirtualID, tVirtualKeySource, std::less<tVirtualID>,
+                     ArenaAllocator<std::pair<const tVirtualID, tVirtualKeySource> > >       tKeySourcesList;
+    typedef std::map<tVirtualID, tVirtualPOVShortcuts, std::less<tVirtualID>,
+                     ArenaAllocator<std::pair<const tVirtualID, tVirtualPOVShortcuts> > >    tPOVShortcutsList;
+
+    typedef std::map<tVirtualID, std::vector<unsigned int> >    tHoldThresholdsList;
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  The auto-repeat or the turbo of a virtual key
+    //-----------------------------------------------------------------------------------
+    struct tKeyRepeat
+    {
+        unsigned int            uiDelay;        ///< Delay before the first repeat, in milliseconds
+        unsigned int            uiInterval;     ///< Interval between the repeats, in milliseconds
+        bool                    bTurbo;         ///< Indicates if the key is released between the repeats
+        bool                    bHeld;          ///< Indicates if the key is held
+        TimerWheel::tTimerID    timer;          ///< Timer of the next repeat (if held)
+    };
+
+    typedef std::map<tVirtualID, tKeyRepeat>    tKeyRepeatsList;
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  An events listener added with addEventsListener()
+    //-----------------------------------------------------------------------------------
+    struct tSubscriber
+    {
+        IVirtualEventsListener* pListener;      ///< The events listener
+        VirtualEventsFilter     filter;         ///< The virtual events to notify
+    };
+
 
     //_____ Attributes __________
 private:
-    std::map<tVirtualID, tVirtualKey>   m_virtualKeys;              ///< List of the virtual keys
-    std::map<tVirtualID, tVirtualAxis>  m_virtualAxes;              ///< List of the virtual axes
-    std::map<tVirtualID, tVirtualPOV>   m_virtualPOVs;              ///< List of the virtual POVs
+    Arena                               m_arena;                    ///< Memory of the virtual parts (released with the virtual controller)
+    tVirtualKeysList                    m_virtualKeys;              ///< List of the virtual keys
+    tKeySourcesList                     m_keySources;               ///< Real keys of the virtual keys (same IDs as m_virtualKeys)
+    tVirtualAxesList                    m_virtualAxes;              ///< List of the virtual axes
+    tVirtualPOVsList                    m_virtualPOVs;              ///< List of the virtual POVs
+    tPOVShortcutsList                   m_povShortcuts;             ///< Shortcuts of the virtual POVs (not used by the frames)
 
     IVirtualEventsListener*             m_pEventsListener;          ///< Virtual events listener to use when an event occurs
+    std::vector<tSubscriber>            m_subscribers;              ///< Events listeners with filters
     bool                                m_bEnabled;                 ///< Indicates if the virtual controller is enabled or not
+    unsigned int                        m_uiGeneration;             ///< Incremented each time the virtual controller is disabled
+    bool                                m_bStaleParts;              ///< Indicates if some virtual parts may have a state older than the generation
+    bool                                m_bEventsQueueEnabled;      ///< Indicates if the virtual events are queued
+    std::vector<tVirtualEvent>          m_eventsQueue;              ///< Virtual events of the last frame
+
+    bool                                m_bTransitionsLogEnabled;   ///< Indicates if the transitions of the frame are kept
+    unsigned long                       m_ulFrameStartTimestamp;    ///< Beginning of the last frame
+    unsigned long                       m_ulFrameEndTimestamp;      ///< End of the last frame
+    std::vector<tVirtualEvent>          m_transitions;              ///< Transitions of the last frame
+    std::vector<tVirtualEvent>          m_frameStartKeys;           ///< State of the virtual keys at the beginning of the frame (by ID)
+    std::vector<tVirtualEvent>          m_frameStartAxes;           ///< State of the virtual axes at the beginning of the frame (by ID)
+    std::vector<tVirtualEvent>          m_frameStartPOVs;           ///< State of the virtual POVs at the beginning of the frame (by ID)
+
+    std::vector<tVirtualKey*>           m_dirtyKeys;                ///< Virtual keys to reset at the beginning of the next frame
+    std::vector<tVirtualAxis*>          m_dirtyAxes;                ///< Virtual axes to reset at the beginning of the next frame
+    std::vector<tVirtualPOV*>           m_dirtyPOVs;                ///< Virtual POVs to reset at the beginning of the next frame
+    bool                                m_bAllPartsDirty;           ///< Indicates if all the virtual parts must be reset
+
+    std::vector<tVirtualAxis*>          m_modifiedAxes;             ///< Virtual axes modified during the current frame
+    tAxesBatch                          m_axesBatch;                ///< Used to condition the modified axes
+    tPOVsBatch                          m_povsBatch;                ///< Used to compute the positions of the modified POVs made from axes
+
+    ComboRecognizer*                    m_pComboRecognizer;         ///< Recognizer of the combos (not owned)
+    ComboRecognizer::tState             m_comboState;               ///< State of the recognition of the combos
+    std::vector<tVirtualID>             m_pulsedKeys;               ///< Virtual keys of the combos recognized during the current frame
+
+    std::vector<tChord>                 m_chords;                   ///< The chords
+    tChordBitsList                      m_chordBits;                ///< Bit of each real key used by the chords (1-based, 0: none), by controller
+    unsigned int                        m_uiNbChordBits;            ///< Number of bits allocated to real keys
+    unsigned int                        m_uiHeldChordKeys;          ///< Bits of the real keys currently held
+    std::vector<unsigned int>           m_chordsByBit[MAX_CHORD_KEYS]; ///< Chords using each real key
+
+    std::vector<tHoldThreshold>         m_holdThresholds;           ///< The hold thresholds
+    tHoldThresholdsList                 m_holdThresholdsByKey;      ///< Indices of the hold thresholds of each virtual key
+    TimerWheel                          m_holdTimers;               ///< Timers of the armed hold thresholds
+    std::vector<TimerWheel::tExpiredTimer> m_expiredTimers;         ///< Used when retrieving the reached hold thresholds
+
+    tKeyRepeatsList                     m_keyRepeats;               ///< The auto-repeats and turbos, by virtual key
+    TimerWheel                          m_repeatTimers;             ///< Timers of the next repeats (data: the virtual key)
+    std::vector<TimerWheel::tExpiredTimer> m_expiredRepeats;        ///< Used when retrieving the repeats to fire
+    bool                                m_bNotifyingRepeat;         ///< Indicates if the event being notified is a repeat
+
+    unsigned long                       m_ulNbVirtualEvents;        ///< Number of virtual events notified
+    unsigned long                       m_ulNbCoalescedEvents;      ///< Number of moves of the virtual axes not reported
 };
 
 }
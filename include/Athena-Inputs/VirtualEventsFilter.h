@@ -0,0 +1,117 @@
+/** @file   VirtualEventsFilter.h
+    @author Philip Abbet
+
+    Declaration of the class 'Athena::Inputs::VirtualEventsFilter'
+*/
+
+#ifndef _ATHENA_INPUTS_VIRTUALEVENTSFILTER_H_
+#define _ATHENA_INPUTS_VIRTUALEVENTSFILTER_H_
+
+#include <Athena-Inputs/Prerequisites.h>
+#include <Athena-Inputs/Declarations.h>
+#include <vector>
+
+
+namespace Athena {
+namespace Inputs {
+
+//---------------------------------------------------------------------------------------
+/// @brief  Describes the virtual events a listener is interested in
+///
+/// The filter is a bitset over the (dense) virtual IDs, with one bit for each part of
+/// each virtual ID, so testing an event only costs a bit test. Whole parts (for
+/// instance, all the virtual axes) can be accepted too.
+///
+/// A new filter doesn't accept anything.
+///
+/// @see    VirtualController::addEventsListener()
+//---------------------------------------------------------------------------------------
+class ATHENA_INPUTS_SYMBOL VirtualEventsFilter
+{
+    //_____ Construction / Destruction __________
+public:
+    //-----------------------------------------------------------------------------------
+    /// @brief  Constructor
+    //-----------------------------------------------------------------------------------
+    VirtualEventsFilter();
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Destructor
+    //-----------------------------------------------------------------------------------
+    ~VirtualEventsFilter();
+
+
+    //_____ Methods __________
+public:
+    //-----------------------------------------------------------------------------------
+    /// @brief  Accept the events of all the parts of a virtual ID
+    ///
+    /// @param  virtualID   The virtual ID
+    //-----------------------------------------------------------------------------------
+    void add(tVirtualID virtualID);
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Accept the events of one part of a virtual ID
+    ///
+    /// @param  virtualID   The virtual ID
+    /// @param  part        The part
+    //-----------------------------------------------------------------------------------
+    void add(tVirtualID virtualID, tControllerPart part);
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Stop accepting the events of a virtual ID
+    ///
+    /// @remark The parts accepted with addPart() are still accepted
+    /// @param  virtualID   The virtual ID
+    //-----------------------------------------------------------------------------------
+    void remove(tVirtualID virtualID);
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Accept the events of all the virtual IDs of a part
+    ///
+    /// @param  part    The part
+    //-----------------------------------------------------------------------------------
+    void addPart(tControllerPart part);
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Accept all the events
+    //-----------------------------------------------------------------------------------
+    void addAll();
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Don't accept any event anymore
+    //-----------------------------------------------------------------------------------
+    void clear();
+
+    //-----------------------------------------------------------------------------------
+    /// @brief  Indicates if an event is accepted
+    ///
+    /// @param  event   The virtual event
+    /// @return         'true' if the event is accepted
+    //-----------------------------------------------------------------------------------
+    inline bool accepts(const tVirtualEvent& event) const
+    {
+        if (m_uiParts & (1u << event.part))
+            return true;
+
+        unsigned int uiBit = event.virtualID * BITS_PER_ID + event.part;
+
+        return ((uiBit >> 5) < m_bits.size()) && ((m_bits[uiBit >> 5] >> (uiBit & 31)) & 1);
+    }
+
+
+    //_____ Constants __________
+private:
+    static const unsigned int BITS_PER_ID = 4;  ///< Number of bits of each virtual ID (one by part)
+
+
+    //_____ Attributes __________
+private:
+    std::vector<unsigned int>   m_bits;     ///< The bitset, indexed by (virtual ID * BITS_PER_ID + part)
+    unsigned int                m_uiParts;  ///< The parts accepted for all the virtual IDs (one bit by part)
+};
+
+}
+}
+
+#endif
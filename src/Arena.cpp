@@ -0,0 +1,193 @@
+/** @file   Arena.cpp
+    @author Philip Abbet
+
+    Implementation of the class 'Athena::Inputs::Arena'
+*/
+
+#include <Athena-Inputs/Arena.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+using namespace Athena;
+using namespace Athena::Inputs;
+using namespace std;
+
+
+/****************************** CONSTRUCTION / DESTRUCTION *****************************/
+
+Arena::Arena(unsigned int uiChunkSize)
+: m_uiChunkSize(uiChunkSize), m_pChunks(0), m_pCurrent(0), m_pEnd(0), m_pBigFreeBlocks(0)
+{
+    // Assertions
+    assert(uiChunkSize >= ALIGNMENT);
+
+    memset(m_freeLists, 0, sizeof(m_freeLists));
+    memset(&m_stats, 0, sizeof(m_stats));
+}
+
+//-----------------------------------------------------------------------
+
+Arena::~Arena()
+{
+    release();
+}
+
+
+/************************************** METHODS ****************************************/
+
+void* Arena::allocate(size_t size)
+{
+    // Declarations
+    size_t      alignedSize = (size + ALIGNMENT - 1) & ~((size_t) ALIGNMENT - 1);
+    size_t      sizeClass;
+    size_t      blocksSize;
+    size_t      chunkSize;
+    tChunk*     pChunk;
+    char*       pFirstBlock;
+    tFreeBlock* pFreeBlock;
+    tFreeBlock* pPrevious;
+    void*       pBlock;
+
+    if (alignedSize == 0)
+        alignedSize = ALIGNMENT;
+
+    // Reuse a released block of the same size
+    sizeClass = alignedSize / ALIGNMENT - 1;
+    if ((sizeClass < NB_SIZE_CLASSES) && m_freeLists[sizeClass])
+    {
+        pBlock = m_freeLists[sizeClass];
+        m_freeLists[sizeClass] = m_freeLists[sizeClass]->pNext;
+
+        m_stats.ulUsedSize += alignedSize;
+        ++m_stats.ulNbAllocations;
+        ++m_stats.ulNbReuses;
+
+        return pBlock;
+    }
+
+    if (sizeClass >= NB_SIZE_CLASSES)
+    {
+        for (pFreeBlock = m_pBigFreeBlocks, pPrevious = 0; pFreeBlock;
+             pPrevious = pFreeBlock, pFreeBlock = pFreeBlock->pNext)
+        {
+            if (pFreeBlock->size != alignedSize)
+                continue;
+
+            if (pPrevious)
+                pPrevious->pNext = pFreeBlock->pNext;
+            else
+                m_pBigFreeBlocks = pFreeBlock->pNext;
+
+            m_stats.ulUsedSize += alignedSize;
+            ++m_stats.ulNbAllocations;
+            ++m_stats.ulNbReuses;
+
+            return pFreeBlock;
+        }
+    }
+
+    // Allocate a new chunk if needed (the current one is abandoned)
+    if ((size_t) (m_pEnd - m_pCurrent) < alignedSize)
+    {
+        // malloc() only guarantees the alignment of the fundamental types (8 bytes on
+        // some platforms): the blocks start at the first aligned address after the
+        // header
+        blocksSize  = (alignedSize > m_uiChunkSize ? alignedSize : m_uiChunkSize);
+        chunkSize   = sizeof(tChunk) + ALIGNMENT - 1 + blocksSize;
+
+        pChunk = (tChunk*) malloc(chunkSize);
+        if (!pChunk)
+            throw std::bad_alloc();
+
+        pChunk->size = chunkSize;
+
+        pFirstBlock = (char*) (((size_t) (pChunk + 1) + ALIGNMENT - 1) & ~((size_t) ALIGNMENT - 1));
+
+        // A chunk dedicated to a big block doesn't replace the current one
+        if ((alignedSize > m_uiChunkSize) && m_pChunks)
+        {
+            pChunk->pNext = m_pChunks->pNext;
+            m_pChunks->pNext = pChunk;
+
+            ++m_stats.uiNbChunks;
+            m_stats.ulReservedSize += chunkSize;
+            m_stats.ulUsedSize += alignedSize;
+            ++m_stats.ulNbAllocations;
+
+            return pFirstBlock;
+        }
+
+        pChunk->pNext = m_pChunks;
+        m_pChunks = pChunk;
+
+        m_pCurrent  = pFirstBlock;
+        m_pEnd      = pFirstBlock + blocksSize;
+
+        ++m_stats.uiNbChunks;
+        m_stats.ulReservedSize += chunkSize;
+    }
+
+    pBlock = m_pCurrent;
+    m_pCurrent += alignedSize;
+
+    m_stats.ulUsedSize += alignedSize;
+    ++m_stats.ulNbAllocations;
+
+    return pBlock;
+}
+
+//-----------------------------------------------------------------------
+
+void Arena::deallocate(void* pBlock, size_t size)
+{
+    // Declarations
+    size_t alignedSize = (size + ALIGNMENT - 1) & ~((size_t) ALIGNMENT - 1);
+    size_t sizeClass;
+
+    if (!pBlock)
+        return;
+
+    if (alignedSize == 0)
+        alignedSize = ALIGNMENT;
+
+    m_stats.ulUsedSize -= alignedSize;
+
+    tFreeBlock* pFreeBlock = (tFreeBlock*) pBlock;
+
+    sizeClass = alignedSize / ALIGNMENT - 1;
+    if (sizeClass < NB_SIZE_CLASSES)
+    {
+        pFreeBlock->pNext = m_freeLists[sizeClass];
+        m_freeLists[sizeClass] = pFreeBlock;
+    }
+    else
+    {
+        pFreeBlock->size    = alignedSize;
+        pFreeBlock->pNext   = m_pBigFreeBlocks;
+        m_pBigFreeBlocks    = pFreeBlock;
+    }
+}
+
+//-----------------------------------------------------------------------
+
+void Arena::release()
+{
+    // Declarations
+    tChunk* pChunk;
+
+    while (m_pChunks)
+    {
+        pChunk = m_pChunks;
+        m_pChunks = m_pChunks->pNext;
+        free(pChunk);
+    }
+
+    m_pCurrent  = 0;
+    m_pEnd      = 0;
+
+    memset(m_freeLists, 0, sizeof(m_freeLists));
+    m_pBigFreeBlocks = 0;
+
+    memset(&m_stats, 0, sizeof(m_stats));
+}
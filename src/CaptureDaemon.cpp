@@ -0,0 +1,156 @@
+/** @file   CaptureDaemon.cpp
+    @author Philip Abbet
+
+    Implementation of the class 'Athena::Inputs::CaptureDaemon'
+*/
+
+#include <Athena-Inputs/CaptureDaemon.h>
+#include <Athena-Inputs/Keyboard.h>
+#include <Athena-Inputs/Mouse.h>
+#include <Athena-Inputs/Gamepad.h>
+#include <Athena-Inputs/GamepadsWatcher.h>
+#include <Athena-Core/Log/LogManager.h>
+#include <OIS/OISKeyboard.h>
+#include <OIS/OISMouse.h>
+#include <OIS/OISJoyStick.h>
+
+
+using namespace Athena;
+using namespace Athena::Inputs;
+using namespace Athena::Log;
+using namespace std;
+
+
+/************************************** CONSTANTS **************************************/
+
+/// Context used for logging
+static const char* __CONTEXT__ = "Capture daemon";
+
+
+/****************************** CONSTRUCTION / DESTRUCTION *****************************/
+
+CaptureDaemon::CaptureDaemon()
+: m_pManager(0)
+{
+}
+
+//-----------------------------------------------------------------------
+
+CaptureDaemon::~CaptureDaemon()
+{
+    // Declarations
+    vector<Controller*>::iterator iter, iterEnd;
+
+    for (iter = m_controllers.begin(), iterEnd = m_controllers.end(); iter != iterEnd; ++iter)
+        delete *iter;
+
+    if (m_pManager)
+        OIS::InputManager::destroyInputSystem(m_pManager);
+
+    m_ring.close();
+}
+
+
+/************************************** METHODS ****************************************/
+
+bool CaptureDaemon::init(const std::string& strRingName, unsigned int uiCapacity)
+{
+    ATHENA_LOG_EVENT("Creation of the shared events ring '" + strRingName + "'");
+
+    if (!m_ring.create(strRingName, uiCapacity))
+    {
+        ATHENA_LOG_ERROR("Failed to create the shared events ring '" + strRingName + "'");
+        return false;
+    }
+
+    return true;
+}
+
+//-----------------------------------------------------------------------
+
+bool CaptureDaemon::createDevices(void* mainWindowHandle)
+{
+    // Assertions
+    assert(!m_pManager);
+
+    // Declarations
+    map<string, unsigned int>   ordinals;
+    unsigned int                uiNbGamepads = 0;
+
+    m_pManager = OIS::InputManager::createInputSystem((size_t) mainWindowHandle);
+    if (!m_pManager)
+    {
+        ATHENA_LOG_ERROR("Failed to initialize the input system");
+        return false;
+    }
+
+    addController(new Keyboard(m_pManager->createInputObject(OIS::OISKeyboard, true)));
+    addController(new Mouse(m_pManager->createInputObject(OIS::OISMouse, true)));
+
+    OIS::DeviceList devices = m_pManager->listFreeDevices();
+
+    for (OIS::DeviceList::iterator iter = devices.begin(); iter != devices.end(); ++iter)
+    {
+        if (iter->first != OIS::OISJoyStick)
+            continue;
+
+        Gamepad* pGamepad = new Gamepad(m_pManager->createInputObject(OIS::OISJoyStick, true, iter->second),
+                                        ++uiNbGamepads);
+        pGamepad->setIdentity(GamepadsWatcher::getIdentity(iter->second, ordinals[iter->second]++));
+
+        addController(pGamepad);
+    }
+
+    return true;
+}
+
+//-----------------------------------------------------------------------
+
+bool CaptureDaemon::addController(Controller* pController)
+{
+    // Assertions
+    assert(pController);
+    assert(m_ring.isOpen());
+
+    unsigned int uiDevice = m_ring.addDevice(pController->getType(), pController->getIndex(),
+                                             pController->getName(), pController->getIdentity());
+    if (uiDevice == SharedEventsRing::MAX_DEVICES)
+    {
+        ATHENA_LOG_ERROR("Too many controllers, '" + pController->getIdentity() + "' ignored");
+        delete pController;
+        return false;
+    }
+
+    ATHENA_LOG_EVENT("Adding the controller '" + pController->getIdentity() + "'");
+
+    m_controllers.push_back(pController);
+    m_devices[pController] = uiDevice;
+
+    pController->registerListener(this);
+    pController->activate(true);
+
+    return true;
+}
+
+//-----------------------------------------------------------------------
+
+void CaptureDaemon::capture()
+{
+    // Declarations
+    vector<Controller*>::iterator iter, iterEnd;
+
+    for (iter = m_controllers.begin(), iterEnd = m_controllers.end(); iter != iterEnd; ++iter)
+        (*iter)->capture();
+}
+
+
+/**************************** IMPLEMENTATION OF IEVENTSLISTENER ************************/
+
+void CaptureDaemon::onEvent(tInputEvent* pEvent)
+{
+    // Declarations
+    map<Controller*, unsigned int>::iterator iter = m_devices.find(pEvent->pController);
+
+    if (iter != m_devices.end())
+        m_ring.write(iter->second, *pEvent);
+}
@@ -0,0 +1,367 @@
+/** @file   ComboRecognizer.cpp
+    @author Philip Abbet
+
+    Implementation of the class 'Athena::Inputs::ComboRecognizer'
+*/
+
+#include <Athena-Inputs/ComboRecognizer.h>
+#include <Athena-Core/Log/LogManager.h>
+#include <deque>
+
+
+using namespace Athena;
+using namespace Athena::Inputs;
+using namespace Athena::Log;
+using namespace std;
+
+
+/************************************** CONSTANTS **************************************/
+
+/// Context used for logging
+static const char* __CONTEXT__ = "Combo recognizer";
+
+/// Indicates that a virtual ID or an event doesn't correspond to a symbol
+static const unsigned int NO_SYMBOL = 0xFFFFFFFF;
+
+/// Indicates that a transition of the trie doesn't exist (only used during the
+/// compilation)
+static const unsigned int NO_NODE = 0xFFFFFFFF;
+
+/// Number of symbols allocated for each virtual POV (one for each possible position)
+static const unsigned int NB_POV_SYMBOLS = 16;
+
+
+/****************************** CONSTRUCTION / DESTRUCTION *****************************/
+
+ComboRecognizer::ComboRecognizer()
+: m_bCompiled(false), m_uiEpoch(0), m_uiNbSymbols(0)
+{
+}
+
+//-----------------------------------------------------------------------
+
+ComboRecognizer::~ComboRecognizer()
+{
+}
+
+
+/****************************** MANAGEMENT OF THE COMBOS *******************************/
+
+bool ComboRecognizer::addCombo(tVirtualID comboID, const std::vector<tStep>& steps)
+{
+    // Declarations
+    vector<tStep>::const_iterator   iter, iterEnd;
+    vector<tCombo>::iterator        iterCombo, iterComboEnd;
+    tCombo                          combo;
+
+    if (steps.empty())
+    {
+        ATHENA_LOG_ERROR("Can't add a combo without any step");
+        return false;
+    }
+
+    // A combo can't be a step of another one (the recognizer would feed itself)
+    if ((comboID < m_firstSymbols.size()) && (m_firstSymbols[comboID] != NO_SYMBOL))
+    {
+        ATHENA_LOG_ERROR("Can't add a combo, its virtual ID is already used by a step");
+        return false;
+    }
+
+    for (iter = steps.begin(), iterEnd = steps.end(); iter != iterEnd; ++iter)
+    {
+        if ((iter->part != PART_KEY) && (iter->part != PART_POV))
+        {
+            ATHENA_LOG_ERROR("Can't add a combo, its steps must be virtual keys or virtual POVs");
+            return false;
+        }
+
+        if ((iter->part == PART_POV) && (iter->position >= NB_POV_SYMBOLS))
+        {
+            ATHENA_LOG_ERROR("Can't add a combo, invalid POV position");
+            return false;
+        }
+
+        if ((iter->virtualID < m_parts.size()) && (m_firstSymbols[iter->virtualID] != NO_SYMBOL) &&
+            (m_parts[iter->virtualID] != iter->part))
+        {
+            ATHENA_LOG_ERROR("Can't add a combo, a virtual ID is used both as a key and a POV");
+            return false;
+        }
+
+        if (iter->virtualID == comboID)
+        {
+            ATHENA_LOG_ERROR("Can't add a combo, its virtual ID is used by one of its steps");
+            return false;
+        }
+
+        for (iterCombo = m_combos.begin(), iterComboEnd = m_combos.end();
+             iterCombo != iterComboEnd; ++iterCombo)
+        {
+            if (iterCombo->comboID == iter->virtualID)
+            {
+                ATHENA_LOG_ERROR("Can't add a combo, one of its steps is another combo");
+                return false;
+            }
+        }
+    }
+
+    // The combos with the same first steps share the nodes of the automaton, so their
+    // timing windows must be the same (the delay of the first step is ignored)
+    for (iterCombo = m_combos.begin(), iterComboEnd = m_combos.end();
+         iterCombo != iterComboEnd; ++iterCombo)
+    {
+        for (unsigned int i = 0; (i < steps.size()) && (i < iterCombo->symbols.size()); ++i)
+        {
+            const tStep& step = steps[i];
+
+            if ((step.virtualID >= m_firstSymbols.size()) || (m_firstSymbols[step.virtualID] == NO_SYMBOL))
+                break;
+
+            unsigned int uiSymbol = m_firstSymbols[step.virtualID];
+            if (step.part == PART_POV)
+                uiSymbol += step.position;
+
+            if (uiSymbol != iterCombo->symbols[i])
+                break;
+
+            if ((i > 0) && (step.ulMaxDelay != iterCombo->maxDelays[i]))
+            {
+                ATHENA_LOG_ERROR("Can't add a combo, its timing windows differ from the ones of a combo starting with the same steps");
+                return false;
+            }
+        }
+    }
+
+    // Convert the steps into symbols
+    combo.comboID = comboID;
+
+    for (iter = steps.begin(), iterEnd = steps.end(); iter != iterEnd; ++iter)
+    {
+        unsigned int uiSymbol = getOrCreateSymbol(iter->virtualID, iter->part);
+        if (iter->part == PART_POV)
+            uiSymbol += iter->position;
+
+        combo.symbols.push_back(uiSymbol);
+        combo.maxDelays.push_back(iter->ulMaxDelay);
+    }
+
+    m_combos.push_back(combo);
+    m_bCompiled = false;
+
+    return true;
+}
+
+//-----------------------------------------------------------------------
+
+void ComboRecognizer::clear()
+{
+    m_combos.clear();
+    m_firstSymbols.clear();
+    m_parts.clear();
+    m_uiNbSymbols = 0;
+
+    m_transitions.clear();
+    m_depths.clear();
+    m_maxDelays.clear();
+    m_outputOffsets.clear();
+    m_outputs.clear();
+
+    m_bCompiled = false;
+}
+
+//-----------------------------------------------------------------------
+
+void ComboRecognizer::compile()
+{
+    // Declarations
+    vector<tCombo>::iterator            iterCombo, iterComboEnd;
+    vector<vector<tVirtualID> >         outputs;
+    vector<unsigned int>                failures;
+    deque<unsigned int>                 queue;
+    unsigned int                        uiNode, uiChild, uiSymbol, i;
+    const unsigned int                  uiNbSymbols = m_uiNbSymbols;
+
+    m_transitions.assign(uiNbSymbols, NO_NODE);
+    m_depths.assign(1, 0);
+    m_maxDelays.assign(1, 0);
+    outputs.resize(1);
+
+    // Build the trie of the combos
+    for (iterCombo = m_combos.begin(), iterComboEnd = m_combos.end();
+         iterCombo != iterComboEnd; ++iterCombo)
+    {
+        uiNode = 0;
+
+        for (i = 0; i < iterCombo->symbols.size(); ++i)
+        {
+            uiSymbol = iterCombo->symbols[i];
+            uiChild = m_transitions[uiNode * uiNbSymbols + uiSymbol];
+
+            if (uiChild == NO_NODE)
+            {
+                uiChild = (unsigned int) m_depths.size();
+                m_transitions[uiNode * uiNbSymbols + uiSymbol] = uiChild;
+
+                m_transitions.resize(m_transitions.size() + uiNbSymbols, NO_NODE);
+                m_depths.push_back(m_depths[uiNode] + 1);
+                m_maxDelays.push_back(iterCombo->maxDelays[i]);
+                outputs.resize(outputs.size() + 1);
+            }
+
+            uiNode = uiChild;
+        }
+
+        outputs[uiNode].push_back(iterCombo->comboID);
+    }
+
+    // Compute the failure links and complete the transitions, in breadth-first order
+    // (the failure link of a node always points to a shallower node)
+    failures.assign(m_depths.size(), 0);
+
+    for (uiSymbol = 0; uiSymbol < uiNbSymbols; ++uiSymbol)
+    {
+        uiChild = m_transitions[uiSymbol];
+        if (uiChild == NO_NODE)
+        {
+            m_transitions[uiSymbol] = 0;
+        }
+        else
+        {
+            failures[uiChild] = 0;
+            queue.push_back(uiChild);
+        }
+    }
+
+    while (!queue.empty())
+    {
+        uiNode = queue.front();
+        queue.pop_front();
+
+        const unsigned int uiFailure = failures[uiNode];
+
+        // The combos recognized at the failure node are recognized here too
+        outputs[uiNode].insert(outputs[uiNode].end(), outputs[uiFailure].begin(),
+                               outputs[uiFailure].end());
+
+        for (uiSymbol = 0; uiSymbol < uiNbSymbols; ++uiSymbol)
+        {
+            uiChild = m_transitions[uiNode * uiNbSymbols + uiSymbol];
+            if (uiChild == NO_NODE)
+            {
+                m_transitions[uiNode * uiNbSymbols + uiSymbol] = m_transitions[uiFailure * uiNbSymbols + uiSymbol];
+            }
+            else
+            {
+                failures[uiChild] = m_transitions[uiFailure * uiNbSymbols + uiSymbol];
+                queue.push_back(uiChild);
+            }
+        }
+    }
+
+    // Flatten the lists of recognized combos
+    m_outputOffsets.resize(m_depths.size() + 1);
+    m_outputs.clear();
+
+    for (uiNode = 0; uiNode < m_depths.size(); ++uiNode)
+    {
+        m_outputOffsets[uiNode] = (unsigned int) m_outputs.size();
+        m_outputs.insert(m_outputs.end(), outputs[uiNode].begin(), outputs[uiNode].end());
+    }
+
+    m_outputOffsets[m_depths.size()] = (unsigned int) m_outputs.size();
+
+    // The states of the previous automaton are now invalid
+    ++m_uiEpoch;
+    m_bCompiled = true;
+}
+
+
+/************************************** RECOGNITION ************************************/
+
+void ComboRecognizer::reset(tState &state) const
+{
+    state.uiNode        = 0;
+    state.uiLastSymbol  = NO_SYMBOL;
+    state.ulTimestamp   = 0;
+    state.uiEpoch       = m_uiEpoch;
+}
+
+//-----------------------------------------------------------------------
+
+unsigned int ComboRecognizer::advance(tState &state, const tVirtualEvent& event,
+                                      const tVirtualID* &pCombos) const
+{
+    // Assertions
+    assert(m_bCompiled);
+
+    pCombos = 0;
+
+    // The automaton was compiled again since the last use of the state (the
+    // recognizer can be shared by several virtual controllers)
+    if (state.uiEpoch != m_uiEpoch)
+        reset(state);
+
+    unsigned int uiSymbol = getSymbol(event);
+    if (uiSymbol == NO_SYMBOL)
+        return 0;
+
+    // A POV can report the same position several times in a row
+    if ((event.part == PART_POV) && (uiSymbol == state.uiLastSymbol))
+        return 0;
+
+    unsigned int uiNode = m_transitions[state.uiNode * m_uiNbSymbols + uiSymbol];
+
+    // Timing window exceeded: restart from this event
+    if ((m_depths[uiNode] > 1) && (event.ulTimestamp - state.ulTimestamp > m_maxDelays[uiNode]))
+        uiNode = m_transitions[uiSymbol];
+
+    state.uiNode        = uiNode;
+    state.uiLastSymbol  = uiSymbol;
+    state.ulTimestamp   = event.ulTimestamp;
+
+    unsigned int uiNbCombos = m_outputOffsets[uiNode + 1] - m_outputOffsets[uiNode];
+    if (uiNbCombos > 0)
+        pCombos = &m_outputs[m_outputOffsets[uiNode]];
+
+    return uiNbCombos;
+}
+
+
+/*********************************** INTERNAL METHODS **********************************/
+
+unsigned int ComboRecognizer::getOrCreateSymbol(tVirtualID virtualID, tControllerPart part)
+{
+    if (virtualID >= m_firstSymbols.size())
+    {
+        m_firstSymbols.resize(virtualID + 1, NO_SYMBOL);
+        m_parts.resize(virtualID + 1, PART_KEY);
+    }
+
+    if (m_firstSymbols[virtualID] == NO_SYMBOL)
+    {
+        m_firstSymbols[virtualID] = m_uiNbSymbols;
+        m_parts[virtualID] = part;
+        m_uiNbSymbols += (part == PART_POV ? NB_POV_SYMBOLS : 1);
+    }
+
+    return m_firstSymbols[virtualID];
+}
+
+//-----------------------------------------------------------------------
+
+unsigned int ComboRecognizer::getSymbol(const tVirtualEvent& event) const
+{
+    if ((event.virtualID >= m_firstSymbols.size()) || (m_firstSymbols[event.virtualID] == NO_SYMBOL))
+        return NO_SYMBOL;
+
+    if (event.part != m_parts[event.virtualID])
+        return NO_SYMBOL;
+
+    if (event.part == PART_KEY)
+        return (event.value.bPressed ? m_firstSymbols[event.virtualID] : NO_SYMBOL);
+
+    if (event.value.position >= NB_POV_SYMBOLS)
+        return NO_SYMBOL;
+
+    return m_firstSymbols[event.virtualID] + event.value.position;
+}
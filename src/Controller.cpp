@@ -5,9 +5,19 @@
 */
 
 #include <Athena-Inputs/Controller.h>
+#include <Athena-Inputs/InputsUnit.h>
 #include <Athena-Core/Utils/StringConverter.h>
 #include <OIS/OISInputManager.h>
 
+#if ATHENA_PLATFORM == ATHENA_PLATFORM_WIN32
+#   define WIN32_LEAN_AND_MEAN
+#   include <windows.h>
+#elif ATHENA_PLATFORM == ATHENA_PLATFORM_APPLE
+#   include <mach/mach_time.h>
+#else
+#   include <time.h>
+#endif
+
 
 using namespace Athena;
 using namespace Athena::Inputs;
@@ -18,15 +28,26 @@ using namespace std;
 /***************************** CONSTRUCTION / DESTRUCTION ******************************/
 
 Controller::Controller(OIS::Object* pOISObject, unsigned int uiIndex)
-: m_pOISObject(pOISObject), m_uiIndex(uiIndex)
+: m_pOISObject(pOISObject), m_type(pOISObject->type()), m_uiIndex(uiIndex),
+  m_strName(pOISObject->vendor()), m_bActive(true)
 {
+    m_strIdentity = toString();
+}
+
+//-----------------------------------------------------------------------
+
+Controller::Controller(OIS::Type type, unsigned int uiIndex, const std::string& strName)
+: m_pOISObject(0), m_type(type), m_uiIndex(uiIndex), m_strName(strName), m_bActive(true)
+{
+    m_strIdentity = toString();
 }
 
 //-----------------------------------------------------------------------
 
 Controller::~Controller()
 {
-    m_pOISObject->getCreator()->destroyInputObject(m_pOISObject);
+    if (m_pOISObject)
+        m_pOISObject->getCreator()->destroyInputObject(m_pOISObject);
 }
 
 
@@ -34,7 +55,7 @@ Controller::~Controller()
 
 const string Controller::toString() const
 {
-    switch (m_pOISObject->type())
+    switch (m_type)
     {
     case OIS::OISKeyboard:
         return "Keyboard";
@@ -98,6 +119,9 @@ const string Controller::toString() const
 void Controller::registerListener(IEventsListener* pListener)
 {
     m_listeners.push_back(pListener);
+
+    if (InputsUnit::getSingletonPtr())
+        InputsUnit::getSingletonPtr()->_updateActivation(this);
 }
 
 //-----------------------------------------------------------------------
@@ -115,4 +139,59 @@ void Controller::removeListener(IEventsListener* pListener)
             break;
         }
     }
+
+    if (InputsUnit::getSingletonPtr())
+        InputsUnit::getSingletonPtr()->_updateActivation(this);
+}
+
+//-----------------------------------------------------------------------
+
+unsigned long Controller::getTimestamp()
+{
+#if ATHENA_PLATFORM == ATHENA_PLATFORM_WIN32
+    return (unsigned long) GetTickCount();
+#elif ATHENA_PLATFORM == ATHENA_PLATFORM_APPLE
+    static mach_timebase_info_data_t timebase = { 0, 0 };
+
+    if (timebase.denom == 0)
+        mach_timebase_info(&timebase);
+
+    return (unsigned long) (mach_absolute_time() * timebase.numer / timebase.denom / 1000000);
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (unsigned long) now.tv_sec * 1000 + (unsigned long) (now.tv_nsec / 1000000);
+#endif
+}
+
+//-----------------------------------------------------------------------
+
+unsigned long Controller::getPreciseTimestamp()
+{
+#if ATHENA_PLATFORM == ATHENA_PLATFORM_WIN32
+    static LARGE_INTEGER frequency = { 0 };
+    LARGE_INTEGER counter;
+
+    if (frequency.QuadPart == 0)
+        QueryPerformanceFrequency(&frequency);
+
+    QueryPerformanceCounter(&counter);
+
+    // Split the conversion, so the multiplication doesn't overflow with a high uptime
+    return (unsigned long) ((counter.QuadPart / frequency.QuadPart) * 1000000 +
+                            (counter.QuadPart % frequency.QuadPart) * 1000000 / frequency.QuadPart);
+#elif ATHENA_PLATFORM == ATHENA_PLATFORM_APPLE
+    static mach_timebase_info_data_t timebase = { 0, 0 };
+
+    if (timebase.denom == 0)
+        mach_timebase_info(&timebase);
+
+    return (unsigned long) (mach_absolute_time() * timebase.numer / timebase.denom / 1000);
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (unsigned long) now.tv_sec * 1000000 + (unsigned long) (now.tv_nsec / 1000);
+#endif
 }
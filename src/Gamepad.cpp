@@ -16,12 +16,16 @@ using namespace std;
 
 /****************************** CONSTRUCTION / DESTRUCTION ******************************/
 
-Gamepad::Gamepad(OIS::Object* pOISObject)
-: Controller(pOISObject, 1)
+Gamepad::Gamepad(OIS::Object* pOISObject, unsigned int uiIndex)
+: Controller(pOISObject, uiIndex), m_uiKnownPOVs(0), m_ulNbSuppressedAxisEvents(0),
+  m_ulNbSuppressedPOVEvents(0)
 {
     assert(pOISObject->type() == OIS::OISJoyStick);
 
     static_cast<OIS::JoyStick*>(pOISObject)->setEventCallback(this);
+
+    m_axisValues.resize(getOISJoyStick()->getJoyStickState().mAxes.size(), 0);
+    m_knownAxes.resize(m_axisValues.size(), false);
 }
 
 //-----------------------------------------------------------------------
@@ -31,6 +35,21 @@ Gamepad::~Gamepad()
 }
 
 
+/************************************** METHODS ****************************************/
+
+void Gamepad::activate(bool bActivate)
+{
+    if (bActivate && !isActive())
+    {
+        m_axisValues.assign(getOISJoyStick()->getJoyStickState().mAxes.size(), 0);
+        m_knownAxes.assign(m_axisValues.size(), false);
+        m_uiKnownPOVs = 0;
+    }
+
+    Controller::activate(bActivate);
+}
+
+
 /************************* IMPLEMENTATION OF OIS::JoyStickListener **********************/
 
 bool Gamepad::buttonPressed(const OIS::JoyStickEvent &arg, int button)
@@ -40,6 +59,7 @@ bool Gamepad::buttonPressed(const OIS::JoyStickEvent &arg, int button)
     tInputEvent event;
 
     event.pController       = this;
+    event.ulTimeStamp       = getTimestamp();
     event.part              = PART_KEY;
     event.partID.key        = button;
     event.value.bPressed    = true;
@@ -62,6 +82,7 @@ bool Gamepad::buttonReleased(const OIS::JoyStickEvent &arg, int button)
     tInputEvent event;
 
     event.pController       = this;
+    event.ulTimeStamp       = getTimestamp();
     event.part              = PART_KEY;
     event.partID.key        = button;
     event.value.bPressed    = false;
@@ -83,7 +104,21 @@ bool Gamepad::axisMoved(const OIS::JoyStickEvent &arg, int axis)
     tListenersList::iterator listenersIter, listenersIterEnd;
     tInputEvent event;
 
+    // OIS reports again the axes which didn't move
+    if ((axis >= 0) && (axis < (int) m_axisValues.size()))
+    {
+        if (m_knownAxes[axis] && (m_axisValues[axis] == arg.state.mAxes[axis].abs))
+        {
+            ++m_ulNbSuppressedAxisEvents;
+            return true;
+        }
+
+        m_axisValues[axis] = arg.state.mAxes[axis].abs;
+        m_knownAxes[axis]  = true;
+    }
+
     event.pController   = this;
+    event.ulTimeStamp   = getTimestamp();
     event.part          = PART_AXIS;
     event.partID.axis   = (AXIS_X << axis);
     event.value.iValue  = arg.state.mAxes[axis].abs;
@@ -106,6 +141,7 @@ bool Gamepad::sliderMoved(const OIS::JoyStickEvent &arg, int index)
     // tInputEvent event;
     //
     // event.pController   = this;
+    // event.ulTimeStamp   = getTimestamp();
     // event.part          = PART_AXIS;
     // event.partID.axis   = (SLIDER_0 << index);
     // event.value.iValue  = arg.state.mSliders[index].abs;
@@ -127,7 +163,21 @@ bool Gamepad::povMoved(const OIS::JoyStickEvent &arg, int index)
     tListenersList::iterator listenersIter, listenersIterEnd;
     tInputEvent event;
 
+    // OIS reports again the POVs which didn't move
+    if ((index >= 0) && (index < (int) MAX_POVS))
+    {
+        if ((m_uiKnownPOVs & (1u << index)) && (m_povValues[index] == arg.state.mPOV[index].direction))
+        {
+            ++m_ulNbSuppressedPOVEvents;
+            return true;
+        }
+
+        m_povValues[index] = arg.state.mPOV[index].direction;
+        m_uiKnownPOVs |= (1u << index);
+    }
+
     event.pController   = this;
+    event.ulTimeStamp   = getTimestamp();
     event.part          = PART_POV;
     event.partID.pov    = index;
     event.value.iValue  = arg.state.mPOV[index].direction;
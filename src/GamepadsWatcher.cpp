@@ -0,0 +1,384 @@
+/** @file   GamepadsWatcher.cpp
+    @author Philip Abbet
+
+    Implementation of the class 'Athena::Inputs::GamepadsWatcher'
+*/
+
+#include <Athena-Inputs/GamepadsWatcher.h>
+#include <Athena-Core/Utils/StringConverter.h>
+#include <OIS/OISInputManager.h>
+#include <OIS/OISJoyStick.h>
+#include <algorithm>
+
+#if ATHENA_PLATFORM == ATHENA_PLATFORM_WIN32
+#   define WIN32_LEAN_AND_MEAN
+#   include <windows.h>
+#elif ATHENA_PLATFORM != ATHENA_PLATFORM_APPLE
+#   include <dirent.h>
+#   include <sys/stat.h>
+#   include <string.h>
+#endif
+
+
+using namespace Athena;
+using namespace Athena::Inputs;
+using namespace Athena::Utils;
+using namespace std;
+
+
+/************************************** CONSTANTS **************************************/
+
+/// Granularity of the waits of the background thread, in milliseconds
+static const unsigned int SLEEP_GRANULARITY = 50;
+
+
+/********************************** DEVICES SIGNATURE **********************************/
+
+/// Retrieve a signature of the input devices, which changes when a device is plugged or
+/// unplugged. Returns 'false' if the platform has no cheap way to compute it (the
+/// gamepads are then enumerated each time).
+static bool getDevicesSignature(string &strSignature)
+{
+    strSignature.clear();
+
+#if ATHENA_PLATFORM == ATHENA_PLATFORM_WIN32
+    UINT uiNbDevices = 0;
+
+    if (GetRawInputDeviceList(0, &uiNbDevices, sizeof(RAWINPUTDEVICELIST)) != 0)
+        return false;
+
+    if (uiNbDevices == 0)
+        return true;
+
+    vector<RAWINPUTDEVICELIST> devices(uiNbDevices);
+
+    if (GetRawInputDeviceList(&devices[0], &uiNbDevices, sizeof(RAWINPUTDEVICELIST)) == (UINT) -1)
+        return false;
+
+    // The handle of a device changes when it is replugged
+    for (UINT i = 0; i < uiNbDevices; ++i)
+    {
+        if (devices[i].dwType == RIM_TYPEHID)
+            strSignature.append((const char*) &devices[i].hDevice, sizeof(HANDLE));
+    }
+
+    return true;
+#elif ATHENA_PLATFORM != ATHENA_PLATFORM_APPLE
+    DIR*            pDir;
+    struct dirent*  pEntry;
+    struct stat     infos;
+    vector<string>  entries;
+
+    pDir = opendir("/dev/input");
+    if (!pDir)
+        return false;
+
+    // OIS opens the gamepads through their event devices, whose nodes are created
+    // again (with another inode) when a device is plugged
+    while ((pEntry = readdir(pDir)) != 0)
+    {
+        if (strncmp(pEntry->d_name, "event", 5) != 0)
+            continue;
+
+        string strPath = string("/dev/input/") + pEntry->d_name;
+        if (stat(strPath.c_str(), &infos) == 0)
+            entries.push_back(strPath + "@" + StringConverter::toString((unsigned long) infos.st_ino));
+    }
+
+    closedir(pDir);
+
+    std::sort(entries.begin(), entries.end());
+
+    for (vector<string>::iterator iter = entries.begin(); iter != entries.end(); ++iter)
+        strSignature += *iter + ";";
+
+    return true;
+#else
+    return false;
+#endif
+}
+
+
+/****************************** CONSTRUCTION / DESTRUCTION *****************************/
+
+GamepadsWatcher::GamepadsWatcher(void* mainWindowHandle,
+                                 const std::vector<tKnownDevice>& known,
+                                 unsigned int uiInterval)
+: m_mainWindowHandle(mainWindowHandle), m_uiInterval(uiInterval), m_known(known),
+  m_bSignatureValid(false), m_bStop(false)
+{
+}
+
+//-----------------------------------------------------------------------
+
+GamepadsWatcher::~GamepadsWatcher()
+{
+    // Declarations
+    vector<tDevice>::iterator           iter, iterEnd;
+    vector<OIS::InputManager*>          managers;
+    vector<OIS::InputManager*>::iterator iterManager, iterManagerEnd;
+
+    stop();
+
+    // Destroy the gamepads that weren't retrieved
+    for (iter = m_added.begin(), iterEnd = m_added.end(); iter != iterEnd; ++iter)
+    {
+        iter->pManager->destroyInputObject(iter->pJoyStick);
+
+        if (std::find(managers.begin(), managers.end(), iter->pManager) == managers.end())
+            managers.push_back(iter->pManager);
+    }
+
+    for (iterManager = managers.begin(), iterManagerEnd = managers.end();
+         iterManager != iterManagerEnd; ++iterManager)
+    {
+        OIS::InputManager::destroyInputSystem(*iterManager);
+    }
+}
+
+
+/************************************** METHODS ****************************************/
+
+void GamepadsWatcher::stop()
+{
+    m_mutex.lock();
+    m_bStop = true;
+    m_mutex.unlock();
+
+    join();
+}
+
+//-----------------------------------------------------------------------
+
+bool GamepadsWatcher::retrieveChanges(std::vector<tDevice> &added,
+                                      std::vector<std::string> &removed)
+{
+    // Never wait for the background thread
+    if (!m_mutex.tryLock())
+        return false;
+
+    bool bChanges = !m_added.empty() || !m_removed.empty();
+
+    if (bChanges)
+    {
+        added.insert(added.end(), m_added.begin(), m_added.end());
+        removed.insert(removed.end(), m_removed.begin(), m_removed.end());
+
+        m_added.clear();
+        m_removed.clear();
+    }
+
+    m_mutex.unlock();
+
+    return bChanges;
+}
+
+//-----------------------------------------------------------------------
+
+std::string GamepadsWatcher::getIdentity(const std::string& strVendor, unsigned int uiOrdinal)
+{
+    return strVendor + "#" + StringConverter::toString(uiOrdinal);
+}
+
+//-----------------------------------------------------------------------
+
+std::string GamepadsWatcher::getDeviceKey(const OIS::Object* pObject)
+{
+    return pObject->vendor() + "@" + StringConverter::toString(pObject->getID());
+}
+
+
+/******************************** IMPLEMENTATION OF THREAD ******************************/
+
+void GamepadsWatcher::run()
+{
+    while (true)
+    {
+        scan();
+
+        for (unsigned int uiElapsed = 0; uiElapsed < m_uiInterval; uiElapsed += SLEEP_GRANULARITY)
+        {
+            m_mutex.lock();
+            bool bStop = m_bStop;
+            m_mutex.unlock();
+
+            if (bStop)
+                return;
+
+            Thread::sleep(SLEEP_GRANULARITY);
+        }
+    }
+}
+
+
+/*********************************** INTERNAL METHODS **********************************/
+
+void GamepadsWatcher::scan()
+{
+    // Declarations
+    OIS::InputManager*                  pManager;
+    OIS::DeviceList                     devices;
+    OIS::DeviceList::iterator           iter, iterEnd;
+    vector<tKnownDevice>                current;
+    vector<tKnownDevice>::iterator      iterKnown, iterKnownEnd, iterCurrent, iterCurrentEnd;
+    vector<OIS::Object*>                unknown;
+    vector<tDevice>                     added;
+    vector<string>                      removed;
+    vector<OIS::Object*>                opened;
+    vector<OIS::Object*>                unneeded;
+    vector<OIS::Object*>::iterator      iterObject, iterObjectEnd;
+    string                              strSignature;
+    bool                                bFailed = false;
+
+    // The enumeration opens every gamepad: only do it when the list of the input
+    // devices changed since the last successful one (the signature is retrieved
+    // before it, so a change during the enumeration is seen at the next scan)
+    bool bSignature = getDevicesSignature(strSignature);
+    if (bSignature && m_bSignatureValid && (strSignature == m_strSignature))
+        return;
+
+    // Enumerate the gamepads, using a new input manager (the enumeration is only done
+    // at the creation of a manager)
+    try
+    {
+        pManager = OIS::InputManager::createInputSystem((size_t) m_mainWindowHandle);
+    }
+    catch (...)
+    {
+        return;
+    }
+
+    if (!pManager)
+        return;
+
+    devices = pManager->listFreeDevices();
+
+    for (iter = devices.begin(), iterEnd = devices.end(); iter != iterEnd; ++iter)
+    {
+        if (iter->first != OIS::OISJoyStick)
+            continue;
+
+        // The manager opens the gamepads with the same name in order, so the known
+        // ones must be opened too (they are closed at the end of the scan)
+        OIS::Object* pObject = 0;
+        try
+        {
+            pObject = pManager->createInputObject(OIS::OISJoyStick, true, iter->second);
+        }
+        catch (...)
+        {
+        }
+
+        // Without its device key, a known gamepad would be seen as unplugged: retry at
+        // the next scan
+        if (!pObject)
+        {
+            bFailed = true;
+            break;
+        }
+
+        opened.push_back(pObject);
+
+        string strDeviceKey = getDeviceKey(pObject);
+
+        for (iterKnown = m_known.begin(), iterKnownEnd = m_known.end(); iterKnown != iterKnownEnd; ++iterKnown)
+        {
+            if (iterKnown->strDeviceKey == strDeviceKey)
+                break;
+        }
+
+        if (iterKnown != iterKnownEnd)
+        {
+            current.push_back(*iterKnown);
+            unneeded.push_back(pObject);
+        }
+        else
+        {
+            unknown.push_back(pObject);
+        }
+    }
+
+    if (bFailed)
+    {
+        for (iterObject = opened.begin(), iterObjectEnd = opened.end();
+             iterObject != iterObjectEnd; ++iterObject)
+        {
+            pManager->destroyInputObject(*iterObject);
+        }
+
+        OIS::InputManager::destroyInputSystem(pManager);
+        return;
+    }
+
+    m_strSignature      = strSignature;
+    m_bSignatureValid   = bSignature;
+
+    // Give to each new gamepad the lowest identity not used by a plugged gamepad with
+    // the same name (the one of a gamepad unplugged before, so it is rebound)
+    for (iterObject = unknown.begin(), iterObjectEnd = unknown.end();
+         iterObject != iterObjectEnd; ++iterObject)
+    {
+        tKnownDevice known;
+        known.strDeviceKey = getDeviceKey(*iterObject);
+
+        for (unsigned int uiOrdinal = 0; ; ++uiOrdinal)
+        {
+            known.strIdentity = getIdentity((*iterObject)->vendor(), uiOrdinal);
+
+            for (iterCurrent = current.begin(), iterCurrentEnd = current.end();
+                 iterCurrent != iterCurrentEnd; ++iterCurrent)
+            {
+                if (iterCurrent->strIdentity == known.strIdentity)
+                    break;
+            }
+
+            if (iterCurrent == iterCurrentEnd)
+                break;
+        }
+
+        current.push_back(known);
+
+        tDevice device;
+        device.strIdentity  = known.strIdentity;
+        device.pJoyStick    = static_cast<OIS::JoyStick*>(*iterObject);
+        device.pManager     = pManager;
+
+        added.push_back(device);
+    }
+
+    // Search the gamepads that vanished
+    for (iterKnown = m_known.begin(), iterKnownEnd = m_known.end(); iterKnown != iterKnownEnd; ++iterKnown)
+    {
+        for (iterCurrent = current.begin(), iterCurrentEnd = current.end();
+             iterCurrent != iterCurrentEnd; ++iterCurrent)
+        {
+            if (iterCurrent->strDeviceKey == iterKnown->strDeviceKey)
+                break;
+        }
+
+        if (iterCurrent == iterCurrentEnd)
+            removed.push_back(iterKnown->strIdentity);
+    }
+
+    m_known = current;
+
+    // Close the gamepads that were only opened for the enumeration
+    for (iterObject = unneeded.begin(), iterObjectEnd = unneeded.end();
+         iterObject != iterObjectEnd; ++iterObject)
+    {
+        pManager->destroyInputObject(*iterObject);
+    }
+
+    // The manager is only kept if it owns some new gamepads
+    if (added.empty())
+        OIS::InputManager::destroyInputSystem(pManager);
+
+    if (added.empty() && removed.empty())
+        return;
+
+    // Publish the changes
+    ScopedLock lock(m_mutex);
+
+    m_added.insert(m_added.end(), added.begin(), added.end());
+    m_removed.insert(m_removed.end(), removed.begin(), removed.end());
+}
@@ -0,0 +1,315 @@
+/** @file   InputHistory.cpp
+    @author Philip Abbet
+
+    Implementation of the class 'Athena::Inputs::InputHistory'
+*/
+
+#include <Athena-Inputs/InputHistory.h>
+#include <Athena-Inputs/VirtualController.h>
+#include <string.h>
+
+
+using namespace Athena;
+using namespace Athena::Inputs;
+using namespace std;
+
+
+/************************************** CONSTANTS **************************************/
+
+/// Indicates that a frame isn't in the history, or that a virtual ID isn't in the frames
+static const unsigned int NO_SLOT = 0xFFFFFFFF;
+
+
+/****************************** CONSTRUCTION / DESTRUCTION *****************************/
+
+InputHistory::InputHistory(VirtualController* pVirtualController, unsigned int uiNbFrames)
+: m_pVirtualController(pVirtualController), m_uiNbFrames(uiNbFrames), m_uiNbKeyWords(0)
+{
+    // Assertions
+    assert(pVirtualController);
+    assert(uiNbFrames > 0);
+
+    rebuild();
+}
+
+//-----------------------------------------------------------------------
+
+InputHistory::~InputHistory()
+{
+}
+
+
+/************************************** METHODS ****************************************/
+
+void InputHistory::rebuild()
+{
+    // Declarations
+    tVirtualID      virtualID;
+    unsigned int    i;
+
+    m_keys.clear();
+    m_axes.clear();
+    m_povs.clear();
+    m_keyIndices.clear();
+    m_axisIndices.clear();
+    m_povIndices.clear();
+
+    // Compute the layout of the frames
+    for (i = 0; i < m_pVirtualController->getNbVirtualKeys(); ++i)
+    {
+        m_pVirtualController->getVirtualKey(i, virtualID);
+
+        if (virtualID >= m_keyIndices.size())
+            m_keyIndices.resize(virtualID + 1, NO_SLOT);
+
+        m_keyIndices[virtualID] = (unsigned int) m_keys.size();
+        m_keys.push_back(m_pVirtualController->getVirtualKey(virtualID));
+    }
+
+    for (i = 0; i < m_pVirtualController->getNbVirtualAxes(); ++i)
+    {
+        m_pVirtualController->getVirtualAxis(i, virtualID);
+
+        if (virtualID >= m_axisIndices.size())
+            m_axisIndices.resize(virtualID + 1, NO_SLOT);
+
+        m_axisIndices[virtualID] = (unsigned int) m_axes.size();
+        m_axes.push_back(m_pVirtualController->getVirtualAxis(virtualID));
+    }
+
+    for (i = 0; i < m_pVirtualController->getNbVirtualPOVs(); ++i)
+    {
+        m_pVirtualController->getVirtualPOV(i, virtualID);
+
+        if (virtualID >= m_povIndices.size())
+            m_povIndices.resize(virtualID + 1, NO_SLOT);
+
+        m_povIndices[virtualID] = (unsigned int) m_povs.size();
+        m_povs.push_back(m_pVirtualController->getVirtualPOV(virtualID));
+    }
+
+    m_uiNbKeyWords = ((unsigned int) m_keys.size() + 31) / 32;
+
+    // Allocate the ring
+    m_frameNumbers.assign(m_uiNbFrames, 0);
+    m_validSlots.assign(m_uiNbFrames, false);
+    m_keyBits.assign(m_uiNbFrames * m_uiNbKeyWords, 0);
+    m_axisValues.assign(m_uiNbFrames * m_axes.size(), 0);
+    m_povPositions.assign(m_uiNbFrames * m_povs.size(), POV_CENTER);
+}
+
+//-----------------------------------------------------------------------
+
+void InputHistory::recordFrame(unsigned long ulFrame)
+{
+    // Declarations
+    unsigned int    uiSlot = (unsigned int) (ulFrame % m_uiNbFrames);
+    unsigned int*   pKeyBits = (m_uiNbKeyWords > 0 ? &m_keyBits[uiSlot * m_uiNbKeyWords] : 0);
+    unsigned int    i;
+
+    m_pVirtualController->_validateVirtualParts();
+
+    for (i = 0; i < m_uiNbKeyWords; ++i)
+        pKeyBits[i] = 0;
+
+    for (i = 0; i < m_keys.size(); ++i)
+    {
+        if (m_keys[i]->bPressed)
+            pKeyBits[i >> 5] |= (1u << (i & 31));
+    }
+
+    for (i = 0; i < m_axes.size(); ++i)
+        m_axisValues[uiSlot * m_axes.size() + i] = m_axes[i]->iValue;
+
+    for (i = 0; i < m_povs.size(); ++i)
+        m_povPositions[uiSlot * m_povs.size() + i] = m_povs[i]->position;
+
+    m_frameNumbers[uiSlot]  = ulFrame;
+    m_validSlots[uiSlot]    = true;
+}
+
+//-----------------------------------------------------------------------
+
+bool InputHistory::hasFrame(unsigned long ulFrame) const
+{
+    return (getSlot(ulFrame) != NO_SLOT);
+}
+
+//-----------------------------------------------------------------------
+
+bool InputHistory::restoreFrame(unsigned long ulFrame)
+{
+    // Declarations
+    unsigned int    uiSlot = getSlot(ulFrame);
+    unsigned int    i;
+
+    if (uiSlot == NO_SLOT)
+        return false;
+
+    m_pVirtualController->_validateVirtualParts();
+
+    // The modified virtual parts must be reset at the beginning of the next frame
+    m_pVirtualController->_markAllPartsDirty();
+
+    for (i = 0; i < m_keys.size(); ++i)
+    {
+        bool bPressed = ((m_keyBits[uiSlot * m_uiNbKeyWords + (i >> 5)] >> (i & 31)) & 1) != 0;
+        m_pVirtualController->_setKeyState(m_keys[i], bPressed);
+    }
+
+    for (i = 0; i < m_axes.size(); ++i)
+        m_pVirtualController->_setAxisValue(m_axes[i], m_axisValues[uiSlot * m_axes.size() + i]);
+
+    for (i = 0; i < m_povs.size(); ++i)
+        m_pVirtualController->_setPOVPosition(m_povs[i], m_povPositions[uiSlot * m_povs.size() + i]);
+
+    // The conditioned values of the axes must match their restored values
+    m_pVirtualController->_conditionAxes();
+
+    return true;
+}
+
+//-----------------------------------------------------------------------
+
+bool InputHistory::compareFrames(unsigned long ulFrame1, unsigned long ulFrame2) const
+{
+    // Declarations
+    unsigned int uiSlot1 = getSlot(ulFrame1);
+    unsigned int uiSlot2 = getSlot(ulFrame2);
+
+    if ((uiSlot1 == NO_SLOT) || (uiSlot2 == NO_SLOT))
+        return false;
+
+    if ((m_uiNbKeyWords > 0) &&
+        (memcmp(&m_keyBits[uiSlot1 * m_uiNbKeyWords], &m_keyBits[uiSlot2 * m_uiNbKeyWords],
+                m_uiNbKeyWords * sizeof(unsigned int)) != 0))
+    {
+        return false;
+    }
+
+    if (!m_axes.empty() &&
+        (memcmp(&m_axisValues[uiSlot1 * m_axes.size()], &m_axisValues[uiSlot2 * m_axes.size()],
+                m_axes.size() * sizeof(int)) != 0))
+    {
+        return false;
+    }
+
+    if (!m_povs.empty() &&
+        (memcmp(&m_povPositions[uiSlot1 * m_povs.size()], &m_povPositions[uiSlot2 * m_povs.size()],
+                m_povs.size() * sizeof(tPOVPosition)) != 0))
+    {
+        return false;
+    }
+
+    return true;
+}
+
+//-----------------------------------------------------------------------
+
+bool InputHistory::compareFrame(unsigned long ulFrame) const
+{
+    // Declarations
+    unsigned int    uiSlot = getSlot(ulFrame);
+    unsigned int    i;
+
+    if (uiSlot == NO_SLOT)
+        return false;
+
+    m_pVirtualController->_validateVirtualParts();
+
+    for (i = 0; i < m_keys.size(); ++i)
+    {
+        bool bPressed = ((m_keyBits[uiSlot * m_uiNbKeyWords + (i >> 5)] >> (i & 31)) & 1) != 0;
+        if (m_keys[i]->bPressed != bPressed)
+            return false;
+    }
+
+    for (i = 0; i < m_axes.size(); ++i)
+    {
+        if (m_axes[i]->iValue != m_axisValues[uiSlot * m_axes.size() + i])
+            return false;
+    }
+
+    for (i = 0; i < m_povs.size(); ++i)
+    {
+        if (m_povs[i]->position != m_povPositions[uiSlot * m_povs.size() + i])
+            return false;
+    }
+
+    return true;
+}
+
+//-----------------------------------------------------------------------
+
+bool InputHistory::patchKey(unsigned long ulFrame, tVirtualID virtualKey, bool bPressed)
+{
+    // Declarations
+    unsigned int uiSlot = getSlot(ulFrame);
+
+    if ((uiSlot == NO_SLOT) || (virtualKey >= m_keyIndices.size()) || (m_keyIndices[virtualKey] == NO_SLOT))
+        return false;
+
+    unsigned int    uiIndex = m_keyIndices[virtualKey];
+    unsigned int&   uiWord  = m_keyBits[uiSlot * m_uiNbKeyWords + (uiIndex >> 5)];
+    unsigned int    uiBit   = (1u << (uiIndex & 31));
+
+    if (((uiWord & uiBit) != 0) == bPressed)
+        return false;
+
+    uiWord ^= uiBit;
+
+    return true;
+}
+
+//-----------------------------------------------------------------------
+
+bool InputHistory::patchAxis(unsigned long ulFrame, tVirtualID virtualAxis, int iValue)
+{
+    // Declarations
+    unsigned int uiSlot = getSlot(ulFrame);
+
+    if ((uiSlot == NO_SLOT) || (virtualAxis >= m_axisIndices.size()) || (m_axisIndices[virtualAxis] == NO_SLOT))
+        return false;
+
+    int& iStoredValue = m_axisValues[uiSlot * m_axes.size() + m_axisIndices[virtualAxis]];
+
+    if (iStoredValue == iValue)
+        return false;
+
+    iStoredValue = iValue;
+
+    return true;
+}
+
+//-----------------------------------------------------------------------
+
+bool InputHistory::patchPOV(unsigned long ulFrame, tVirtualID virtualPOV, tPOVPosition position)
+{
+    // Declarations
+    unsigned int uiSlot = getSlot(ulFrame);
+
+    if ((uiSlot == NO_SLOT) || (virtualPOV >= m_povIndices.size()) || (m_povIndices[virtualPOV] == NO_SLOT))
+        return false;
+
+    tPOVPosition& storedPosition = m_povPositions[uiSlot * m_povs.size() + m_povIndices[virtualPOV]];
+
+    if (storedPosition == position)
+        return false;
+
+    storedPosition = position;
+
+    return true;
+}
+
+
+/*********************************** INTERNAL METHODS **********************************/
+
+unsigned int InputHistory::getSlot(unsigned long ulFrame) const
+{
+    unsigned int uiSlot = (unsigned int) (ulFrame % m_uiNbFrames);
+
+    if (!m_validSlots[uiSlot] || (m_frameNumbers[uiSlot] != ulFrame))
+        return NO_SLOT;
+
+    return uiSlot;
+}
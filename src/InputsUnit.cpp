@@ -7,13 +7,21 @@
 #include <Athena-Inputs/InputsUnit.h>
 #include <Athena-Inputs/Keyboard.h>
 #include <Athena-Inputs/Mouse.h>
+#include <Athena-Inputs/Gamepad.h>
+#include <Athena-Inputs/RemoteController.h>
+#include <Athena-Inputs/Tracing.h>
 #include <Athena-Core/Log/LogManager.h>
 #include <Athena-Core/Utils/StringConverter.h>
 #include <OIS/OISInputManager.h>
 #include <OIS/OISKeyboard.h>
 #include <OIS/OISMouse.h>
+#include <rapidjson/prettywriter.h>
+#include <rapidjson/stringbuffer.h>
 // #include <tinyxml.h>
 #include <sstream>
+#include <fstream>
+#include <algorithm>
+#include <set>
 
 using namespace Athena;
 using namespace Athena::Inputs;
@@ -41,9 +49,19 @@ namespace Athena {
 /****************************** CONSTRUCTION / DESTRUCTION *****************************/
 
 InputsUnit::InputsUnit()
-: m_pManager(0), m_uiNbGamepads(0)
+: m_pManager(0), m_mainWindowHandle(0), m_controllersArena(4 * sizeof(VirtualController)),
+  m_uiNbGamepads(0), m_pGamepadsWatcher(0), m_pRemoteEvents(0), m_uiLastStatsController(0)
 {
     ATHENA_LOG_EVENT("Creation");
+
+    m_stats.ulNbFrames              = 0;
+    m_stats.ulNbLostRemoteEvents    = 0;
+    m_stats.ulCaptureTime           = 0;
+    m_stats.ulProcessTime           = 0;
+    m_stats.ulTotalCaptureTime      = 0;
+    m_stats.ulTotalProcessTime      = 0;
+    m_stats.uiQueueDepth            = 0;
+    m_stats.uiPeakQueueDepth        = 0;
 }
 
 //-----------------------------------------------------------------------
@@ -52,6 +70,9 @@ InputsUnit::~InputsUnit()
 {
     ATHENA_LOG_EVENT("Destruction");
 
+    // Stop the detection of the gamepads
+    enableHotPlug(false);
+
     ATHENA_LOG_EVENT("Destruction of the virtual controllers");
 
     // Destroy the virtual controllers
@@ -68,12 +89,23 @@ InputsUnit::~InputsUnit()
         _removeController(m_controllers.front());
     }
 
+    // Disconnect from the capture daemon
+    m_remoteControllers.clear();
+    delete m_pRemoteEvents;
+
     // Destroy the virtual IDs
     m_virtualIDs.clear();
 
     // Destroy the shortcuts
     m_shortcuts.clear();
 
+    // Destroy the input managers of the gamepads plugged during the session
+    for (vector<OIS::InputManager*>::iterator iter = m_hotPlugManagers.begin();
+         iter != m_hotPlugManagers.end(); ++iter)
+    {
+        OIS::InputManager::destroyInputSystem(*iter);
+    }
+
     // Destroy the controller manager
     OIS::InputManager::destroyInputSystem(m_pManager);
 }
@@ -100,6 +132,8 @@ bool InputsUnit::init(void* mainWindowHandle)
 {
     ATHENA_LOG_EVENT("Initialization");
 
+    m_mainWindowHandle = mainWindowHandle;
+
     m_pManager = OIS::InputManager::createInputSystem((size_t) mainWindowHandle);
     if (!m_pManager)
     {
@@ -113,10 +147,20 @@ bool InputsUnit::init(void* mainWindowHandle)
     _addController(new Keyboard(pKeyboard));
     _addController(new Mouse(pMouse));
 
-    for (int i = 0; i < m_pManager->getNumberOfDevices(OIS::OISJoyStick); ++i)
+    OIS::DeviceList devices = m_pManager->listFreeDevices();
+    map<string, unsigned int> ordinals;
+
+    for (OIS::DeviceList::iterator iter = devices.begin(); iter != devices.end(); ++iter)
     {
-        OIS::JoyStick* pJoyStick = static_cast<OIS::JoyStick*>(m_pManager->createInputObject(OIS::OISJoyStick, true));
-        // _addController(pJoyStick);
+        if (iter->first != OIS::OISJoyStick)
+            continue;
+
+        OIS::JoyStick* pJoyStick = static_cast<OIS::JoyStick*>(m_pManager->createInputObject(OIS::OISJoyStick, true, iter->second));
+
+        Gamepad* pGamepad = new Gamepad(pJoyStick, getFreeGamepadIndex());
+        pGamepad->setIdentity(GamepadsWatcher::getIdentity(iter->second, ordinals[iter->second]++));
+
+        _addController(pGamepad);
     }
 
     return true;
@@ -124,18 +168,255 @@ bool InputsUnit::init(void* mainWindowHandle)
 
 //-----------------------------------------------------------------------
 
+bool InputsUnit::connect(const std::string& strRingName)
+{
+    // Assertions
+    assert(!m_pRemoteEvents);
+
+    ATHENA_LOG_EVENT("Connection to the capture daemon '" + strRingName + "'");
+
+    m_pRemoteEvents = new SharedEventsRing();
+    if (!m_pRemoteEvents->open(strRingName))
+    {
+        ATHENA_LOG_ERROR("Failed to open the shared events ring '" + strRingName + "'");
+
+        delete m_pRemoteEvents;
+        m_pRemoteEvents = 0;
+        return false;
+    }
+
+    for (unsigned int i = 0; i < m_pRemoteEvents->getNbDevices(); ++i)
+    {
+        RemoteController* pController = new RemoteController(m_pRemoteEvents->getDevice(i));
+
+        m_remoteControllers.push_back(pController);
+        _addController(pController);
+    }
+
+    m_remoteEventsBuffer.resize(m_pRemoteEvents->getCapacity());
+
+    return true;
+}
+
+//-----------------------------------------------------------------------
+
+void InputsUnit::enableHotPlug(bool bEnable, unsigned int uiInterval)
+{
+    // Declarations
+    vector<Controller*>::iterator               iter, iterEnd;
+    vector<GamepadsWatcher::tKnownDevice>       known;
+
+    if (m_pGamepadsWatcher)
+    {
+        ATHENA_LOG_EVENT("Stopping the detection of the gamepads");
+
+        delete m_pGamepadsWatcher;
+        m_pGamepadsWatcher = 0;
+    }
+
+    if (!bEnable || !m_pManager)
+        return;
+
+    ATHENA_LOG_EVENT("Starting the detection of the gamepads");
+
+    for (iter = m_controllers.begin(), iterEnd = m_controllers.end(); iter != iterEnd; ++iter)
+    {
+        if ((*iter)->getType() != OIS::OISJoyStick)
+            continue;
+
+        GamepadsWatcher::tKnownDevice device;
+        device.strIdentity  = (*iter)->getIdentity();
+        device.strDeviceKey = GamepadsWatcher::getDeviceKey(static_cast<Gamepad*>(*iter)->getOISJoyStick());
+
+        known.push_back(device);
+    }
+
+    m_pGamepadsWatcher = new GamepadsWatcher(m_mainWindowHandle, known, uiInterval);
+    if (!m_pGamepadsWatcher->start())
+    {
+        ATHENA_LOG_ERROR("Failed to start the detection of the gamepads");
+
+        delete m_pGamepadsWatcher;
+        m_pGamepadsWatcher = 0;
+    }
+}
+
+//-----------------------------------------------------------------------
+
+void InputsUnit::processHotPlug()
+{
+    // Declarations
+    vector<GamepadsWatcher::tDevice>::iterator      iterDevice, iterDeviceEnd;
+    vector<string>::iterator                        iterIdentity, iterIdentityEnd;
+    vector<Controller*>::iterator                   iter, iterEnd;
+    map<string, VirtualController*>::iterator       iterVC, iterVCEnd;
+    tDetachedBindingsList::iterator                 iterDetached;
+    vector<tDetachedBindings>::iterator             iterBindings, iterBindingsEnd;
+
+    if (!m_pGamepadsWatcher->retrieveChanges(m_pluggedGamepads, m_unpluggedGamepads))
+        return;
+
+    // Remove the vanished gamepads, after having detached the virtual parts bound to
+    // them
+    for (iterIdentity = m_unpluggedGamepads.begin(), iterIdentityEnd = m_unpluggedGamepads.end();
+         iterIdentity != iterIdentityEnd; ++iterIdentity)
+    {
+        Controller* pController = 0;
+
+        for (iter = m_controllers.begin(), iterEnd = m_controllers.end(); iter != iterEnd; ++iter)
+        {
+            if (((*iter)->getType() == OIS::OISJoyStick) && ((*iter)->getIdentity() == *iterIdentity))
+            {
+                pController = *iter;
+                break;
+            }
+        }
+
+        if (!pController)
+            continue;
+
+        ATHENA_LOG_EVENT("Gamepad '" + *iterIdentity + "' unplugged");
+
+        vector<tDetachedBindings>& detached = m_detachedBindings[*iterIdentity];
+
+        for (iterVC = m_virtualControllers.begin(), iterVCEnd = m_virtualControllers.end();
+             iterVC != iterVCEnd; ++iterVC)
+        {
+            tDetachedBindings bindings;
+            bindings.pVirtualController = iterVC->second;
+
+            iterVC->second->_detachController(pController, bindings.parts);
+
+            if (!bindings.parts.empty())
+                detached.push_back(bindings);
+        }
+
+        // Discard the events of the gamepad not processed yet
+        for (deque<tInputEvent>::iterator iterEvent = m_events.begin(); iterEvent != m_events.end(); )
+        {
+            if (iterEvent->pController == pController)
+                iterEvent = m_events.erase(iterEvent);
+            else
+                ++iterEvent;
+        }
+
+        _removeController(pController);
+    }
+
+    // Add the new gamepads, and bind them to the virtual parts detached from a gamepad
+    // with the same identity
+    for (iterDevice = m_pluggedGamepads.begin(), iterDeviceEnd = m_pluggedGamepads.end();
+         iterDevice != iterDeviceEnd; ++iterDevice)
+    {
+        ATHENA_LOG_EVENT("Gamepad '" + iterDevice->strIdentity + "' plugged");
+
+        if (std::find(m_hotPlugManagers.begin(), m_hotPlugManagers.end(), iterDevice->pManager) == m_hotPlugManagers.end())
+            m_hotPlugManagers.push_back(iterDevice->pManager);
+
+        Gamepad* pGamepad = new Gamepad(iterDevice->pJoyStick, getFreeGamepadIndex());
+        pGamepad->setIdentity(iterDevice->strIdentity);
+
+        _addController(pGamepad);
+
+        iterDetached = m_detachedBindings.find(iterDevice->strIdentity);
+        if (iterDetached != m_detachedBindings.end())
+        {
+            for (iterBindings = iterDetached->second.begin(), iterBindingsEnd = iterDetached->second.end();
+                 iterBindings != iterBindingsEnd; ++iterBindings)
+            {
+                iterBindings->pVirtualController->_attachController(pGamepad, iterBindings->parts);
+            }
+
+            m_detachedBindings.erase(iterDetached);
+        }
+    }
+
+    m_pluggedGamepads.clear();
+    m_unpluggedGamepads.clear();
+}
+
+//-----------------------------------------------------------------------
+
+unsigned int InputsUnit::getFreeGamepadIndex() const
+{
+    // Declarations
+    vector<Controller*>::const_iterator iter, iterEnd;
+    unsigned int                        uiIndex;
+
+    for (uiIndex = 1; ; ++uiIndex)
+    {
+        for (iter = m_controllers.begin(), iterEnd = m_controllers.end(); iter != iterEnd; ++iter)
+        {
+            if (((*iter)->getType() == OIS::OISJoyStick) && ((*iter)->getIndex() == uiIndex))
+                break;
+        }
+
+        if (iter == iterEnd)
+            return uiIndex;
+    }
+}
+
+//-----------------------------------------------------------------------
+
+void InputsUnit::processRemoteEvents()
+{
+    // Declarations
+    unsigned int uiNbEvents;
+    unsigned int i;
+
+    do
+    {
+        uiNbEvents = m_pRemoteEvents->read(&m_remoteEventsBuffer[0], (unsigned int) m_remoteEventsBuffer.size());
+
+        for (i = 0; i < uiNbEvents; ++i)
+        {
+            const SharedEventsRing::tEvent& event = m_remoteEventsBuffer[i];
+
+            if (event.device >= m_remoteControllers.size())
+                continue;
+
+            RemoteController* pController = m_remoteControllers[event.device];
+            if (pController->isActive())
+                pController->_fireEvent(event);
+        }
+    }
+    while (uiNbEvents == m_remoteEventsBuffer.size());
+}
+
+//-----------------------------------------------------------------------
+
 void InputsUnit::process()
 {
     // Declarations
     vector<Controller*>::iterator             iter, iterEnd;
     map<string, VirtualController*>::iterator iter2, iterEnd2;
+    unsigned long                             ulStart, ulCaptureEnd;
+
+    ATHENA_INPUTS_TRACE_SCOPE("InputsUnit::process");
+
+    ulStart = Controller::getPreciseTimestamp();
+
+    // Add the gamepads plugged and remove the ones unplugged since the last frame
+    if (m_pGamepadsWatcher)
+        processHotPlug();
 
-    // Read the inputs of all the active controllers
+    // Retrieve the events written by the capture daemon
+    if (m_pRemoteEvents)
+        processRemoteEvents();
+
+    // Read the inputs of all the active controllers (the ones that nothing binds are
+    // deactivated)
     for (iter = m_controllers.begin(), iterEnd = m_controllers.end(); iter != iterEnd; ++iter)
     {
-        (*iter)->capture();
+        if ((*iter)->isActive())
+        {
+            ATHENA_INPUTS_TRACE_SCOPE("Controller::capture");
+            (*iter)->capture();
+        }
     }
 
+    ulCaptureEnd = Controller::getPreciseTimestamp();
+
     // Update the virtual controllers
     for (iter2 = m_virtualControllers.begin(), iterEnd2 = m_virtualControllers.end();
          iter2 != iterEnd2; ++iter2)
@@ -143,11 +424,167 @@ void InputsUnit::process()
         iter2->second->process(m_events);
     }
 
+    updateStats(ulCaptureEnd - ulStart, Controller::getPreciseTimestamp() - ulCaptureEnd);
+
     m_events.clear();
 }
 
 //-----------------------------------------------------------------------
 
+void InputsUnit::updateStats(unsigned long ulCaptureTime, unsigned long ulProcessTime)
+{
+    // Declarations
+    map<string, VirtualController*>::iterator   iter, iterEnd;
+    unsigned int                                i;
+
+    ++m_stats.ulNbFrames;
+
+    m_stats.ulCaptureTime       = ulCaptureTime;
+    m_stats.ulProcessTime       = ulProcessTime;
+    m_stats.ulTotalCaptureTime  += ulCaptureTime;
+    m_stats.ulTotalProcessTime  += ulProcessTime;
+
+    m_stats.uiQueueDepth = (unsigned int) m_events.size();
+    if (m_stats.uiQueueDepth > m_stats.uiPeakQueueDepth)
+        m_stats.uiPeakQueueDepth = m_stats.uiQueueDepth;
+
+    for (i = 0; i < m_stats.controllers.size(); ++i)
+        m_stats.controllers[i].ulNbSuppressedEvents = m_stats.controllers[i].pController->getNbSuppressedEvents();
+
+    m_stats.virtualControllers.resize(m_virtualControllers.size());
+
+    for (iter = m_virtualControllers.begin(), iterEnd = m_virtualControllers.end(), i = 0;
+         iter != iterEnd; ++iter, ++i)
+    {
+        tVirtualControllerStats& stats = m_stats.virtualControllers[i];
+
+        if (stats.strName != iter->first)
+            stats.strName = iter->first;
+
+        stats.ulNbVirtualEvents     = iter->second->getNbVirtualEvents();
+        stats.ulNbCoalescedEvents   = iter->second->getNbCoalescedEvents();
+    }
+
+    if (m_pRemoteEvents)
+        m_stats.ulNbLostRemoteEvents = m_pRemoteEvents->getNbLostEvents();
+}
+
+//-----------------------------------------------------------------------
+
+void InputsUnit::logStats() const
+{
+    // Declarations
+    unsigned int i;
+
+    stringstream str;
+    str << "Statistics after " << m_stats.ulNbFrames << " frames: capture " << m_stats.ulCaptureTime
+        << "us (total: " << m_stats.ulTotalCaptureTime << "us), virtual controllers "
+        << m_stats.ulProcessTime << "us (total: " << m_stats.ulTotalProcessTime << "us), queue depth "
+        << m_stats.uiQueueDepth << " (peak: " << m_stats.uiPeakQueueDepth << ")";
+
+    if (m_pRemoteEvents)
+        str << ", " << m_stats.ulNbLostRemoteEvents << " remote events lost";
+
+    ATHENA_LOG_EVENT(str.str());
+
+    for (i = 0; i < m_stats.controllers.size(); ++i)
+    {
+        const tControllerStats& stats = m_stats.controllers[i];
+
+        str.str("");
+        str << "    Controller '" << stats.pController->getName() << "': " << stats.ulNbKeyEvents
+            << " key events, " << stats.ulNbAxisEvents << " axis events, " << stats.ulNbPOVEvents
+            << " POV events, " << stats.ulNbSuppressedEvents << " suppressed";
+
+        ATHENA_LOG_EVENT(str.str());
+    }
+
+    for (i = 0; i < m_stats.virtualControllers.size(); ++i)
+    {
+        const tVirtualControllerStats& stats = m_stats.virtualControllers[i];
+
+        str.str("");
+        str << "    Virtual controller '" << stats.strName << "': " << stats.ulNbVirtualEvents
+            << " virtual events, " << stats.ulNbCoalescedEvents << " coalesced";
+
+        ATHENA_LOG_EVENT(str.str());
+    }
+}
+
+//-----------------------------------------------------------------------
+
+bool InputsUnit::saveStats(const std::string& strFile) const
+{
+    // Declarations
+    rapidjson::StringBuffer                             buffer;
+    rapidjson::PrettyWriter<rapidjson::StringBuffer>    writer(buffer);
+    unsigned int                                        i;
+
+    writer.StartObject();
+
+    writer.String("frames");            writer.Uint64(m_stats.ulNbFrames);
+    writer.String("captureTime");       writer.Uint64(m_stats.ulCaptureTime);
+    writer.String("processTime");       writer.Uint64(m_stats.ulProcessTime);
+    writer.String("totalCaptureTime");  writer.Uint64(m_stats.ulTotalCaptureTime);
+    writer.String("totalProcessTime");  writer.Uint64(m_stats.ulTotalProcessTime);
+    writer.String("queueDepth");        writer.Uint(m_stats.uiQueueDepth);
+    writer.String("peakQueueDepth");    writer.Uint(m_stats.uiPeakQueueDepth);
+    writer.String("lostRemoteEvents");  writer.Uint64(m_stats.ulNbLostRemoteEvents);
+
+    writer.String("controllers");
+    writer.StartArray();
+
+    for (i = 0; i < m_stats.controllers.size(); ++i)
+    {
+        const tControllerStats& stats = m_stats.controllers[i];
+        const string& strName = stats.pController->getName();
+
+        writer.StartObject();
+        writer.String("name");              writer.String(strName.c_str(), (rapidjson::SizeType) strName.size());
+        writer.String("type");              writer.Int((int) stats.pController->getType());
+        writer.String("index");             writer.Uint(stats.pController->getIndex());
+        writer.String("keyEvents");         writer.Uint64(stats.ulNbKeyEvents);
+        writer.String("axisEvents");        writer.Uint64(stats.ulNbAxisEvents);
+        writer.String("povEvents");         writer.Uint64(stats.ulNbPOVEvents);
+        writer.String("suppressedEvents");  writer.Uint64(stats.ulNbSuppressedEvents);
+        writer.EndObject();
+    }
+
+    writer.EndArray();
+
+    writer.String("virtualControllers");
+    writer.StartArray();
+
+    for (i = 0; i < m_stats.virtualControllers.size(); ++i)
+    {
+        const tVirtualControllerStats& stats = m_stats.virtualControllers[i];
+
+        writer.StartObject();
+        writer.String("name");              writer.String(stats.strName.c_str(), (rapidjson::SizeType) stats.strName.size());
+        writer.String("virtualEvents");     writer.Uint64(stats.ulNbVirtualEvents);
+        writer.String("coalescedEvents");   writer.Uint64(stats.ulNbCoalescedEvents);
+        writer.EndObject();
+    }
+
+    writer.EndArray();
+
+    writer.EndObject();
+
+    // Save the document
+    ofstream file(strFile.c_str());
+    if (!file.is_open())
+    {
+        ATHENA_LOG_ERROR("Failed to save the statistics in the file '" + strFile + "'");
+        return false;
+    }
+
+    file << buffer.GetString() << endl;
+
+    return file.good();
+}
+
+//-----------------------------------------------------------------------
+
 // void InputsUnit::scan(IEventsListener* pListener)
 // {
 //     // Declarations
@@ -172,6 +609,39 @@ void InputsUnit::process()
 
 void InputsUnit::onEvent(tInputEvent* pEvent)
 {
+    // Declarations
+    unsigned int i;
+
+    // Count the event (the events of a frame usually come from a few controllers)
+    if ((m_uiLastStatsController >= m_stats.controllers.size()) ||
+        (m_stats.controllers[m_uiLastStatsController].pController != pEvent->pController))
+    {
+        for (i = 0; i < m_stats.controllers.size(); ++i)
+        {
+            if (m_stats.controllers[i].pController == pEvent->pController)
+            {
+                m_uiLastStatsController = i;
+                break;
+            }
+        }
+    }
+
+    if (m_uiLastStatsController < m_stats.controllers.size())
+    {
+        tControllerStats& stats = m_stats.controllers[m_uiLastStatsController];
+
+        if (stats.pController == pEvent->pController)
+        {
+            switch (pEvent->part)
+            {
+                case PART_KEY:  ++stats.ulNbKeyEvents; break;
+                case PART_AXIS: ++stats.ulNbAxisEvents; break;
+                case PART_POV:  ++stats.ulNbPOVEvents; break;
+                default:        break;
+            }
+        }
+    }
+
     // Push the event in the list
     m_events.push_back(*pEvent);
 }
@@ -223,7 +693,18 @@ void InputsUnit::_addController(Controller* pController)
 
     m_controllers.push_back(pController);
 
+    tControllerStats stats;
+    stats.pController           = pController;
+    stats.ulNbKeyEvents         = 0;
+    stats.ulNbAxisEvents        = 0;
+    stats.ulNbPOVEvents         = 0;
+    stats.ulNbSuppressedEvents  = 0;
+    m_stats.controllers.push_back(stats);
+
     pController->registerListener(this);
+
+    // The controller is only captured once a virtual part is bound to it
+    _updateActivation(pController);
 }
 
 //-----------------------------------------------------------------------
@@ -231,7 +712,8 @@ void InputsUnit::_addController(Controller* pController)
 void InputsUnit::_removeController(Controller* pController)
 {
     // Declarations
-    std::vector<Controller*>::iterator iter, iterEnd;
+    std::vector<Controller*>::iterator      iter, iterEnd;
+    std::vector<tControllerStats>::iterator iterStats, iterStatsEnd;
 
     if (pController->getType() == OIS::OISJoyStick)
         --m_uiNbGamepads;
@@ -247,9 +729,98 @@ void InputsUnit::_removeController(Controller* pController)
         }
     }
 
+    for (iterStats = m_stats.controllers.begin(), iterStatsEnd = m_stats.controllers.end();
+         iterStats != iterStatsEnd; ++iterStats)
+    {
+        if (iterStats->pController == pController)
+        {
+            m_stats.controllers.erase(iterStats);
+            break;
+        }
+    }
+
+    m_bindings.erase(pController);
+
     delete pController;
 }
 
+//-----------------------------------------------------------------------
+
+void InputsUnit::_retainController(Controller* pController)
+{
+    // Assertions
+    assert(pController);
+
+    unsigned int& uiNbBindings = m_bindings[pController];
+
+    if (uiNbBindings++ == 0)
+        _updateActivation(pController);
+}
+
+//-----------------------------------------------------------------------
+
+void InputsUnit::_releaseController(Controller* pController)
+{
+    // Assertions
+    assert(pController);
+
+    // Declarations
+    map<Controller*, unsigned int>::iterator iter;
+
+    iter = m_bindings.find(pController);
+    if (iter == m_bindings.end())
+        return;
+
+    if (--iter->second == 0)
+    {
+        m_bindings.erase(iter);
+        _updateActivation(pController);
+    }
+}
+
+//-----------------------------------------------------------------------
+
+void InputsUnit::_updateActivation(Controller* pController)
+{
+    // Assertions
+    assert(pController);
+
+    // Only the controllers of the unit are managed
+    if (std::find(m_controllers.begin(), m_controllers.end(), pController) == m_controllers.end())
+        return;
+
+    // The unit is one of the listeners of its controllers
+    bool bNeeded = (getNbBindings(pController) > 0) || (pController->getNbListeners() > 1);
+
+    if (bNeeded == pController->isActive())
+        return;
+
+    if (bNeeded)
+    {
+        ATHENA_LOG_EVENT("Activation of the controller '" + pController->getName() + "'");
+    }
+    else
+    {
+        ATHENA_LOG_EVENT("Deactivation of the controller '" + pController->getName() + "'");
+    }
+
+    pController->activate(bNeeded);
+}
+
+//-----------------------------------------------------------------------
+
+unsigned int InputsUnit::getNbBindings(Controller* pController) const
+{
+    // Declarations
+    map<Controller*, unsigned int>::const_iterator iter;
+
+    iter = m_bindings.find(pController);
+    if (iter != m_bindings.end())
+        return iter->second;
+    else
+        return 0;
+}
+
 
 /************************** MANAGEMENT OF THE VIRTUAL CONTROLLERS **********************/
 
@@ -265,7 +836,7 @@ VirtualController* InputsUnit::createVirtualController(const std::string& strNam
         return 0;
     }
 
-    pController = new VirtualController();
+    pController = new (m_controllersArena.allocate(sizeof(VirtualController))) VirtualController();
 
     m_virtualControllers[strName] = pController;
 
@@ -315,7 +886,8 @@ void InputsUnit::destroyVirtualController(const std::string& strName)
     {
         if (iter->first == strName)
         {
-            delete iter->second;
+            forgetDetachedBindings(iter->second);
+            deleteVirtualController(iter->second);
             m_virtualControllers.erase(iter);
             break;
         }
@@ -334,7 +906,8 @@ void InputsUnit::destroyVirtualController(VirtualController* pVirtualController)
     {
         if (iter->second == pVirtualController)
         {
-            delete pVirtualController;
+            forgetDetachedBindings(pVirtualController);
+            deleteVirtualController(pVirtualController);
             m_virtualControllers.erase(iter);
             break;
         }
@@ -343,6 +916,39 @@ void InputsUnit::destroyVirtualController(VirtualController* pVirtualController)
 
 //-----------------------------------------------------------------------
 
+void InputsUnit::deleteVirtualController(VirtualController* pVirtualController)
+{
+    // The memory of the virtual parts is released at once by the destructor
+    pVirtualController->~VirtualController();
+    m_controllersArena.deallocate(pVirtualController, sizeof(VirtualController));
+}
+//-----------------------------------------------------------------------
+
+void InputsUnit::forgetDetachedBindings(VirtualController* pVirtualController)
+{
+    // Declarations
+    tDetachedBindingsList::iterator     iter;
+    vector<tDetachedBindings>::iterator iterBindings;
+
+    for (iter = m_detachedBindings.begin(); iter != m_detachedBindings.end(); )
+    {
+        for (iterBindings = iter->second.begin(); iterBindings != iter->second.end(); )
+        {
+            if (iterBindings->pVirtualController == pVirtualController)
+                iterBindings = iter->second.erase(iterBindings);
+            else
+                ++iterBindings;
+        }
+
+        if (iter->second.empty())
+            m_detachedBindings.erase(iter++);
+        else
+            ++iter;
+    }
+}
+
+//-----------------------------------------------------------------------
+
 bool InputsUnit::registerVirtualID(const std::string& strName, tVirtualID virtualID)
 {
     // Declarations
@@ -396,6 +1002,90 @@ bool InputsUnit::registerVirtualID(const std::string& strName, tVirtualID virtua
 
 //-----------------------------------------------------------------------
 
+unsigned int InputsUnit::registerVirtualIDs(const std::vector<tVirtualIDRegistration>& registrations)
+{
+    // Declarations
+    std::vector<tVirtualIDRegistration>::const_iterator iter, iterEnd;
+    map<std::string, tVirtualID>::iterator              iterID, iterIDEnd, iterHint;
+    map<std::string, tVirtualID>                        accepted;
+    set<tVirtualID>                                     usedIDs;
+    tVirtualID                                          nextID = 1;
+    unsigned int                                        uiNbRejected = 0;
+    string                                              strFirstRejected;
+    stringstream                                        str;
+
+    // Collect the IDs already used, once for the whole list
+    for (iterID = m_virtualIDs.begin(), iterIDEnd = m_virtualIDs.end(); iterID != iterIDEnd; ++iterID)
+    {
+        usedIDs.insert(iterID->second);
+        if (iterID->second >= nextID)
+            nextID = iterID->second + 1;
+    }
+
+    // Validate the registrations
+    for (iter = registrations.begin(), iterEnd = registrations.end(); iter != iterEnd; ++iter)
+    {
+        tVirtualID virtualID = iter->virtualID;
+
+        bool bRejected;
+
+        // Check that the name doesn't already exists (not an error without a supplied ID)
+        if ((m_virtualIDs.find(iter->strName) != m_virtualIDs.end()) ||
+            (accepted.find(iter->strName) != accepted.end()))
+        {
+            if (virtualID == 0)
+                continue;
+
+            bRejected = true;
+        }
+        else
+        {
+            // Check that the supplied ID is free
+            bRejected = (virtualID != 0) && (usedIDs.find(virtualID) != usedIDs.end());
+        }
+
+        if (bRejected)
+        {
+            if (uiNbRejected == 0)
+                strFirstRejected = iter->strName;
+
+            ++uiNbRejected;
+            continue;
+        }
+
+        if (virtualID == 0)
+            virtualID = nextID;
+
+        if (virtualID >= nextID)
+            nextID = virtualID + 1;
+
+        usedIDs.insert(virtualID);
+        accepted[iter->strName] = virtualID;
+    }
+
+    // Add them to the index (sorted by name, each insertion starts from the previous one)
+    iterHint = m_virtualIDs.begin();
+    for (iterID = accepted.begin(), iterIDEnd = accepted.end(); iterID != iterIDEnd; ++iterID)
+        iterHint = m_virtualIDs.insert(iterHint, *iterID);
+
+    str << accepted.size() << " virtual IDs registered";
+
+    if (uiNbRejected > 0)
+    {
+        str << ", " << uiNbRejected << " rejected because their name or ID already exists (first: '"
+            << strFirstRejected << "')";
+        ATHENA_LOG_ERROR(str.str());
+    }
+    else
+    {
+        ATHENA_LOG_EVENT(str.str());
+    }
+
+    return (unsigned int) accepted.size();
+}
+
+//-----------------------------------------------------------------------
+
 tVirtualID InputsUnit::getVirtualID(const std::string& strName)
 {
     // Declarations
@@ -449,6 +1139,55 @@ bool InputsUnit::registerShortcut(const std::string& strShortcut, tVirtualID vir
 
 //-----------------------------------------------------------------------
 
+unsigned int InputsUnit::registerShortcuts(const std::vector<tShortcutRegistration>& registrations)
+{
+    // Declarations
+    std::vector<tShortcutRegistration>::const_iterator  iter, iterEnd;
+    map<std::string, tVirtualID>::iterator              iterShortcut, iterShortcutEnd, iterHint;
+    map<std::string, tVirtualID>                        accepted;
+    unsigned int                                        uiNbRejected = 0;
+    string                                              strFirstRejected;
+    stringstream                                        str;
+
+    // Validate the registrations
+    for (iter = registrations.begin(), iterEnd = registrations.end(); iter != iterEnd; ++iter)
+    {
+        if ((m_shortcuts.find(iter->strShortcut) != m_shortcuts.end()) ||
+            !accepted.insert(make_pair(iter->strShortcut, iter->virtualID)).second)
+        {
+            if (uiNbRejected == 0)
+                strFirstRejected = iter->strShortcut;
+
+            ++uiNbRejected;
+        }
+    }
+
+    // Add them to the index (sorted by name, each insertion starts from the previous one)
+    iterHint = m_shortcuts.begin();
+    for (iterShortcut = accepted.begin(), iterShortcutEnd = accepted.end();
+         iterShortcut != iterShortcutEnd; ++iterShortcut)
+    {
+        iterHint = m_shortcuts.insert(iterHint, *iterShortcut);
+    }
+
+    str << accepted.size() << " shortcuts registered";
+
+    if (uiNbRejected > 0)
+    {
+        str << ", " << uiNbRejected << " rejected because they already exist (first: '"
+            << strFirstRejected << "')";
+        ATHENA_LOG_ERROR(str.str());
+    }
+    else
+    {
+        ATHENA_LOG_EVENT(str.str());
+    }
+
+    return (unsigned int) accepted.size();
+}
+
+//-----------------------------------------------------------------------
+
 tVirtualID InputsUnit::getVirtualIDFromShortcut(const std::string& strShortcut)
 {
     // Declarations
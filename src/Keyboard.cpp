@@ -6,6 +6,7 @@
 
 #include <Athena-Inputs/Keyboard.h>
 #include <Athena-Inputs/IEventsListener.h>
+#include <Athena-Inputs/InputsUnit.h>
 
 
 using namespace Athena;
@@ -17,7 +18,8 @@ using namespace std;
 /****************************** CONSTRUCTION / DESTRUCTION ******************************/
 
 Keyboard::Keyboard(OIS::Object* pOISObject)
-: Controller(pOISObject, 1), m_bCharacterMode(false)
+: Controller(pOISObject, 1), m_bCharacterMode(false), m_uiTextLength(0), m_uiHighSurrogate(0),
+  m_ulNbDroppedCharacters(0)
 {
     assert(pOISObject->type() == OIS::OISKeyboard);
 
@@ -32,6 +34,69 @@ Keyboard::~Keyboard()
 }
 
 
+/************************************** METHODS ****************************************/
+
+void Keyboard::setCharacterMode(bool enabled)
+{
+    // Assertions
+    assert(InputsUnit::getSingletonPtr());
+
+    // The keyboard must be read while the character mode is enabled, even if no
+    // virtual part is bound to it
+    if (enabled && !m_bCharacterMode)
+        InputsUnit::getSingletonPtr()->_retainController(this);
+    else if (!enabled && m_bCharacterMode)
+        InputsUnit::getSingletonPtr()->_releaseController(this);
+
+    m_bCharacterMode = enabled;
+
+    m_uiTextLength          = 0;
+    m_uiHighSurrogate       = 0;
+    m_ulNbDroppedCharacters = 0;
+}
+
+//-----------------------------------------------------------------------
+
+void Keyboard::capture()
+{
+    m_uiTextLength = 0;
+
+    Controller::capture();
+}
+
+
+/*********************************** INTERNAL METHODS **********************************/
+
+void Keyboard::appendCharacter(unsigned int uiText)
+{
+    // Combine the UTF-16 surrogate pairs (some platforms report code units)
+    if ((uiText >= 0xD800) && (uiText <= 0xDBFF))
+    {
+        m_uiHighSurrogate = uiText;
+        return;
+    }
+
+    if ((uiText >= 0xDC00) && (uiText <= 0xDFFF))
+    {
+        if (m_uiHighSurrogate == 0)
+            return;
+
+        uiText = 0x10000 + ((m_uiHighSurrogate - 0xD800) << 10) + (uiText - 0xDC00);
+    }
+
+    m_uiHighSurrogate = 0;
+
+    if (m_uiTextLength >= TEXT_BUFFER_SIZE)
+    {
+        ++m_ulNbDroppedCharacters;
+        return;
+    }
+
+    m_text[m_uiTextLength] = uiText;
+    ++m_uiTextLength;
+}
+
+
 /**************************** IMPLEMENTATION OF OIS::KeyListener ************************/
 
 bool Keyboard::keyPressed(const OIS::KeyEvent &arg)
@@ -40,11 +105,9 @@ bool Keyboard::keyPressed(const OIS::KeyEvent &arg)
 
     if (m_bCharacterMode)
     {
-        for (listenersIter = m_listeners.begin(), listenersIterEnd = m_listeners.end();
-             listenersIter != listenersIterEnd; ++listenersIter)
-        {
-            // (*listenersIter)->onCharacter(arg.text);
-        }
+        // The keys without character (arrows, modifiers, ...) have no text
+        if (arg.text != 0)
+            appendCharacter(arg.text);
     }
     else
     {
@@ -52,6 +115,7 @@ bool Keyboard::keyPressed(const OIS::KeyEvent &arg)
         tInputEvent event;
 
         event.pController       = this;
+        event.ulTimeStamp       = getTimestamp();
         event.part              = PART_KEY;
         event.partID.key        = arg.key;
         event.value.bPressed    = true;
@@ -76,6 +140,7 @@ bool Keyboard::keyReleased(const OIS::KeyEvent &arg)
         tInputEvent event;
 
         event.pController       = this;
+        event.ulTimeStamp       = getTimestamp();
         event.part              = PART_KEY;
         event.partID.key        = arg.key;
         event.value.bPressed    = false;
@@ -17,7 +17,8 @@ using namespace std;
 /****************************** CONSTRUCTION / DESTRUCTION ******************************/
 
 Mouse::Mouse(OIS::Object* pOISObject)
-: Controller(pOISObject, 1)
+: Controller(pOISObject, 1), m_iFrameDeltaX(0), m_iFrameDeltaY(0), m_iFrameDeltaZ(0),
+  m_uiFirstSample(0), m_uiNbSamples(0), m_uiNbFrameSamples(0)
 {
     assert(pOISObject->type() == OIS::OISMouse);
 
@@ -31,6 +32,50 @@ Mouse::~Mouse()
 }
 
 
+/************************************** METHODS ****************************************/
+
+void Mouse::capture()
+{
+    m_iFrameDeltaX      = 0;
+    m_iFrameDeltaY      = 0;
+    m_iFrameDeltaZ      = 0;
+    m_uiNbFrameSamples  = 0;
+
+    Controller::capture();
+}
+
+//-----------------------------------------------------------------------
+
+void Mouse::getFrameDelta(int &iX, int &iY, int &iZ) const
+{
+    iX = m_iFrameDeltaX;
+    iY = m_iFrameDeltaY;
+    iZ = m_iFrameDeltaZ;
+}
+
+//-----------------------------------------------------------------------
+
+void Mouse::enableSamplesHistory(unsigned int uiCapacity)
+{
+    m_samples.clear();
+    m_samples.resize(uiCapacity);
+
+    m_uiFirstSample     = 0;
+    m_uiNbSamples       = 0;
+    m_uiNbFrameSamples  = 0;
+}
+
+//-----------------------------------------------------------------------
+
+const Mouse::tSample& Mouse::getSample(unsigned int uiIndex) const
+{
+    // Assertions
+    assert(uiIndex < m_uiNbSamples);
+
+    return m_samples[(m_uiFirstSample + uiIndex) % m_samples.size()];
+}
+
+
 /*************************** IMPLEMENTATION OF OIS::MouseListener ***********************/
 
 bool Mouse::mouseMoved(const OIS::MouseEvent &arg)
@@ -40,8 +85,32 @@ bool Mouse::mouseMoved(const OIS::MouseEvent &arg)
     tInputEvent event;
 
     event.pController = this;
+    event.ulTimeStamp = getTimestamp();
     event.part        = PART_AXIS;
 
+    m_iFrameDeltaX += arg.state.X.rel;
+    m_iFrameDeltaY += arg.state.Y.rel;
+    m_iFrameDeltaZ += arg.state.Z.rel;
+
+    // Keep the movement in the history (the oldest one is overwritten if needed)
+    if (!m_samples.empty())
+    {
+        tSample& sample = m_samples[(m_uiFirstSample + m_uiNbSamples) % m_samples.size()];
+
+        sample.ulTimestamp  = event.ulTimeStamp;
+        sample.iX           = arg.state.X.rel;
+        sample.iY           = arg.state.Y.rel;
+        sample.iZ           = arg.state.Z.rel;
+
+        if (m_uiNbSamples < m_samples.size())
+            ++m_uiNbSamples;
+        else
+            m_uiFirstSample = (m_uiFirstSample + 1) % (unsigned int) m_samples.size();
+
+        if (m_uiNbFrameSamples < m_samples.size())
+            ++m_uiNbFrameSamples;
+    }
+
     if (arg.state.X.rel != 0)
     {
         event.partID.axis  = AXIS_X;
@@ -90,6 +159,7 @@ bool Mouse::mousePressed(const OIS::MouseEvent &arg, OIS::MouseButtonID id)
     tInputEvent event;
 
     event.pController       = this;
+    event.ulTimeStamp       = getTimestamp();
     event.part              = PART_KEY;
     event.partID.key        = id;
     event.value.bPressed    = true;
@@ -112,6 +182,7 @@ bool Mouse::mouseReleased(const OIS::MouseEvent &arg, OIS::MouseButtonID id)
     tInputEvent event;
 
     event.pController       = this;
+    event.ulTimeStamp       = getTimestamp();
     event.part              = PART_KEY;
     event.partID.key        = id;
     event.value.bPressed    = false;
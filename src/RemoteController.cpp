@@ -0,0 +1,66 @@
+/** @file   RemoteController.cpp
+    @author Philip Abbet
+
+    Implementation of the class 'Athena::Inputs::RemoteController'
+*/
+
+#include <Athena-Inputs/RemoteController.h>
+#include <Athena-Inputs/IEventsListener.h>
+
+
+using namespace Athena;
+using namespace Athena::Inputs;
+using namespace std;
+
+
+/****************************** CONSTRUCTION / DESTRUCTION ******************************/
+
+RemoteController::RemoteController(const SharedEventsRing::tDevice& device)
+: Controller((OIS::Type) device.uiType, device.uiIndex, device.strName)
+{
+    setIdentity(device.strIdentity);
+}
+
+//-----------------------------------------------------------------------
+
+RemoteController::~RemoteController()
+{
+}
+
+
+/*************************************** METHODS ****************************************/
+
+void RemoteController::_fireEvent(const SharedEventsRing::tEvent& event)
+{
+    // Declarations
+    tListenersList::iterator    listenersIter, listenersIterEnd;
+    tInputEvent                 inputEvent;
+
+    inputEvent.pController  = this;
+    inputEvent.ulTimeStamp  = event.getTimeStamp();
+    inputEvent.part         = (tControllerPart) event.part;
+
+    switch (inputEvent.part)
+    {
+    case PART_KEY:
+        inputEvent.partID.key       = event.partID;
+        inputEvent.value.bPressed   = (event.iValue != 0);
+        break;
+
+    case PART_AXIS:
+        inputEvent.partID.axis      = event.partID;
+        inputEvent.value.iValue     = event.iValue;
+        break;
+
+    case PART_POV:
+        inputEvent.partID.pov       = event.partID;
+        inputEvent.value.iValue     = event.iValue;
+        break;
+    }
+
+    for (listenersIter = m_listeners.begin(), listenersIterEnd = m_listeners.end();
+         listenersIter != listenersIterEnd; ++listenersIter)
+    {
+        (*listenersIter)->onEvent(&inputEvent);
+    }
+}
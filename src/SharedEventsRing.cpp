@@ -0,0 +1,392 @@
+/** @file   SharedEventsRing.cpp
+    @author Philip Abbet
+
+    Implementation of the class 'Athena::Inputs::SharedEventsRing'
+*/
+
+#include <Athena-Inputs/SharedEventsRing.h>
+#include <Athena-Inputs/Threading.h>
+#include <string.h>
+
+#if ATHENA_PLATFORM == ATHENA_PLATFORM_WIN32
+#   define WIN32_LEAN_AND_MEAN
+#   include <windows.h>
+#else
+#   include <sys/mman.h>
+#   include <sys/stat.h>
+#   include <fcntl.h>
+#   include <unistd.h>
+#endif
+
+
+using namespace Athena;
+using namespace Athena::Inputs;
+using namespace std;
+
+
+/************************************** CONSTANTS **************************************/
+
+/// Identifies a valid shared memory ('AIER')
+static const unsigned int RING_MAGIC = 0x52454941;
+
+/// Version of the layout of the shared memory
+static const unsigned int RING_VERSION = 2;
+
+
+/*************************************** HEADER ****************************************/
+
+/// Header of the shared memory, followed by the events
+struct SharedEventsRing::tHeader
+{
+    unsigned int            uiMagic;        ///< RING_MAGIC
+    unsigned int            uiVersion;      ///< RING_VERSION
+    unsigned int            uiCapacity;     ///< Number of events in the ring (power of 2)
+    volatile unsigned int   uiNbDevices;    ///< Number of controllers declared
+    volatile unsigned int   uiWriteIndex;   ///< Number of events written (wraps around)
+    tDevice                 devices[MAX_DEVICES];
+};
+
+
+/****************************** CONSTRUCTION / DESTRUCTION *****************************/
+
+SharedEventsRing::SharedEventsRing()
+: m_pHeader(0), m_pEvents(0), m_uiSize(0), m_uiReadIndex(0), m_ulNbLostEvents(0),
+  m_bOwner(false), m_handle(0)
+{
+}
+
+//-----------------------------------------------------------------------
+
+SharedEventsRing::~SharedEventsRing()
+{
+    close();
+}
+
+
+/************************************** METHODS ****************************************/
+
+bool SharedEventsRing::create(const std::string& strName, unsigned int uiCapacity)
+{
+    // Assertions
+    assert(!strName.empty());
+    assert(uiCapacity > 0);
+
+    // Declarations
+    unsigned int uiRoundedCapacity = 1;
+
+    close();
+
+    while (uiRoundedCapacity < uiCapacity)
+        uiRoundedCapacity <<= 1;
+
+    m_uiSize = sizeof(tHeader) + uiRoundedCapacity * sizeof(tEvent);
+
+#if ATHENA_PLATFORM == ATHENA_PLATFORM_WIN32
+    HANDLE hMapping = CreateFileMappingA(INVALID_HANDLE_VALUE, 0, PAGE_READWRITE, 0, m_uiSize,
+                                         strName.c_str());
+    if (!hMapping)
+        return false;
+
+    void* pMemory = MapViewOfFile(hMapping, FILE_MAP_ALL_ACCESS, 0, 0, m_uiSize);
+    if (!pMemory)
+    {
+        CloseHandle(hMapping);
+        return false;
+    }
+
+    m_handle = hMapping;
+#else
+    int fd = shm_open(("/" + strName).c_str(), O_CREAT | O_RDWR, 0600);
+    if (fd < 0)
+        return false;
+
+    if (ftruncate(fd, m_uiSize) != 0)
+    {
+        ::close(fd);
+        shm_unlink(("/" + strName).c_str());
+        return false;
+    }
+
+    void* pMemory = mmap(0, m_uiSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+
+    if (pMemory == MAP_FAILED)
+    {
+        shm_unlink(("/" + strName).c_str());
+        return false;
+    }
+#endif
+
+    m_pHeader   = (tHeader*) pMemory;
+    m_pEvents   = (tEvent*) (m_pHeader + 1);
+    m_bOwner    = true;
+    m_strName   = strName;
+
+    memset(m_pHeader, 0, sizeof(tHeader));
+    m_pHeader->uiVersion    = RING_VERSION;
+    m_pHeader->uiCapacity   = uiRoundedCapacity;
+
+    // The readers check the magic number last
+    Thread::memoryBarrier();
+    m_pHeader->uiMagic = RING_MAGIC;
+
+    return true;
+}
+
+//-----------------------------------------------------------------------
+
+bool SharedEventsRing::open(const std::string& strName)
+{
+    // Assertions
+    assert(!strName.empty());
+
+    // Declarations
+    tHeader* pHeader;
+
+    close();
+
+#if ATHENA_PLATFORM == ATHENA_PLATFORM_WIN32
+    HANDLE hMapping = OpenFileMappingA(FILE_MAP_READ, FALSE, strName.c_str());
+    if (!hMapping)
+        return false;
+
+    void* pMemory = MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
+    if (!pMemory)
+    {
+        CloseHandle(hMapping);
+        return false;
+    }
+
+    pHeader = (tHeader*) pMemory;
+    if ((pHeader->uiMagic != RING_MAGIC) || (pHeader->uiVersion != RING_VERSION))
+    {
+        UnmapViewOfFile(pMemory);
+        CloseHandle(hMapping);
+        return false;
+    }
+
+    m_handle = hMapping;
+#else
+    struct stat infos;
+
+    int fd = shm_open(("/" + strName).c_str(), O_RDONLY, 0);
+    if (fd < 0)
+        return false;
+
+    if ((fstat(fd, &infos) != 0) || (infos.st_size < (off_t) sizeof(tHeader)))
+    {
+        ::close(fd);
+        return false;
+    }
+
+    void* pMemory = mmap(0, infos.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+
+    if (pMemory == MAP_FAILED)
+        return false;
+
+    pHeader = (tHeader*) pMemory;
+    if ((pHeader->uiMagic != RING_MAGIC) || (pHeader->uiVersion != RING_VERSION) ||
+        ((off_t) (sizeof(tHeader) + pHeader->uiCapacity * sizeof(tEvent)) > infos.st_size))
+    {
+        munmap(pMemory, infos.st_size);
+        return false;
+    }
+#endif
+
+    Thread::memoryBarrier();
+
+    m_pHeader           = pHeader;
+    m_pEvents           = (tEvent*) (m_pHeader + 1);
+    m_uiSize            = sizeof(tHeader) + m_pHeader->uiCapacity * sizeof(tEvent);
+    m_uiReadIndex       = m_pHeader->uiWriteIndex;
+    m_ulNbLostEvents    = 0;
+    m_bOwner            = false;
+    m_strName           = strName;
+
+    return true;
+}
+
+//-----------------------------------------------------------------------
+
+void SharedEventsRing::close()
+{
+    if (!m_pHeader)
+        return;
+
+#if ATHENA_PLATFORM == ATHENA_PLATFORM_WIN32
+    UnmapViewOfFile(m_pHeader);
+    CloseHandle((HANDLE) m_handle);
+#else
+    munmap(m_pHeader, m_uiSize);
+
+    if (m_bOwner)
+        shm_unlink(("/" + m_strName).c_str());
+#endif
+
+    m_pHeader   = 0;
+    m_pEvents   = 0;
+    m_uiSize    = 0;
+    m_bOwner    = false;
+    m_handle    = 0;
+    m_strName   = "";
+}
+
+//-----------------------------------------------------------------------
+
+unsigned int SharedEventsRing::getCapacity() const
+{
+    return (m_pHeader ? m_pHeader->uiCapacity : 0);
+}
+
+//-----------------------------------------------------------------------
+
+unsigned int SharedEventsRing::addDevice(OIS::Type type, unsigned int uiIndex,
+                                         const std::string& strName, const std::string& strIdentity)
+{
+    // Assertions
+    assert(m_pHeader);
+    assert(m_bOwner);
+
+    // Declarations
+    unsigned int uiDevice = m_pHeader->uiNbDevices;
+
+    if (uiDevice >= MAX_DEVICES)
+        return MAX_DEVICES;
+
+    tDevice& device = m_pHeader->devices[uiDevice];
+
+    device.uiType   = (unsigned int) type;
+    device.uiIndex  = uiIndex;
+
+    strncpy(device.strName, strName.c_str(), MAX_NAME_LENGTH - 1);
+    device.strName[MAX_NAME_LENGTH - 1] = 0;
+
+    strncpy(device.strIdentity, strIdentity.c_str(), MAX_NAME_LENGTH - 1);
+    device.strIdentity[MAX_NAME_LENGTH - 1] = 0;
+
+    // Publish the controller once its description is complete
+    Thread::memoryBarrier();
+    m_pHeader->uiNbDevices = uiDevice + 1;
+
+    return uiDevice;
+}
+
+//-----------------------------------------------------------------------
+
+unsigned int SharedEventsRing::getNbDevices() const
+{
+    return (m_pHeader ? m_pHeader->uiNbDevices : 0);
+}
+
+//-----------------------------------------------------------------------
+
+const SharedEventsRing::tDevice& SharedEventsRing::getDevice(unsigned int uiDevice) const
+{
+    // Assertions
+    assert(m_pHeader);
+    assert(uiDevice < m_pHeader->uiNbDevices);
+
+    return m_pHeader->devices[uiDevice];
+}
+
+//-----------------------------------------------------------------------
+
+void SharedEventsRing::write(unsigned int uiDevice, const tInputEvent& event)
+{
+    // Assertions
+    assert(m_pHeader);
+    assert(m_bOwner);
+    assert(uiDevice < m_pHeader->uiNbDevices);
+
+    // Declarations
+    unsigned int    uiWriteIndex = m_pHeader->uiWriteIndex;
+    tEvent&         entry = m_pEvents[uiWriteIndex & (m_pHeader->uiCapacity - 1)];
+
+    entry.uiTimeStampLow    = (unsigned int) (event.ulTimeStamp & 0xFFFFFFFF);
+    entry.uiTimeStampHigh   = (unsigned int) ((event.ulTimeStamp >> 16) >> 16);
+    entry.device            = (unsigned char) uiDevice;
+    entry.part              = (unsigned char) event.part;
+    entry.reserved          = 0;
+
+    switch (event.part)
+    {
+    case PART_KEY:
+        entry.partID    = event.partID.key;
+        entry.iValue    = (event.value.bPressed ? 1 : 0);
+        break;
+
+    case PART_AXIS:
+        entry.partID    = event.partID.axis;
+        entry.iValue    = event.value.iValue;
+        break;
+
+    case PART_POV:
+        entry.partID    = event.partID.pov;
+        entry.iValue    = event.value.iValue;
+        break;
+    }
+
+    // Publish the event once it is complete
+    Thread::memoryBarrier();
+    m_pHeader->uiWriteIndex = uiWriteIndex + 1;
+}
+
+//-----------------------------------------------------------------------
+
+unsigned int SharedEventsRing::read(tEvent* pEvents, unsigned int uiMaxEvents)
+{
+    // Assertions
+    assert(m_pHeader);
+    assert(pEvents);
+
+    // Declarations
+    unsigned int uiCapacity = m_pHeader->uiCapacity;
+    unsigned int uiWriteIndex;
+    unsigned int uiNbEvents;
+    unsigned int uiNbOverwritten;
+    unsigned int i;
+
+    uiWriteIndex = m_pHeader->uiWriteIndex;
+    Thread::memoryBarrier();
+
+    // Skip the events already overwritten (the slot being written counts as
+    // overwritten)
+    if (uiWriteIndex - m_uiReadIndex >= uiCapacity)
+    {
+        m_ulNbLostEvents += uiWriteIndex - m_uiReadIndex - (uiCapacity - 1);
+        m_uiReadIndex = uiWriteIndex - (uiCapacity - 1);
+    }
+
+    uiNbEvents = uiWriteIndex - m_uiReadIndex;
+    if (uiNbEvents > uiMaxEvents)
+        uiNbEvents = uiMaxEvents;
+
+    for (i = 0; i < uiNbEvents; ++i)
+        pEvents[i] = m_pEvents[(m_uiReadIndex + i) & (uiCapacity - 1)];
+
+    // Discard the events overwritten by the writer during the copy
+    Thread::memoryBarrier();
+    uiWriteIndex = m_pHeader->uiWriteIndex;
+
+    uiNbOverwritten = 0;
+    if (uiWriteIndex - m_uiReadIndex >= uiCapacity)
+        uiNbOverwritten = uiWriteIndex - m_uiReadIndex - (uiCapacity - 1);
+
+    if (uiNbOverwritten >= uiNbEvents)
+    {
+        m_ulNbLostEvents += uiNbOverwritten;
+        m_uiReadIndex += uiNbOverwritten;
+        return 0;
+    }
+
+    if (uiNbOverwritten > 0)
+    {
+        memmove(pEvents, pEvents + uiNbOverwritten, (uiNbEvents - uiNbOverwritten) * sizeof(tEvent));
+        m_ulNbLostEvents += uiNbOverwritten;
+    }
+
+    m_uiReadIndex += uiNbEvents;
+
+    return uiNbEvents - uiNbOverwritten;
+}
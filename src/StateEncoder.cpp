@@ -0,0 +1,376 @@
+/** @file   StateEncoder.cpp
+    @author Philip Abbet
+
+    Implementation of the class 'Athena::Inputs::StateEncoder'
+*/
+
+#include <Athena-Inputs/StateEncoder.h>
+#include <Athena-Inputs/VirtualController.h>
+
+
+using namespace Athena;
+using namespace Athena::Inputs;
+using namespace std;
+
+
+/************************************** BIT STREAMS ************************************/
+
+namespace {
+
+/// Writes bits in a buffer (least significant bit first)
+class BitWriter
+{
+public:
+    BitWriter(unsigned char* pBuffer, unsigned int uiCapacity)
+    : m_pBuffer(pBuffer), m_uiCapacity(uiCapacity), m_uiBit(0), m_bOverflow(false)
+    {
+    }
+
+    void write(unsigned int uiValue, unsigned int uiNbBits)
+    {
+        for (unsigned int i = 0; i < uiNbBits; ++i)
+        {
+            unsigned int uiByte = m_uiBit >> 3;
+            if (uiByte >= m_uiCapacity)
+            {
+                m_bOverflow = true;
+                return;
+            }
+
+            if ((m_uiBit & 7) == 0)
+                m_pBuffer[uiByte] = 0;
+
+            if ((uiValue >> i) & 1)
+                m_pBuffer[uiByte] |= (unsigned char) (1 << (m_uiBit & 7));
+
+            ++m_uiBit;
+        }
+    }
+
+    /// Write a signed value: zigzag-encoded, by groups of 4 bits followed by a
+    /// continuation bit
+    void writeVarInt(int iValue)
+    {
+        unsigned int uiValue = (iValue < 0 ? ((unsigned int) (-(iValue + 1)) << 1) | 1 : (unsigned int) iValue << 1);
+
+        do
+        {
+            write(uiValue & 0x0F, 4);
+            uiValue >>= 4;
+            write(uiValue != 0 ? 1 : 0, 1);
+        }
+        while (uiValue != 0);
+    }
+
+    unsigned int getSize() const { return (m_bOverflow ? 0 : (m_uiBit + 7) >> 3); }
+
+private:
+    unsigned char*  m_pBuffer;
+    unsigned int    m_uiCapacity;
+    unsigned int    m_uiBit;
+    bool            m_bOverflow;
+};
+
+//-----------------------------------------------------------------------
+
+/// Reads bits from a buffer (least significant bit first)
+class BitReader
+{
+public:
+    BitReader(const unsigned char* pBuffer, unsigned int uiSize)
+    : m_pBuffer(pBuffer), m_uiSize(uiSize), m_uiBit(0), m_bOverflow(false)
+    {
+    }
+
+    unsigned int read(unsigned int uiNbBits)
+    {
+        unsigned int uiValue = 0;
+
+        for (unsigned int i = 0; i < uiNbBits; ++i)
+        {
+            unsigned int uiByte = m_uiBit >> 3;
+            if (uiByte >= m_uiSize)
+            {
+                m_bOverflow = true;
+                return 0;
+            }
+
+            if ((m_pBuffer[uiByte] >> (m_uiBit & 7)) & 1)
+                uiValue |= (1u << i);
+
+            ++m_uiBit;
+        }
+
+        return uiValue;
+    }
+
+    int readVarInt()
+    {
+        unsigned int uiValue = 0;
+        unsigned int uiShift = 0;
+
+        do
+        {
+            uiValue |= read(4) << uiShift;
+            uiShift += 4;
+        }
+        while (read(1) && !m_bOverflow && (uiShift < 32));
+
+        return ((uiValue & 1) ? -(int) (uiValue >> 1) - 1 : (int) (uiValue >> 1));
+    }
+
+    unsigned int getSize() const { return (m_bOverflow ? 0 : (m_uiBit + 7) >> 3); }
+
+private:
+    const unsigned char*    m_pBuffer;
+    unsigned int            m_uiSize;
+    unsigned int            m_uiBit;
+    bool                    m_bOverflow;
+};
+
+}
+
+
+/****************************** CONSTRUCTION / DESTRUCTION *****************************/
+
+StateEncoder::StateEncoder(VirtualController* pVirtualController, unsigned int uiAxisQuantization)
+: m_pVirtualController(pVirtualController), m_uiAxisQuantization(uiAxisQuantization)
+{
+    // Assertions
+    assert(pVirtualController);
+    assert(uiAxisQuantization < 16);
+
+    rebuild();
+}
+
+//-----------------------------------------------------------------------
+
+StateEncoder::~StateEncoder()
+{
+}
+
+
+/************************************** METHODS ****************************************/
+
+void StateEncoder::rebuild()
+{
+    // Declarations
+    tVirtualID      virtualID;
+    unsigned int    i;
+
+    m_keys.clear();
+    m_axes.clear();
+    m_povs.clear();
+
+    for (i = 0; i < m_pVirtualController->getNbVirtualKeys(); ++i)
+    {
+        m_pVirtualController->getVirtualKey(i, virtualID);
+        m_keys.push_back(m_pVirtualController->getVirtualKey(virtualID));
+    }
+
+    for (i = 0; i < m_pVirtualController->getNbVirtualAxes(); ++i)
+    {
+        m_pVirtualController->getVirtualAxis(i, virtualID);
+        m_axes.push_back(m_pVirtualController->getVirtualAxis(virtualID));
+    }
+
+    for (i = 0; i < m_pVirtualController->getNbVirtualPOVs(); ++i)
+    {
+        m_pVirtualController->getVirtualPOV(i, virtualID);
+        m_povs.push_back(m_pVirtualController->getVirtualPOV(virtualID));
+    }
+}
+
+//-----------------------------------------------------------------------
+
+void StateEncoder::initState(tState &state) const
+{
+    state.keyBits.assign((m_keys.size() + 31) / 32, 0);
+    state.axisValues.assign(m_axes.size(), 0);
+    state.povPositions.assign(m_povs.size(), POV_CENTER);
+}
+
+//-----------------------------------------------------------------------
+
+void StateEncoder::capture(tState &state) const
+{
+    // Assertions
+    assert(state.keyBits.size() == (m_keys.size() + 31) / 32);
+    assert(state.axisValues.size() == m_axes.size());
+    assert(state.povPositions.size() == m_povs.size());
+
+    // Declarations
+    unsigned int i;
+
+    m_pVirtualController->_validateVirtualParts();
+
+    for (i = 0; i < state.keyBits.size(); ++i)
+        state.keyBits[i] = 0;
+
+    for (i = 0; i < m_keys.size(); ++i)
+    {
+        if (m_keys[i]->bPressed)
+            state.keyBits[i >> 5] |= (1u << (i & 31));
+    }
+
+    for (i = 0; i < m_axes.size(); ++i)
+        state.axisValues[i] = m_axes[i]->iValue >> m_uiAxisQuantization;
+
+    for (i = 0; i < m_povs.size(); ++i)
+        state.povPositions[i] = m_povs[i]->position;
+}
+
+//-----------------------------------------------------------------------
+
+void StateEncoder::apply(const tState& state) const
+{
+    // Declarations
+    unsigned int i;
+
+    m_pVirtualController->_validateVirtualParts();
+
+    // The modified virtual parts must be reset at the beginning of the next frame
+    m_pVirtualController->_markAllPartsDirty();
+
+    for (i = 0; i < m_keys.size(); ++i)
+    {
+        bool bPressed = ((state.keyBits[i >> 5] >> (i & 31)) & 1) != 0;
+        m_pVirtualController->_setKeyState(m_keys[i], bPressed);
+    }
+
+    for (i = 0; i < m_axes.size(); ++i)
+    {
+        m_pVirtualController->_setAxisValue(m_axes[i],
+                                            state.axisValues[i] * (1 << m_uiAxisQuantization));
+    }
+
+    for (i = 0; i < m_povs.size(); ++i)
+        m_pVirtualController->_setPOVPosition(m_povs[i], state.povPositions[i]);
+
+    // Compute the conditioned values of the axes
+    m_pVirtualController->_conditionAxes();
+}
+
+//-----------------------------------------------------------------------
+
+unsigned int StateEncoder::getMaxEncodedSize() const
+{
+    // Header + keys + (changed bit + up to 8 groups of 5 bits) by axis + 5 bits by POV
+    unsigned int uiNbBits = 3 + (unsigned int) m_keys.size() + (unsigned int) m_axes.size() * 41 +
+                            (unsigned int) m_povs.size() * 5;
+
+    return (uiNbBits + 7) >> 3;
+}
+
+//-----------------------------------------------------------------------
+
+unsigned int StateEncoder::encode(const tState& reference, const tState& state,
+                                  unsigned char* pBuffer, unsigned int uiCapacity) const
+{
+    // Declarations
+    BitWriter       writer(pBuffer, uiCapacity);
+    bool            bKeysChanged = false;
+    bool            bAxesChanged = false;
+    bool            bPOVsChanged = false;
+    unsigned int    i;
+
+    for (i = 0; (i < state.keyBits.size()) && !bKeysChanged; ++i)
+        bKeysChanged = (state.keyBits[i] != reference.keyBits[i]);
+
+    for (i = 0; (i < state.axisValues.size()) && !bAxesChanged; ++i)
+        bAxesChanged = (state.axisValues[i] != reference.axisValues[i]);
+
+    for (i = 0; (i < state.povPositions.size()) && !bPOVsChanged; ++i)
+        bPOVsChanged = (state.povPositions[i] != reference.povPositions[i]);
+
+    // Header
+    writer.write(bKeysChanged ? 1 : 0, 1);
+    writer.write(bAxesChanged ? 1 : 0, 1);
+    writer.write(bPOVsChanged ? 1 : 0, 1);
+
+    // Changed keys
+    if (bKeysChanged)
+    {
+        for (i = 0; i < m_keys.size(); ++i)
+        {
+            unsigned int uiChanges = state.keyBits[i >> 5] ^ reference.keyBits[i >> 5];
+            writer.write((uiChanges >> (i & 31)) & 1, 1);
+        }
+    }
+
+    // Deltas of the axes
+    if (bAxesChanged)
+    {
+        for (i = 0; i < m_axes.size(); ++i)
+        {
+            int iDelta = state.axisValues[i] - reference.axisValues[i];
+
+            writer.write(iDelta != 0 ? 1 : 0, 1);
+            if (iDelta != 0)
+                writer.writeVarInt(iDelta);
+        }
+    }
+
+    // Positions of the POVs
+    if (bPOVsChanged)
+    {
+        for (i = 0; i < m_povs.size(); ++i)
+        {
+            bool bChanged = (state.povPositions[i] != reference.povPositions[i]);
+
+            writer.write(bChanged ? 1 : 0, 1);
+            if (bChanged)
+                writer.write(state.povPositions[i] & 0x0F, 4);
+        }
+    }
+
+    return writer.getSize();
+}
+
+//-----------------------------------------------------------------------
+
+unsigned int StateEncoder::decode(const tState& reference, const unsigned char* pBuffer,
+                                  unsigned int uiSize, tState &state) const
+{
+    // Declarations
+    BitReader       reader(pBuffer, uiSize);
+    unsigned int    i;
+
+    state.keyBits       = reference.keyBits;
+    state.axisValues    = reference.axisValues;
+    state.povPositions  = reference.povPositions;
+
+    // Header
+    bool bKeysChanged = (reader.read(1) != 0);
+    bool bAxesChanged = (reader.read(1) != 0);
+    bool bPOVsChanged = (reader.read(1) != 0);
+
+    // Changed keys
+    if (bKeysChanged)
+    {
+        for (i = 0; i < m_keys.size(); ++i)
+            state.keyBits[i >> 5] ^= (reader.read(1) << (i & 31));
+    }
+
+    // Deltas of the axes
+    if (bAxesChanged)
+    {
+        for (i = 0; i < m_axes.size(); ++i)
+        {
+            if (reader.read(1))
+                state.axisValues[i] += reader.readVarInt();
+        }
+    }
+
+    // Positions of the POVs
+    if (bPOVsChanged)
+    {
+        for (i = 0; i < m_povs.size(); ++i)
+        {
+            if (reader.read(1))
+                state.povPositions[i] = (tPOVPosition) reader.read(4);
+        }
+    }
+
+    return reader.getSize();
+}
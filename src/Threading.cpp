@@ -0,0 +1,171 @@
+/** @file   Threading.cpp
+    @author Philip Abbet
+
+    Implementation of the classes 'Athena::Inputs::Mutex' and 'Athena::Inputs::Thread'
+*/
+
+#include <Athena-Inputs/Threading.h>
+
+#if ATHENA_PLATFORM == ATHENA_PLATFORM_WIN32
+#   define WIN32_LEAN_AND_MEAN
+#   include <windows.h>
+#else
+#   include <unistd.h>
+#endif
+
+
+using namespace Athena;
+using namespace Athena::Inputs;
+
+
+/************************************** MUTEX ******************************************/
+
+Mutex::Mutex()
+{
+#if ATHENA_PLATFORM == ATHENA_PLATFORM_WIN32
+    CRITICAL_SECTION* pSection = new CRITICAL_SECTION;
+    InitializeCriticalSection(pSection);
+    m_handle = pSection;
+#else
+    pthread_mutex_init(&m_mutex, 0);
+#endif
+}
+
+//-----------------------------------------------------------------------
+
+Mutex::~Mutex()
+{
+#if ATHENA_PLATFORM == ATHENA_PLATFORM_WIN32
+    DeleteCriticalSection((CRITICAL_SECTION*) m_handle);
+    delete (CRITICAL_SECTION*) m_handle;
+#else
+    pthread_mutex_destroy(&m_mutex);
+#endif
+}
+
+//-----------------------------------------------------------------------
+
+void Mutex::lock()
+{
+#if ATHENA_PLATFORM == ATHENA_PLATFORM_WIN32
+    EnterCriticalSection((CRITICAL_SECTION*) m_handle);
+#else
+    pthread_mutex_lock(&m_mutex);
+#endif
+}
+
+//-----------------------------------------------------------------------
+
+bool Mutex::tryLock()
+{
+#if ATHENA_PLATFORM == ATHENA_PLATFORM_WIN32
+    return (TryEnterCriticalSection((CRITICAL_SECTION*) m_handle) != 0);
+#else
+    return (pthread_mutex_trylock(&m_mutex) == 0);
+#endif
+}
+
+//-----------------------------------------------------------------------
+
+void Mutex::unlock()
+{
+#if ATHENA_PLATFORM == ATHENA_PLATFORM_WIN32
+    LeaveCriticalSection((CRITICAL_SECTION*) m_handle);
+#else
+    pthread_mutex_unlock(&m_mutex);
+#endif
+}
+
+
+/************************************** THREAD *****************************************/
+
+Thread::Thread()
+: m_bRunning(false)
+{
+}
+
+//-----------------------------------------------------------------------
+
+Thread::~Thread()
+{
+    assert(!m_bRunning);
+}
+
+//-----------------------------------------------------------------------
+
+bool Thread::start()
+{
+    if (m_bRunning)
+        return false;
+
+#if ATHENA_PLATFORM == ATHENA_PLATFORM_WIN32
+    m_handle = CreateThread(0, 0, &Thread::entryPoint, this, 0, 0);
+    m_bRunning = (m_handle != 0);
+#else
+    m_bRunning = (pthread_create(&m_thread, 0, &Thread::entryPoint, this) == 0);
+#endif
+
+    return m_bRunning;
+}
+
+//-----------------------------------------------------------------------
+
+void Thread::join()
+{
+    if (!m_bRunning)
+        return;
+
+#if ATHENA_PLATFORM == ATHENA_PLATFORM_WIN32
+    WaitForSingleObject(m_handle, INFINITE);
+    CloseHandle(m_handle);
+#else
+    pthread_join(m_thread, 0);
+#endif
+
+    m_bRunning = false;
+}
+
+//-----------------------------------------------------------------------
+
+void Thread::sleep(unsigned int uiMilliseconds)
+{
+#if ATHENA_PLATFORM == ATHENA_PLATFORM_WIN32
+    Sleep(uiMilliseconds);
+#else
+    usleep(uiMilliseconds * 1000);
+#endif
+}
+
+//-----------------------------------------------------------------------
+
+unsigned long Thread::getCurrentThreadID()
+{
+#if ATHENA_PLATFORM == ATHENA_PLATFORM_WIN32
+    return (unsigned long) GetCurrentThreadId();
+#else
+    return (unsigned long) pthread_self();
+#endif
+}
+
+//-----------------------------------------------------------------------
+
+void Thread::memoryBarrier()
+{
+#if ATHENA_PLATFORM == ATHENA_PLATFORM_WIN32
+    MemoryBarrier();
+#else
+    __sync_synchronize();
+#endif
+}
+
+//-----------------------------------------------------------------------
+
+#if ATHENA_PLATFORM == ATHENA_PLATFORM_WIN32
+unsigned long __stdcall Thread::entryPoint(void* pThread)
+#else
+void* Thread::entryPoint(void* pThread)
+#endif
+{
+    static_cast<Thread*>(pThread)->run();
+    return 0;
+}
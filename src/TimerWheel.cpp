@@ -0,0 +1,277 @@
+/** @file   TimerWheel.cpp
+    @author Philip Abbet
+
+    Implementation of the class 'Athena::Inputs::TimerWheel'
+*/
+
+#include <Athena-Inputs/TimerWheel.h>
+
+
+using namespace Athena;
+using namespace Athena::Inputs;
+using namespace std;
+
+
+/************************************** CONSTANTS **************************************/
+
+/// Indicates the absence of node or slot
+static const unsigned int NONE = 0xFFFFFFFF;
+
+/// Number of bits of the index of a node in a timer ID (the other bits are the
+/// generation of the node)
+static const unsigned int INDEX_BITS = 20;
+
+/// Number of bits of the first wheel, and of the other ones
+static const unsigned int WHEEL0_BITS = 8;
+static const unsigned int WHEELN_BITS = 6;
+
+/// First slot of each wheel
+static const unsigned int WHEEL1_SLOT = 256;
+static const unsigned int WHEEL2_SLOT = 256 + 64;
+static const unsigned int WHEEL3_SLOT = 256 + 2 * 64;
+
+/// Maximum distance of a deadline handled by the wheels
+static const unsigned long MAX_DISTANCE = (1UL << (WHEEL0_BITS + 3 * WHEELN_BITS)) - 1;
+
+
+/****************************** CONSTRUCTION / DESTRUCTION *****************************/
+
+TimerWheel::TimerWheel()
+: m_ulCurrent(0), m_uiNbTimers(0)
+{
+    for (unsigned int i = 0; i < NB_SLOTS; ++i)
+        m_slots[i] = NONE;
+}
+
+//-----------------------------------------------------------------------
+
+TimerWheel::~TimerWheel()
+{
+}
+
+
+/************************************** METHODS ****************************************/
+
+TimerWheel::tTimerID TimerWheel::schedule(unsigned long ulDeadline, unsigned int uiData)
+{
+    // Declarations
+    unsigned int uiNode;
+
+    if (!m_freeNodes.empty())
+    {
+        uiNode = m_freeNodes.back();
+        m_freeNodes.pop_back();
+    }
+    else
+    {
+        assert(m_nodes.size() < (1u << INDEX_BITS));
+
+        uiNode = (unsigned int) m_nodes.size();
+        m_nodes.push_back(tNode());
+        m_nodes[uiNode].uiGeneration = 0;
+    }
+
+    // Without timers, the wheels don't keep track of the time: restart from the
+    // deadline (a fresh wheel would otherwise process every millisecond since 0). With
+    // timers, going back to an earlier deadline is safe: the slots are indexed by
+    // absolute time, and the timers reached too early are put back in their slots
+    if ((m_uiNbTimers == 0) ||
+        ((ulDeadline < m_ulCurrent) && (m_ulCurrent - ulDeadline <= MAX_DISTANCE)))
+    {
+        m_ulCurrent = ulDeadline;
+    }
+
+    m_nodes[uiNode].ulDeadline  = ulDeadline;
+    m_nodes[uiNode].uiData      = uiData;
+
+    insert(uiNode);
+    ++m_uiNbTimers;
+
+    return (m_nodes[uiNode].uiGeneration << INDEX_BITS) | uiNode;
+}
+
+//-----------------------------------------------------------------------
+
+bool TimerWheel::cancel(tTimerID timer)
+{
+    // Declarations
+    unsigned int uiNode = timer & ((1u << INDEX_BITS) - 1);
+
+    if ((timer == INVALID_TIMER) || (uiNode >= m_nodes.size()) ||
+        (m_nodes[uiNode].uiSlot == NONE) ||
+        ((m_nodes[uiNode].uiGeneration & (NONE >> INDEX_BITS)) != (timer >> INDEX_BITS)))
+    {
+        return false;
+    }
+
+    unlink(uiNode);
+    release(uiNode);
+
+    return true;
+}
+
+//-----------------------------------------------------------------------
+
+void TimerWheel::clear()
+{
+    for (unsigned int i = 0; i < m_nodes.size(); ++i)
+    {
+        if (m_nodes[i].uiSlot != NONE)
+        {
+            unlink(i);
+            release(i);
+        }
+    }
+}
+
+//-----------------------------------------------------------------------
+
+void TimerWheel::advance(unsigned long ulNow, std::vector<tExpiredTimer> &expired)
+{
+    // Declarations
+    unsigned int    uiNode, uiNext;
+    tExpiredTimer   expiredTimer;
+
+    while ((m_ulCurrent <= ulNow) && (m_uiNbTimers > 0))
+    {
+        // Redistribute the next slots of the other wheels when the first one has done
+        // a full turn
+        if ((m_ulCurrent & 255) == 0)
+        {
+            unsigned long ulIndex = m_ulCurrent >> WHEEL0_BITS;
+
+            cascade(WHEEL1_SLOT + (ulIndex & 63));
+
+            if ((ulIndex & 63) == 0)
+            {
+                ulIndex >>= WHEELN_BITS;
+                cascade(WHEEL2_SLOT + (ulIndex & 63));
+
+                if ((ulIndex & 63) == 0)
+                {
+                    ulIndex >>= WHEELN_BITS;
+                    cascade(WHEEL3_SLOT + (ulIndex & 63));
+                }
+            }
+        }
+
+        // Expire the timers of the current slot
+        uiNode = m_slots[m_ulCurrent & 255];
+        m_slots[m_ulCurrent & 255] = NONE;
+
+        while (uiNode != NONE)
+        {
+            uiNext = m_nodes[uiNode].uiNext;
+            m_nodes[uiNode].uiSlot = NONE;
+
+            if (m_nodes[uiNode].ulDeadline > m_ulCurrent)
+            {
+                // Deadline farther than the wheels
+                insert(uiNode);
+            }
+            else
+            {
+                expiredTimer.uiData     = m_nodes[uiNode].uiData;
+                expiredTimer.ulDeadline = m_nodes[uiNode].ulDeadline;
+                expired.push_back(expiredTimer);
+
+                release(uiNode);
+            }
+
+            uiNode = uiNext;
+        }
+
+        ++m_ulCurrent;
+    }
+
+    if (m_ulCurrent <= ulNow)
+        m_ulCurrent = ulNow + 1;
+}
+
+
+/*********************************** INTERNAL METHODS **********************************/
+
+void TimerWheel::insert(unsigned int uiNode)
+{
+    // Declarations
+    tNode&          node = m_nodes[uiNode];
+    unsigned long   ulDeadline = (node.ulDeadline > m_ulCurrent ? node.ulDeadline : m_ulCurrent);
+    unsigned long   ulDistance = ulDeadline - m_ulCurrent;
+    unsigned int    uiSlot;
+
+    if (ulDistance < (1UL << WHEEL0_BITS))
+    {
+        uiSlot = (unsigned int) (ulDeadline & 255);
+    }
+    else if (ulDistance < (1UL << (WHEEL0_BITS + WHEELN_BITS)))
+    {
+        uiSlot = WHEEL1_SLOT + (unsigned int) ((ulDeadline >> WHEEL0_BITS) & 63);
+    }
+    else if (ulDistance < (1UL << (WHEEL0_BITS + 2 * WHEELN_BITS)))
+    {
+        uiSlot = WHEEL2_SLOT + (unsigned int) ((ulDeadline >> (WHEEL0_BITS + WHEELN_BITS)) & 63);
+    }
+    else
+    {
+        if (ulDistance > MAX_DISTANCE)
+            ulDeadline = m_ulCurrent + MAX_DISTANCE;
+
+        uiSlot = WHEEL3_SLOT + (unsigned int) ((ulDeadline >> (WHEEL0_BITS + 2 * WHEELN_BITS)) & 63);
+    }
+
+    node.uiSlot     = uiSlot;
+    node.uiPrevious = NONE;
+    node.uiNext     = m_slots[uiSlot];
+
+    if (node.uiNext != NONE)
+        m_nodes[node.uiNext].uiPrevious = uiNode;
+
+    m_slots[uiSlot] = uiNode;
+}
+
+//-----------------------------------------------------------------------
+
+void TimerWheel::unlink(unsigned int uiNode)
+{
+    // Declarations
+    tNode& node = m_nodes[uiNode];
+
+    if (node.uiPrevious != NONE)
+        m_nodes[node.uiPrevious].uiNext = node.uiNext;
+    else
+        m_slots[node.uiSlot] = node.uiNext;
+
+    if (node.uiNext != NONE)
+        m_nodes[node.uiNext].uiPrevious = node.uiPrevious;
+
+    node.uiSlot = NONE;
+}
+
+//-----------------------------------------------------------------------
+
+void TimerWheel::cascade(unsigned int uiSlot)
+{
+    // Declarations
+    unsigned int uiNode = m_slots[uiSlot];
+    unsigned int uiNext;
+
+    m_slots[uiSlot] = NONE;
+
+    while (uiNode != NONE)
+    {
+        uiNext = m_nodes[uiNode].uiNext;
+        insert(uiNode);
+        uiNode = uiNext;
+    }
+}
+
+//-----------------------------------------------------------------------
+
+void TimerWheel::release(unsigned int uiNode)
+{
+    m_nodes[uiNode].uiSlot = NONE;
+    ++m_nodes[uiNode].uiGeneration;
+
+    m_freeNodes.push_back(uiNode);
+    --m_uiNbTimers;
+}
@@ -0,0 +1,299 @@
+/** @file   Tracing.cpp
+    @author Philip Abbet
+
+    Implementation of the class 'Athena::Inputs::Tracer'
+*/
+
+#include <Athena-Inputs/Tracing.h>
+
+#if ATHENA_INPUTS_TRACING
+
+#include <Athena-Core/Log/LogManager.h>
+#include <sstream>
+#include <vector>
+
+#if ATHENA_PLATFORM == ATHENA_PLATFORM_WIN32
+#   define THREAD_LOCAL __declspec(thread)
+#else
+#   define THREAD_LOCAL __thread
+#endif
+
+
+using namespace Athena;
+using namespace Athena::Inputs;
+using namespace Athena::Log;
+using namespace std;
+
+
+/************************************** CONSTANTS **************************************/
+
+/// Context used for logging
+static const char* __CONTEXT__ = "Tracer";
+
+/// Number of measures in the buffer of a thread (power of 2)
+static const unsigned int BUFFER_CAPACITY = 4096;
+
+/// Granularity of the waits of the background thread, in milliseconds
+static const unsigned int SLEEP_GRANULARITY = 20;
+
+
+/************************************** BUFFERS ****************************************/
+
+namespace {
+
+/// A measure, as stored in a buffer
+struct tEvent
+{
+    const char*     strName;        ///< Name of the measured code
+    unsigned long   ulStart;        ///< Beginning of the measure
+    unsigned long   ulDuration;     ///< Duration of the measure
+};
+
+/// The measures of a thread (written by the thread, read by the tracer)
+struct tBuffer
+{
+    tEvent                  events[BUFFER_CAPACITY];
+    volatile unsigned int   uiWriteIndex;   ///< Number of measures written (wraps around)
+    unsigned int            uiReadIndex;    ///< Number of measures read
+    unsigned long           ulThreadID;     ///< Identifier of the thread
+};
+
+/// The buffer of the calling thread (kept until the end of the process, since the
+/// thread can't know when the tracer is done with it)
+THREAD_LOCAL tBuffer* pThreadBuffer = 0;
+
+/// The buffers of all the threads
+std::vector<tBuffer*> buffers;
+
+/// Protects the list of the buffers
+Mutex buffersMutex;
+
+}
+
+
+/********************************** STATIC ATTRIBUTES **********************************/
+
+Tracer* volatile Tracer::ms_pInstance = 0;
+
+
+/****************************** CONSTRUCTION / DESTRUCTION *****************************/
+
+Tracer::Tracer(const std::string& strFile, unsigned int uiInterval)
+: m_file(strFile.c_str()), m_uiInterval(uiInterval), m_ulOrigin(0), m_bFirstEvent(true),
+  m_ulNbLostEvents(0), m_bStop(false)
+{
+}
+
+//-----------------------------------------------------------------------
+
+Tracer::~Tracer()
+{
+}
+
+
+/************************************** METHODS ****************************************/
+
+bool Tracer::start(const std::string& strFile, unsigned int uiInterval)
+{
+    // Declarations
+    vector<tBuffer*>::iterator iter, iterEnd;
+
+    stop();
+
+    Tracer* pTracer = new Tracer(strFile, uiInterval);
+    if (!pTracer->m_file.is_open())
+    {
+        ATHENA_LOG_ERROR("Failed to open the file '" + strFile + "'");
+        delete pTracer;
+        return false;
+    }
+
+    pTracer->m_file << "[";
+
+    // The measures taken before are ignored
+    buffersMutex.lock();
+
+    for (iter = buffers.begin(), iterEnd = buffers.end(); iter != iterEnd; ++iter)
+        (*iter)->uiReadIndex = (*iter)->uiWriteIndex;
+
+    buffersMutex.unlock();
+
+    pTracer->m_ulOrigin = Controller::getPreciseTimestamp();
+
+    if (!pTracer->Thread::start())
+    {
+        ATHENA_LOG_ERROR("Failed to start the saving of the measures");
+        delete pTracer;
+        return false;
+    }
+
+    // The trace scopes check the instance last
+    Thread::memoryBarrier();
+    ms_pInstance = pTracer;
+
+    ATHENA_LOG_EVENT("Saving the measures in the file '" + strFile + "'");
+
+    return true;
+}
+
+//-----------------------------------------------------------------------
+
+void Tracer::stop()
+{
+    // Declarations
+    Tracer* pTracer = ms_pInstance;
+
+    if (!pTracer)
+        return;
+
+    ms_pInstance = 0;
+
+    pTracer->m_mutex.lock();
+    pTracer->m_bStop = true;
+    pTracer->m_mutex.unlock();
+
+    pTracer->join();
+
+    pTracer->flush();
+    pTracer->m_file << endl << "]" << endl;
+    pTracer->m_file.close();
+
+    stringstream str;
+    str << "Measures saved (" << pTracer->m_ulNbLostEvents << " lost)";
+    ATHENA_LOG_EVENT(str.str());
+
+    delete pTracer;
+}
+
+//-----------------------------------------------------------------------
+
+void Tracer::_record(const char* strName, unsigned long ulStart, unsigned long ulEnd)
+{
+    // Declarations
+    tBuffer*        pBuffer = pThreadBuffer;
+    unsigned int    uiWriteIndex;
+
+    // The first measure of a thread creates its buffer
+    if (!pBuffer)
+    {
+        pBuffer = new tBuffer();
+        pBuffer->uiWriteIndex   = 0;
+        pBuffer->uiReadIndex    = 0;
+        pBuffer->ulThreadID     = Thread::getCurrentThreadID();
+
+        buffersMutex.lock();
+        buffers.push_back(pBuffer);
+        buffersMutex.unlock();
+
+        pThreadBuffer = pBuffer;
+    }
+
+    uiWriteIndex = pBuffer->uiWriteIndex;
+
+    tEvent& event = pBuffer->events[uiWriteIndex & (BUFFER_CAPACITY - 1)];
+
+    event.strName       = strName;
+    event.ulStart       = ulStart;
+    event.ulDuration    = ulEnd - ulStart;
+
+    // Publish the measure once it is complete
+    Thread::memoryBarrier();
+    pBuffer->uiWriteIndex = uiWriteIndex + 1;
+}
+
+//-----------------------------------------------------------------------
+
+void Tracer::run()
+{
+    while (true)
+    {
+        flush();
+
+        for (unsigned int uiElapsed = 0; uiElapsed < m_uiInterval; uiElapsed += SLEEP_GRANULARITY)
+        {
+            m_mutex.lock();
+            bool bStop = m_bStop;
+            m_mutex.unlock();
+
+            if (bStop)
+                return;
+
+            Thread::sleep(SLEEP_GRANULARITY);
+        }
+    }
+}
+
+
+/*********************************** INTERNAL METHODS **********************************/
+
+void Tracer::flush()
+{
+    // Declarations
+    vector<tBuffer*>::iterator  iter, iterEnd;
+    vector<tEvent>              events;
+    unsigned int                uiWriteIndex;
+    unsigned int                uiNbEvents;
+    unsigned int                uiNbOverwritten;
+    unsigned int                i;
+
+    events.reserve(BUFFER_CAPACITY);
+
+    ScopedLock lock(buffersMutex);
+
+    for (iter = buffers.begin(), iterEnd = buffers.end(); iter != iterEnd; ++iter)
+    {
+        tBuffer* pBuffer = *iter;
+
+        uiWriteIndex = pBuffer->uiWriteIndex;
+        Thread::memoryBarrier();
+
+        // Skip the measures already overwritten (the slot being written counts as
+        // overwritten)
+        if (uiWriteIndex - pBuffer->uiReadIndex >= BUFFER_CAPACITY)
+        {
+            m_ulNbLostEvents += uiWriteIndex - pBuffer->uiReadIndex - (BUFFER_CAPACITY - 1);
+            pBuffer->uiReadIndex = uiWriteIndex - (BUFFER_CAPACITY - 1);
+        }
+
+        uiNbEvents = uiWriteIndex - pBuffer->uiReadIndex;
+
+        events.clear();
+        for (i = 0; i < uiNbEvents; ++i)
+            events.push_back(pBuffer->events[(pBuffer->uiReadIndex + i) & (BUFFER_CAPACITY - 1)]);
+
+        // Discard the measures overwritten by the thread during the copy
+        Thread::memoryBarrier();
+        uiWriteIndex = pBuffer->uiWriteIndex;
+
+        uiNbOverwritten = 0;
+        if (uiWriteIndex - pBuffer->uiReadIndex >= BUFFER_CAPACITY)
+            uiNbOverwritten = uiWriteIndex - pBuffer->uiReadIndex - (BUFFER_CAPACITY - 1);
+
+        if (uiNbOverwritten > uiNbEvents)
+            uiNbOverwritten = uiNbEvents;
+
+        m_ulNbLostEvents += uiNbOverwritten;
+        pBuffer->uiReadIndex += uiNbEvents;
+
+        for (i = uiNbOverwritten; i < uiNbEvents; ++i)
+        {
+            const tEvent& event = events[i];
+
+            // Measure started before the tracer
+            if ((long) (event.ulStart - m_ulOrigin) < 0)
+                continue;
+
+            m_file << (m_bFirstEvent ? "" : ",") << endl
+                   << "{\"name\":\"" << event.strName << "\",\"cat\":\"inputs\",\"ph\":\"X\""
+                   << ",\"pid\":1,\"tid\":" << pBuffer->ulThreadID
+                   << ",\"ts\":" << (event.ulStart - m_ulOrigin)
+                   << ",\"dur\":" << event.ulDuration << "}";
+
+            m_bFirstEvent = false;
+        }
+    }
+
+    m_file.flush();
+}
+
+#endif
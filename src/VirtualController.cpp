@@ -9,13 +9,22 @@
 #include <Athena-Inputs/IVirtualEventsListener.h>
 #include <Athena-Inputs/InputsUnit.h>
 #include <Athena-Inputs/Controller.h>
+#include <Athena-Inputs/ComboRecognizer.h>
+#include <Athena-Inputs/Tracing.h>
 #include <Athena-Core/Log/LogManager.h>
-#include <Athena-Math/MathUtils.h>
+#include <math.h>
+#include <set>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 1))
+#   include <xmmintrin.h>
+#   define ATHENA_INPUTS_SSE 1
+#else
+#   define ATHENA_INPUTS_SSE 0
+#endif
 
 
 using namespace Athena;
 using namespace Athena::Inputs;
-using namespace Athena::Math;
 using namespace Athena::Log;
 using namespace std;
 
@@ -26,17 +35,300 @@ using namespace std;
 static const char* __CONTEXT__ = "Virtual controller";
 
 
+/*********************************** AXES CONDITIONING *********************************/
+
+/// Initialise the conditioning of an axis with the default values
+static void initAxisConditioning(tAxisConditioning &conditioning, int iRange)
+{
+    conditioning.iRange         = iRange;
+    conditioning.fDeadZone      = 0.0f;
+    conditioning.fSaturation    = 1.0f;
+    conditioning.fCurve         = 0.0f;
+    conditioning.fScale         = 1.0f;
+    conditioning.bInverted      = false;
+    conditioning.radialPair     = 0;
+}
+
+//-----------------------------------------------------------------------
+
+/// Returns the normalized value of an axis, in [-1, 1]
+static inline float normalizeAxisValue(const tVirtualAxis* pVirtualAxis)
+{
+    float fValue = (float) pVirtualAxis->iValue / (float) pVirtualAxis->conditioning.iRange;
+
+    return (fValue < -1.0f ? -1.0f : (fValue > 1.0f ? 1.0f : fValue));
+}
+
+//-----------------------------------------------------------------------
+
+/// Condition a batch of axes. All the arrays must contain 'uiCount' elements, 'uiCount'
+/// being a multiple of 4.
+///
+/// For each axis:
+///     magnitude = sqrt(value^2 + pairedValue^2)           (pairedValue = 0 if axial)
+///     t         = clamp((magnitude - deadZone) * invRange, 0, 1)
+///     t         = t + curve * (t^3 - t)
+///     result    = clamp(value / magnitude * t * scale, -1, 1)
+static void conditionAxesBatch(const float* pValues, const float* pPairedValues,
+                               const float* pDeadZones, const float* pInvRanges,
+                               const float* pCurves, const float* pScales,
+                               float* pResults, unsigned int uiCount)
+{
+#if ATHENA_INPUTS_SSE
+    const __m128 zero       = _mm_setzero_ps();
+    const __m128 one        = _mm_set1_ps(1.0f);
+    const __m128 minusOne   = _mm_set1_ps(-1.0f);
+    const __m128 epsilon    = _mm_set1_ps(1e-6f);
+
+    for (unsigned int i = 0; i < uiCount; i += 4)
+    {
+        __m128 value        = _mm_loadu_ps(pValues + i);
+        __m128 pairedValue  = _mm_loadu_ps(pPairedValues + i);
+
+        __m128 magnitude    = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(value, value),
+                                                     _mm_mul_ps(pairedValue, pairedValue)));
+
+        __m128 t = _mm_mul_ps(_mm_sub_ps(magnitude, _mm_loadu_ps(pDeadZones + i)),
+                              _mm_loadu_ps(pInvRanges + i));
+        t = _mm_min_ps(_mm_max_ps(t, zero), one);
+
+        __m128 t3 = _mm_mul_ps(_mm_mul_ps(t, t), t);
+        t = _mm_add_ps(t, _mm_mul_ps(_mm_loadu_ps(pCurves + i), _mm_sub_ps(t3, t)));
+
+        __m128 result = _mm_div_ps(value, _mm_max_ps(magnitude, epsilon));
+        result = _mm_mul_ps(_mm_mul_ps(result, t), _mm_loadu_ps(pScales + i));
+        result = _mm_min_ps(_mm_max_ps(result, minusOne), one);
+
+        _mm_storeu_ps(pResults + i, result);
+    }
+#else
+    for (unsigned int i = 0; i < uiCount; ++i)
+    {
+        float fMagnitude = sqrtf(pValues[i] * pValues[i] + pPairedValues[i] * pPairedValues[i]);
+
+        float t = (fMagnitude - pDeadZones[i]) * pInvRanges[i];
+        t = (t < 0.0f ? 0.0f : (t > 1.0f ? 1.0f : t));
+        t = t + pCurves[i] * (t * t * t - t);
+
+        float fResult = pValues[i] / (fMagnitude > 1e-6f ? fMagnitude : 1e-6f) * t * pScales[i];
+        pResults[i] = (fResult < -1.0f ? -1.0f : (fResult > 1.0f ? 1.0f : fResult));
+    }
+#endif
+}
+
+
+/************************************* AXES CHANGES ************************************/
+
+/// Returns the bucket of a value (rounded towards minus infinity)
+static inline int getAxisBucket(int iValue, int iStep)
+{
+    return (iValue >= 0 ? iValue / iStep : -((-iValue + iStep - 1) / iStep));
+}
+
+//-----------------------------------------------------------------------
+
+/// Indicates if the new value of a virtual axis made from a real axis must be reported,
+/// according to its policy
+static inline bool isAxisChangeReported(const tVirtualAxis* pVirtualAxis, int iValue)
+{
+    int iDelta;
+
+    switch (pVirtualAxis->changePolicy)
+    {
+    case AXIS_CHANGE_THRESHOLD:
+        iDelta = iValue - pVirtualAxis->iReportedValue;
+        return ((iDelta < 0 ? -iDelta : iDelta) >= pVirtualAxis->iChangeStep);
+
+    case AXIS_CHANGE_QUANTIZED:
+        return (getAxisBucket(iValue, pVirtualAxis->iChangeStep) !=
+                getAxisBucket(pVirtualAxis->iReportedValue, pVirtualAxis->iChangeStep));
+
+    default:
+        return true;
+    }
+}
+
+
+/*********************************** POV COMPOSITION **********************************/
+
+/// Bits of the state of a virtual POV made from keys (see tVirtualPOVRealPartKeys), in
+/// addition to the directions held (POV_UP, POV_DOWN, POV_RIGHT and POV_LEFT)
+static const unsigned int POV_LAST_DOWN = 0x10;     ///< DOWN was pressed after UP
+static const unsigned int POV_LAST_LEFT = 0x20;     ///< LEFT was pressed after RIGHT
+
+/// Position of a virtual POV for each combination of the directions engaged and of the
+/// bits above: when two opposite directions are held, the one pressed last wins
+static const tPOVPosition POV_POSITIONS[64] =
+{
+    // RIGHT was pressed after LEFT, UP after DOWN
+    POV_CENTER, POV_UP,         POV_DOWN,       POV_UP,
+    POV_RIGHT,  POV_UPRIGHT,    POV_DOWNRIGHT,  POV_UPRIGHT,
+    POV_LEFT,   POV_UPLEFT,     POV_DOWNLEFT,   POV_UPLEFT,
+    POV_RIGHT,  POV_UPRIGHT,    POV_DOWNRIGHT,  POV_UPRIGHT,
+
+    // RIGHT was pressed after LEFT, DOWN after UP
+    POV_CENTER, POV_UP,         POV_DOWN,       POV_DOWN,
+    POV_RIGHT,  POV_UPRIGHT,    POV_DOWNRIGHT,  POV_DOWNRIGHT,
+    POV_LEFT,   POV_UPLEFT,     POV_DOWNLEFT,   POV_DOWNLEFT,
+    POV_RIGHT,  POV_UPRIGHT,    POV_DOWNRIGHT,  POV_DOWNRIGHT,
+
+    // LEFT was pressed after RIGHT, UP after DOWN
+    POV_CENTER, POV_UP,         POV_DOWN,       POV_UP,
+    POV_RIGHT,  POV_UPRIGHT,    POV_DOWNRIGHT,  POV_UPRIGHT,
+    POV_LEFT,   POV_UPLEFT,     POV_DOWNLEFT,   POV_UPLEFT,
+    POV_LEFT,   POV_UPLEFT,     POV_DOWNLEFT,   POV_UPLEFT,
+
+    // LEFT was pressed after RIGHT, DOWN after UP
+    POV_CENTER, POV_UP,         POV_DOWN,       POV_DOWN,
+    POV_RIGHT,  POV_UPRIGHT,    POV_DOWNRIGHT,  POV_DOWNRIGHT,
+    POV_LEFT,   POV_UPLEFT,     POV_DOWNLEFT,   POV_DOWNLEFT,
+    POV_LEFT,   POV_UPLEFT,     POV_DOWNLEFT,   POV_DOWNLEFT,
+};
+
+//-----------------------------------------------------------------------
+
+/// Returns the state of a virtual POV made from keys after the press or the release of
+/// some directions
+static inline unsigned int updateHeldDirections(unsigned int uiHeld, unsigned int uiDirections,
+                                                bool bPressed)
+{
+    if (!bPressed)
+        return (uiHeld & ~uiDirections);
+
+    if (uiDirections & POV_UP)
+        uiHeld &= ~POV_LAST_DOWN;
+    else if (uiDirections & POV_DOWN)
+        uiHeld |= POV_LAST_DOWN;
+
+    if (uiDirections & POV_RIGHT)
+        uiHeld &= ~POV_LAST_LEFT;
+    else if (uiDirections & POV_LEFT)
+        uiHeld |= POV_LAST_LEFT;
+
+    return (uiHeld | uiDirections);
+}
+
+//-----------------------------------------------------------------------
+
+/// Returns the index of the state of a virtual part in a list sorted by virtual ID (the
+/// size of the list if not found)
+static unsigned int findState(const std::vector<tVirtualEvent>& states, tVirtualID virtualID)
+{
+    // Declarations
+    unsigned int uiMin = 0;
+    unsigned int uiMax = (unsigned int) states.size();
+    unsigned int uiMiddle;
+
+    while (uiMin < uiMax)
+    {
+        uiMiddle = (uiMin + uiMax) / 2;
+
+        if (states[uiMiddle].virtualID < virtualID)
+            uiMin = uiMiddle + 1;
+        else
+            uiMax = uiMiddle;
+    }
+
+    if ((uiMin < states.size()) && (states[uiMin].virtualID == virtualID))
+        return uiMin;
+
+    return (unsigned int) states.size();
+}
+
+//-----------------------------------------------------------------------
+
+/// Compute the directions engaged by a batch of virtual POVs made from axes. All the
+/// arrays must contain 'uiCount' elements.
+///
+/// A direction is engaged when the value of its axis reaches the threshold, and stays
+/// engaged until the value goes below (threshold - hysteresis). There is no branch in
+/// the loop, so the compiler can vectorize it.
+static void composePOVsBatch(const int* pUpDownValues, const int* pLeftRightValues,
+                             const int* pThresholds, const int* pHysteresis,
+                             const unsigned int* pPreviousMasks, unsigned int* pMasks,
+                             unsigned int uiCount)
+{
+    for (unsigned int i = 0; i < uiCount; ++i)
+    {
+        unsigned int uiPrevious = pPreviousMasks[i];
+
+        // The hysteresis only lowers the thresholds of the directions already engaged
+        int iUp     = pThresholds[i] - (pHysteresis[i] & -(int) (uiPrevious & 1));
+        int iDown   = pThresholds[i] - (pHysteresis[i] & -(int) ((uiPrevious >> 1) & 1));
+        int iRight  = pThresholds[i] - (pHysteresis[i] & -(int) ((uiPrevious >> 2) & 1));
+        int iLeft   = pThresholds[i] - (pHysteresis[i] & -(int) ((uiPrevious >> 3) & 1));
+
+        pMasks[i] = ((unsigned int) (pUpDownValues[i] <= -iUp) * POV_UP) |
+                    ((unsigned int) (pUpDownValues[i] >= iDown) * POV_DOWN) |
+                    ((unsigned int) (pLeftRightValues[i] >= iRight) * POV_RIGHT) |
+                    ((unsigned int) (pLeftRightValues[i] <= -iLeft) * POV_LEFT);
+    }
+}
+
+
 /****************************** CONSTRUCTION / DESTRUCTION *****************************/
 
 VirtualController::VirtualController()
-: m_pEventsListener(0), m_bEnabled(true)
+: m_virtualKeys(std::less<tVirtualID>(), tVirtualKeysList::allocator_type(&m_arena)),
+  m_keySources(std::less<tVirtualID>(), tKeySourcesList::allocator_type(&m_arena)),
+  m_virtualAxes(std::less<tVirtualID>(), tVirtualAxesList::allocator_type(&m_arena)),
+  m_virtualPOVs(std::less<tVirtualID>(), tVirtualPOVsList::allocator_type(&m_arena)),
+  m_povShortcuts(std::less<tVirtualID>(), tPOVShortcutsList::allocator_type(&m_arena)),
+  m_pEventsListener(0), m_bEnabled(true), m_uiGeneration(0), m_bStaleParts(false),
+  m_bEventsQueueEnabled(false),
+  m_bTransitionsLogEnabled(false), m_ulFrameStartTimestamp(0), m_ulFrameEndTimestamp(0),
+  m_bAllPartsDirty(false), m_pComboRecognizer(0), m_uiNbChordBits(0), m_uiHeldChordKeys(0),
+  m_bNotifyingRepeat(false), m_ulNbVirtualEvents(0), m_ulNbCoalescedEvents(0)
 {
+    m_comboState.uiNode         = 0;
+    m_comboState.uiLastSymbol   = 0;
+    m_comboState.ulTimestamp    = 0;
+    m_comboState.uiEpoch        = 0;
 }
 
 //-----------------------------------------------------------------------
 
 VirtualController::~VirtualController()
 {
+    // Declarations
+    tKeySourcesList::iterator                       iterSource, iterSourceEnd;
+    tVirtualAxesList::iterator                      iterAxis, iterAxisEnd;
+    tVirtualPOVsList::iterator                      iterPOV, iterPOVEnd;
+    std::vector<tChord>::iterator                   iterChord, iterChordEnd;
+    std::vector<tChordKey>::iterator                iterChordKey, iterChordKeyEnd;
+
+    // Release the real controllers
+    for (iterSource = m_keySources.begin(), iterSourceEnd = m_keySources.end();
+         iterSource != iterSourceEnd; ++iterSource)
+    {
+        if (iterSource->second.pController)
+            InputsUnit::getSingletonPtr()->_releaseController(iterSource->second.pController);
+    }
+
+    for (iterAxis = m_virtualAxes.begin(), iterAxisEnd = m_virtualAxes.end();
+         iterAxis != iterAxisEnd; ++iterAxis)
+    {
+        if (iterAxis->second.pController)
+            InputsUnit::getSingletonPtr()->_releaseController(iterAxis->second.pController);
+    }
+
+    for (iterPOV = m_virtualPOVs.begin(), iterPOVEnd = m_virtualPOVs.end();
+         iterPOV != iterPOVEnd; ++iterPOV)
+    {
+        if (iterPOV->second.pController)
+            InputsUnit::getSingletonPtr()->_releaseController(iterPOV->second.pController);
+    }
+
+    for (iterChord = m_chords.begin(), iterChordEnd = m_chords.end();
+         iterChord != iterChordEnd; ++iterChord)
+    {
+        for (iterChordKey = iterChord->keys.begin(), iterChordKeyEnd = iterChord->keys.end();
+             iterChordKey != iterChordKeyEnd; ++iterChordKey)
+        {
+            if (iterChordKey->pController)
+                InputsUnit::getSingletonPtr()->_releaseController(iterChordKey->pController);
+        }
+    }
 }
 
 
@@ -45,39 +337,118 @@ VirtualController::~VirtualController()
 void VirtualController::process(std::deque<tInputEvent> &events)
 {
     // Declarations
-    std::map<tVirtualID, tVirtualKey>::iterator     iterKey, iterKeyEnd;
-    std::map<tVirtualID, tVirtualAxis>::iterator    iterAxis, iterAxisEnd;
-    std::map<tVirtualID, tVirtualPOV>::iterator     iterPOV, iterPOVEnd;
+    tVirtualKeysList::iterator                      iterKey, iterKeyEnd;
+    tKeySourcesList::iterator                       iterSource, iterSourceEnd;
+    tVirtualAxesList::iterator                      iterAxis, iterAxisEnd;
+    tVirtualPOVsList::iterator                      iterPOV, iterPOVEnd;
     tVirtualKey*                                    pVirtualKey;
     tVirtualAxis*                                   pVirtualAxis;
     tVirtualPOV*                                    pVirtualPOV;
     tVirtualEvent                                   event;
+    tPOVPosition                                    position;
+    unsigned int                                    uiDirections;
     tInputEvent*                                    pEvent;
     std::deque<tInputEvent>::iterator               iter, iterEnd;
+    std::vector<tVirtualKey*>::iterator             iterDirtyKey, iterDirtyKeyEnd;
+    std::vector<tVirtualAxis*>::iterator            iterDirtyAxis, iterDirtyAxisEnd;
+    std::vector<tVirtualPOV*>::iterator             iterDirtyPOV, iterDirtyPOVEnd;
+    bool                                            bAllPartsReset;
+
+    ATHENA_INPUTS_TRACE_SCOPE("VirtualController::process");
+
+    // Empty the events queue (its memory is kept for the next frames)
+    m_eventsQueue.clear();
+
+    // The new frame starts where the previous one ended
+    m_ulFrameStartTimestamp = m_ulFrameEndTimestamp;
+    m_ulFrameEndTimestamp   = Controller::getTimestamp();
+
+    if (m_ulFrameStartTimestamp == 0)
+        m_ulFrameStartTimestamp = m_ulFrameEndTimestamp;
 
     // If the virtual controller isn't enabled, we're done
     if (!m_bEnabled)
+    {
+        m_transitions.clear();
         return;
+    }
 
-    // Reset some values
-    for (iterKey = m_virtualKeys.begin(), iterKeyEnd = m_virtualKeys.end();
-         iterKey != iterKeyEnd; ++iterKey)
+    // Reset the virtual parts modified during the previous frame
+    bAllPartsReset = m_bAllPartsDirty;
+
+    if (m_bAllPartsDirty)
     {
-        iterKey->second.bToggled = false;
-    }
+        for (iterKey = m_virtualKeys.begin(), iterKeyEnd = m_virtualKeys.end();
+             iterKey != iterKeyEnd; ++iterKey)
+        {
+            validateVirtualKey(&iterKey->second);
+            resetVirtualKey(&iterKey->second);
+        }
 
-    for (iterAxis = m_virtualAxes.begin(), iterAxisEnd = m_virtualAxes.end();
-         iterAxis != iterAxisEnd; ++iterAxis)
+        for (iterAxis = m_virtualAxes.begin(), iterAxisEnd = m_virtualAxes.end();
+             iterAxis != iterAxisEnd; ++iterAxis)
+        {
+            validateVirtualAxis(&iterAxis->second);
+            resetVirtualAxis(&iterAxis->second);
+        }
+
+        for (iterPOV = m_virtualPOVs.begin(), iterPOVEnd = m_virtualPOVs.end();
+             iterPOV != iterPOVEnd; ++iterPOV)
+        {
+            validateVirtualPOV(&iterPOV->second);
+            resetVirtualPOV(&iterPOV->second);
+        }
+
+        m_bAllPartsDirty    = false;
+        m_bStaleParts       = false;
+    }
+    else
     {
-        iterAxis->second.bChanged = false;
-        if (iterAxis->second.pController && (iterAxis->second.pController->getType() == OIS::OISMouse))
-            iterAxis->second.iValue = 0;
+        for (iterDirtyKey = m_dirtyKeys.begin(), iterDirtyKeyEnd = m_dirtyKeys.end();
+             iterDirtyKey != iterDirtyKeyEnd; ++iterDirtyKey)
+        {
+            resetVirtualKey(*iterDirtyKey);
+        }
+
+        for (iterDirtyAxis = m_dirtyAxes.begin(), iterDirtyAxisEnd = m_dirtyAxes.end();
+             iterDirtyAxis != iterDirtyAxisEnd; ++iterDirtyAxis)
+        {
+            resetVirtualAxis(*iterDirtyAxis);
+        }
+
+        for (iterDirtyPOV = m_dirtyPOVs.begin(), iterDirtyPOVEnd = m_dirtyPOVs.end();
+             iterDirtyPOV != iterDirtyPOVEnd; ++iterDirtyPOV)
+        {
+            resetVirtualPOV(*iterDirtyPOV);
+        }
     }
 
-    for (iterPOV = m_virtualPOVs.begin(), iterPOVEnd = m_virtualPOVs.end();
-         iterPOV != iterPOVEnd; ++iterPOV)
+    m_dirtyKeys.clear();
+    m_dirtyAxes.clear();
+    m_dirtyPOVs.clear();
+
+    // Keep the state at the beginning of the frame
+    if (m_bTransitionsLogEnabled)
+        updateFrameStartStates(bAllPartsReset || m_bStaleParts);
+
+    m_transitions.clear();
+
+    // Keep the timers of the hold thresholds up to date
+    if (!m_holdThresholds.empty())
+        processHoldThresholds(m_ulFrameStartTimestamp);
+
+    if (!m_keyRepeats.empty())
+        processKeyRepeats(m_ulFrameStartTimestamp);
+
+    // Release the combos recognized during the previous frame
+    if (!m_pulsedKeys.empty())
+        releasePulsedKeys();
+
+    // Update the automaton if some combos were added since the last frame
+    if (m_pComboRecognizer && !m_pComboRecognizer->isCompiled())
     {
-        iterPOV->second.bChanged = false;
+        m_pComboRecognizer->compile();
+        m_pComboRecognizer->reset(m_comboState);
     }
 
 
@@ -91,13 +462,14 @@ void VirtualController::process(std::deque<tInputEvent> &events)
         {
         case PART_KEY:
             // Search in the list of keys registered on this virtual controller
-            for (iterKey = m_virtualKeys.begin(), iterKeyEnd = m_virtualKeys.end();
-                iterKey != iterKeyEnd; ++iterKey)
+            for (iterSource = m_keySources.begin(), iterSourceEnd = m_keySources.end();
+                iterSource != iterSourceEnd; ++iterSource)
             {
-                pVirtualKey = &iterKey->second;
-                if ((pEvent->pController == pVirtualKey->pController) &&
-                    (pEvent->partID.key == pVirtualKey->key))
+                if ((pEvent->pController == iterSource->second.pController) &&
+                    (pEvent->partID.key == iterSource->second.key))
                 {
+                    pVirtualKey = getVirtualKey(iterSource->first);
+
                     pVirtualKey->bToggled       = true;
                     pVirtualKey->bPressed       = pEvent->value.bPressed;
                     if (pVirtualKey->bPressed)
@@ -105,15 +477,12 @@ void VirtualController::process(std::deque<tInputEvent> &events)
                     else
                         pVirtualKey->ulReleaseTimestamp = pEvent->ulTimeStamp;
 
-                    if (m_pEventsListener)
-                    {
-                        event.part              = PART_KEY;
-                        event.virtualID         = iterKey->first;
-                        event.value.bPressed    = pVirtualKey->bPressed;
-                        event.ulTimestamp       = pEvent->ulTimeStamp;
+                    event.part              = PART_KEY;
+                    event.virtualID         = iterSource->first;
+                    event.value.bPressed    = pVirtualKey->bPressed;
+                    event.ulTimestamp       = pEvent->ulTimeStamp;
 
-                        m_pEventsListener->onEvent(&event);
-                    }
+                    fireEvent(event);
 
                     break;
                 }
@@ -130,169 +499,32 @@ void VirtualController::process(std::deque<tInputEvent> &events)
                      (pEvent->partID.key == pVirtualPOV->realPart.keys.keyLeft) ||
                      (pEvent->partID.key == pVirtualPOV->realPart.keys.keyRight)))
                 {
-                    pVirtualPOV->previousPosition = pVirtualPOV->position;
+                    validateVirtualPOV(pVirtualPOV);
 
-                    if (pEvent->partID.key == pVirtualPOV->realPart.keys.keyUp)
-                    {
-                        if (pEvent->value.bPressed)
-                        {
-                            switch (pVirtualPOV->position)
-                            {
-                            case POV_LEFT:
-                            case POV_DOWNLEFT:
-                                pVirtualPOV->position = POV_UPLEFT;
-                                break;
-
-                            case POV_RIGHT:
-                            case POV_DOWNRIGHT:
-                                pVirtualPOV->position = POV_UPRIGHT;
-                                break;
-
-                            default:
-                                pVirtualPOV->position = POV_UP;
-                            }
-                        }
-                        else
-                        {
-                            switch (pVirtualPOV->position)
-                            {
-                            case POV_UPLEFT:
-                                pVirtualPOV->position = POV_LEFT;
-                                break;
-
-                            case POV_UPRIGHT:
-                                pVirtualPOV->position = POV_RIGHT;
-                                break;
-
-                            case POV_UP:
-                                pVirtualPOV->position = POV_CENTER;
-                            }
-                        }
-                    }
-                    else if (pEvent->partID.key == pVirtualPOV->realPart.keys.keyDown)
-                    {
-                        if (pEvent->value.bPressed)
-                        {
-                            switch (pVirtualPOV->position)
-                            {
-                            case POV_LEFT:
-                            case POV_UPLEFT:
-                                pVirtualPOV->position = POV_DOWNLEFT;
-                                break;
-
-                            case POV_RIGHT:
-                            case POV_UPRIGHT:
-                                pVirtualPOV->position = POV_DOWNRIGHT;
-                                break;
-
-                            default:
-                                pVirtualPOV->position = POV_DOWN;
-                            }
-                        }
-                        else
-                        {
-                            switch (pVirtualPOV->position)
-                            {
-                            case POV_DOWNLEFT:
-                                pVirtualPOV->position = POV_LEFT;
-                                break;
-
-                            case POV_DOWNRIGHT:
-                                pVirtualPOV->position = POV_RIGHT;
-                                break;
-
-                            case POV_DOWN:
-                                pVirtualPOV->position = POV_CENTER;
-                            }
-                        }
-                    }
-                    else if (pEvent->partID.key == pVirtualPOV->realPart.keys.keyLeft)
-                    {
-                        if (pEvent->value.bPressed)
-                        {
-                            switch (pVirtualPOV->position)
-                            {
-                            case POV_UP:
-                            case POV_UPRIGHT:
-                                pVirtualPOV->position = POV_UPLEFT;
-                                break;
-
-                            case POV_DOWN:
-                            case POV_DOWNRIGHT:
-                                pVirtualPOV->position = POV_DOWNLEFT;
-                                break;
-
-                            default:
-                                pVirtualPOV->position = POV_LEFT;
-                            }
-                        }
-                        else
-                        {
-                            switch (pVirtualPOV->position)
-                            {
-                            case POV_DOWNLEFT:
-                                pVirtualPOV->position = POV_DOWN;
-                                break;
-
-                            case POV_UPLEFT:
-                                pVirtualPOV->position = POV_UP;
-                                break;
-
-                            case POV_LEFT:
-                                pVirtualPOV->position = POV_CENTER;
-                            }
-                        }
-                    }
-                    else if (pEvent->partID.key == pVirtualPOV->realPart.keys.keyRight)
-                    {
-                        if (pEvent->value.bPressed)
-                        {
-                            switch (pVirtualPOV->position)
-                            {
-                            case POV_UP:
-                            case POV_UPLEFT:
-                                pVirtualPOV->position = POV_UPRIGHT;
-                                break;
-
-                            case POV_DOWN:
-                            case POV_DOWNLEFT:
-                                pVirtualPOV->position = POV_DOWNRIGHT;
-                                break;
-
-                            default:
-                                pVirtualPOV->position = POV_RIGHT;
-                            }
-                        }
-                        else
-                        {
-                            switch (pVirtualPOV->position)
-                            {
-                            case POV_DOWNRIGHT:
-                                pVirtualPOV->position = POV_DOWN;
-                                break;
-
-                            case POV_UPRIGHT:
-                                pVirtualPOV->position = POV_UP;
-                                break;
-
-                            case POV_RIGHT:
-                                pVirtualPOV->position = POV_CENTER;
-                            }
-                        }
-                    }
+                    uiDirections = ((unsigned int) (pEvent->partID.key == pVirtualPOV->realPart.keys.keyUp) * POV_UP) |
+                                   ((unsigned int) (pEvent->partID.key == pVirtualPOV->realPart.keys.keyDown) * POV_DOWN) |
+                                   ((unsigned int) (pEvent->partID.key == pVirtualPOV->realPart.keys.keyRight) * POV_RIGHT) |
+                                   ((unsigned int) (pEvent->partID.key == pVirtualPOV->realPart.keys.keyLeft) * POV_LEFT);
+
+                    pVirtualPOV->realPart.keys.uiHeld = updateHeldDirections(pVirtualPOV->realPart.keys.uiHeld,
+                                                                             uiDirections, pEvent->value.bPressed);
+
+                    position = POV_POSITIONS[pVirtualPOV->realPart.keys.uiHeld];
+                    if (position == pVirtualPOV->position)
+                        break;
+
+                    pVirtualPOV->previousPosition           = pVirtualPOV->position;
+                    pVirtualPOV->position                   = position;
                     pVirtualPOV->ulPreviousChangeTimestamp  = pVirtualPOV->ulLastChangeTimestamp;
                     pVirtualPOV->ulLastChangeTimestamp      = pEvent->ulTimeStamp;
                     pVirtualPOV->bChanged                   = true;
 
-                    if (m_pEventsListener)
-                    {
-                        event.part              = PART_POV;
-                        event.virtualID         = iterPOV->first;
-                        event.value.position    = pVirtualPOV->position;
-                        event.ulTimestamp       = pEvent->ulTimeStamp;
+                    event.part              = PART_POV;
+                    event.virtualID         = iterPOV->first;
+                    event.value.position    = pVirtualPOV->position;
+                    event.ulTimestamp       = pEvent->ulTimeStamp;
 
-                        m_pEventsListener->onEvent(&event);
-                    }
+                    fireEvent(event);
 
                     break;
                 }
@@ -307,6 +539,8 @@ void VirtualController::process(std::deque<tInputEvent> &events)
                     ((pEvent->partID.key == pVirtualAxis->realPart.keys.keyMin) ||
                      (pEvent->partID.key == pVirtualAxis->realPart.keys.keyMax)))
                 {
+                    validateVirtualAxis(pVirtualAxis);
+
                     if (pEvent->value.bPressed)
                     {
                         if (pEvent->partID.key == pVirtualAxis->realPart.keys.keyMin)
@@ -327,21 +561,23 @@ void VirtualController::process(std::deque<tInputEvent> &events)
                     }
 
                     pVirtualAxis->ulTimestamp   = pEvent->ulTimeStamp;
+                    queueAxis(pVirtualAxis);
 
-                    if (m_pEventsListener)
-                    {
-                        event.part          = PART_AXIS;
-                        event.virtualID     = iterAxis->first;
-                        event.value.iValue  = pVirtualAxis->iValue;
-                        event.ulTimestamp   = pEvent->ulTimeStamp;
+                    event.part          = PART_AXIS;
+                    event.virtualID     = iterAxis->first;
+                    event.value.iValue  = pVirtualAxis->iValue;
+                    event.ulTimestamp   = pEvent->ulTimeStamp;
 
-                        m_pEventsListener->onEvent(&event);
-                    }
+                    fireEvent(event);
 
                     // Don't break, because the other direction can be used for another axis
                     //break;
                 }
             }
+
+            // Update the chords
+            if (!m_chords.empty())
+                processChordKey(pEvent);
             break;
 
         case PART_AXIS:
@@ -352,20 +588,44 @@ void VirtualController::process(std::deque<tInputEvent> &events)
                 if ((pVirtualAxis->part == PART_AXIS) && (pEvent->pController == pVirtualAxis->pController) &&
                     (pEvent->partID.axis == pVirtualAxis->realPart.axis))
                 {
-                    pVirtualAxis->bChanged = (MathUtils::Abs(pVirtualAxis->iValue - pEvent->value.iValue) >= 10.0f);
+                    validateVirtualAxis(pVirtualAxis);
+
+                    // The movements of a mouse are relative: they are summed over the frame
+                    if (pVirtualAxis->pController->getType() == OIS::OISMouse)
+                        pVirtualAxis->iValue += pEvent->value.iValue;
+                    else
+                        pVirtualAxis->iValue = pEvent->value.iValue;
 
-                    pVirtualAxis->iValue        = pEvent->value.iValue;
                     pVirtualAxis->ulTimestamp   = pEvent->ulTimeStamp;
+                    queueAxis(pVirtualAxis);
+
+                    event.part          = PART_AXIS;
+                    event.virtualID     = iterAxis->first;
+                    event.value.iValue  = pVirtualAxis->iValue;
+                    event.ulTimestamp   = pEvent->ulTimeStamp;
 
-                    if (m_pEventsListener)
+                    // The events of a mouse carry the movement since the last reported
+                    // one, the sum of the frame is only available from the state of the
+                    // virtual axis
+                    if (pVirtualAxis->pController->getType() == OIS::OISMouse)
+                        event.value.iValue = pVirtualAxis->iValue - pVirtualAxis->iReportedValue;
+
+                    if (isAxisChangeReported(pVirtualAxis, pVirtualAxis->iValue))
+                    {
+                        pVirtualAxis->bChanged          = true;
+                        pVirtualAxis->iReportedValue    = pVirtualAxis->iValue;
+
+                        fireEvent(event);
+                    }
+                    else
                     {
-                        event.part          = PART_AXIS;
-                        event.virtualID     = iterAxis->first;
-                        event.value.iValue  = pVirtualAxis->iValue;
-                        event.ulTimestamp   = pEvent->ulTimeStamp;
+                        ++m_ulNbCoalescedEvents;
 
-                        m_pEventsListener->onEvent(&event);
+                        // The movements of a mouse must be reset even if not reported
+                        if (!m_bAllPartsDirty)
+                            markDirty(event);
                     }
+
                     break;
                 }
             }
@@ -379,52 +639,17 @@ void VirtualController::process(std::deque<tInputEvent> &events)
                     ((pEvent->partID.axis == pVirtualPOV->realPart.axes.axisUpDown) ||
                      (pEvent->partID.axis == pVirtualPOV->realPart.axes.axisLeftRight)))
                 {
+                    validateVirtualPOV(pVirtualPOV);
+
                     if (pEvent->partID.axis == pVirtualPOV->realPart.axes.axisUpDown)
                         pVirtualPOV->realPart.axes.iUpDownPos = pEvent->value.iValue;
                     else
                         pVirtualPOV->realPart.axes.iLeftRightPos = pEvent->value.iValue;
 
-                    if (pVirtualPOV->realPart.axes.iUpDownPos <= -100)
-                    {
-                        if (pVirtualPOV->realPart.axes.iLeftRightPos <= -100)
-                            pVirtualPOV->realPart.axes.tempPosition = POV_UPLEFT;
-                        else if (pVirtualPOV->realPart.axes.iLeftRightPos >= 100)
-                            pVirtualPOV->realPart.axes.tempPosition = POV_UPRIGHT;
-                        else
-                            pVirtualPOV->realPart.axes.tempPosition = POV_UP;
-                    }
-                    else if (pVirtualPOV->realPart.axes.iUpDownPos >= 100)
-                    {
-                        if (pVirtualPOV->realPart.axes.iLeftRightPos <= -100)
-                            pVirtualPOV->realPart.axes.tempPosition = POV_DOWNLEFT;
-                        else if (pVirtualPOV->realPart.axes.iLeftRightPos >= 100)
-                            pVirtualPOV->realPart.axes.tempPosition = POV_DOWNRIGHT;
-                        else
-                            pVirtualPOV->realPart.axes.tempPosition = POV_DOWN;
-                    }
-                    else
-                    {
-                        if (pVirtualPOV->realPart.axes.iLeftRightPos <= -100)
-                            pVirtualPOV->realPart.axes.tempPosition = POV_LEFT;
-                        else if (pVirtualPOV->realPart.axes.iLeftRightPos >= 100)
-                            pVirtualPOV->realPart.axes.tempPosition = POV_RIGHT;
-                        else
-                            pVirtualPOV->realPart.axes.tempPosition = POV_CENTER;
-                    }
-
-                    pVirtualPOV->ulPreviousChangeTimestamp  = pVirtualPOV->ulLastChangeTimestamp;
-                    pVirtualPOV->ulLastChangeTimestamp      = pEvent->ulTimeStamp;
-                    pVirtualPOV->bChanged                   = true;
-
-                    if (m_pEventsListener)
-                    {
-                        event.part              = PART_POV;
-                        event.virtualID         = iterPOV->first;
-                        event.value.position    = pVirtualPOV->position;
-                        event.ulTimestamp       = pEvent->ulTimeStamp;
+                    pVirtualPOV->realPart.axes.ulTimestamp = pEvent->ulTimeStamp;
 
-                        m_pEventsListener->onEvent(&event);
-                    }
+                    // The position is computed at the end of the frame
+                    queuePOV(iterPOV->first, pVirtualPOV);
 
                     break;
                 }
@@ -441,21 +666,20 @@ void VirtualController::process(std::deque<tInputEvent> &events)
                 if ((pVirtualPOV->part == PART_POV) && (pEvent->pController == pVirtualPOV->pController) &&
                     (pEvent->partID.pov == pVirtualPOV->realPart.pov))
                 {
+                    validateVirtualPOV(pVirtualPOV);
+
                     pVirtualPOV->previousPosition           = pVirtualPOV->position;
                     pVirtualPOV->position                   = pEvent->value.position;
                     pVirtualPOV->ulPreviousChangeTimestamp  = pVirtualPOV->ulLastChangeTimestamp;
                     pVirtualPOV->ulLastChangeTimestamp      = pEvent->ulTimeStamp;
                     pVirtualPOV->bChanged                   = true;
 
-                    if (m_pEventsListener)
-                    {
-                        event.part              = PART_POV;
-                        event.virtualID         = iterPOV->first;
-                        event.value.position    = pVirtualPOV->position;
-                        event.ulTimestamp       = pEvent->ulTimeStamp;
+                    event.part              = PART_POV;
+                    event.virtualID         = iterPOV->first;
+                    event.value.position    = pVirtualPOV->position;
+                    event.ulTimestamp       = pEvent->ulTimeStamp;
 
-                        m_pEventsListener->onEvent(&event);
-                    }
+                    fireEvent(event);
 
                     break;
                 }
@@ -469,6 +693,8 @@ void VirtualController::process(std::deque<tInputEvent> &events)
                 if ((pVirtualAxis->part == PART_POV) && (pEvent->pController == pVirtualAxis->pController) &&
                     (pEvent->partID.pov == pVirtualAxis->realPart.pov.pov))
                 {
+                    validateVirtualAxis(pVirtualAxis);
+
                     if (pVirtualAxis->realPart.pov.bUpDown)
                     {
                         if (pEvent->value.position & POV_UP)
@@ -507,16 +733,14 @@ void VirtualController::process(std::deque<tInputEvent> &events)
                     }
 
                     pVirtualAxis->ulTimestamp   = pEvent->ulTimeStamp;
+                    queueAxis(pVirtualAxis);
 
-                    if (m_pEventsListener)
-                    {
-                        event.part          = PART_AXIS;
-                        event.virtualID     = iterAxis->first;
-                        event.value.iValue  = pVirtualAxis->iValue;
-                        event.ulTimestamp   = pEvent->ulTimeStamp;
+                    event.part          = PART_AXIS;
+                    event.virtualID     = iterAxis->first;
+                    event.value.iValue  = pVirtualAxis->iValue;
+                    event.ulTimestamp   = pEvent->ulTimeStamp;
 
-                        m_pEventsListener->onEvent(&event);
-                    }
+                    fireEvent(event);
 
                     // Don't break, because the other direction can be used for another axis
                     //break;
@@ -527,103 +751,1394 @@ void VirtualController::process(std::deque<tInputEvent> &events)
     }
 
 
-    for (iterPOV = m_virtualPOVs.begin(), iterPOVEnd = m_virtualPOVs.end();
-        iterPOV != iterPOVEnd; ++iterPOV)
-    {
-        pVirtualPOV = &iterPOV->second;
+    // Compute the positions of the virtual POVs made from the axes which moved
+    if (!m_povsBatch.povs.empty())
+        composePOVs();
 
-        if ((pVirtualPOV->part == PART_AXIS) && (pVirtualPOV->realPart.axes.tempPosition != pVirtualPOV->position))
-        {
-            pVirtualPOV->previousPosition   = pVirtualPOV->position;
-            pVirtualPOV->position           = pVirtualPOV->realPart.axes.tempPosition;
+    // Fire the hold thresholds reached during the frame
+    if (!m_holdThresholds.empty())
+        processHoldThresholds(m_ulFrameEndTimestamp);
 
-            if (m_pEventsListener)
-            {
-                event.part              = PART_POV;
-                event.virtualID         = iterPOV->first;
-                event.value.position    = pVirtualPOV->position;
-                event.ulTimestamp       = pVirtualPOV->ulLastChangeTimestamp;
+    // Fire the repeats of the held keys
+    if (!m_keyRepeats.empty())
+        processKeyRepeats(m_ulFrameEndTimestamp);
 
-                m_pEventsListener->onEvent(&event);
-            }
-        }
-    }
+    // Compute the conditioned values of the modified axes
+    if (!m_modifiedAxes.empty())
+        conditionAxes();
 }
 
 //-----------------------------------------------------------------------
 
-void VirtualController::setEventsListener(IVirtualEventsListener* pEventsListener)
+void VirtualController::fireEvent(tVirtualEvent &event)
 {
-    m_pEventsListener = pEventsListener;
+    // Declarations
+    const tVirtualID*   pCombos;
+    unsigned int        uiNbCombos;
+
+    notifyEvent(event);
+
+    if (!m_pComboRecognizer)
+        return;
+
+    // Advance the automaton of the combos
+    uiNbCombos = m_pComboRecognizer->advance(m_comboState, event, pCombos);
+
+    // The virtual keys of the combos are pressed until the next frame
+    for (unsigned int i = 0; i < uiNbCombos; ++i)
+        pulseKey(pCombos[i], event.ulTimestamp);
 }
 
 //-----------------------------------------------------------------------
 
-void VirtualController::enable(bool bEnable)
+void VirtualController::notifyEvent(tVirtualEvent &event)
 {
-    // Declarations
-    std::map<tVirtualID, tVirtualKey>::iterator     iterKey, iterKeyEnd;
-    std::map<tVirtualID, tVirtualAxis>::iterator    iterAxis, iterAxisEnd;
-    std::map<tVirtualID, tVirtualPOV>::iterator     iterPOV, iterPOVEnd;
+    ++m_ulNbVirtualEvents;
 
-    if (bEnable)
+    // Update the timers of the key (the ones reached before a release are fired first)
+    if ((event.part == PART_KEY) && !m_bNotifyingRepeat)
     {
-        m_bEnabled = true;
+        if (!m_holdThresholdsByKey.empty())
+            updateHoldThresholds(event);
 
-        for (iterKey = m_virtualKeys.begin(), iterKeyEnd = m_virtualKeys.end();
-            iterKey != iterKeyEnd; ++iterKey)
-        {
-            if (iterKey->second.pController)
-                iterKey->second.pController->activate();
-        }
+        if (!m_keyRepeats.empty())
+            updateKeyRepeat(event);
+    }
 
-        for (iterAxis = m_virtualAxes.begin(), iterAxisEnd = m_virtualAxes.end();
-            iterAxis != iterAxisEnd; ++iterAxis)
-        {
-            if (iterAxis->second.pController)
-                iterAxis->second.pController->activate();
-        }
+    // Remember the virtual part, to reset it at the beginning of the next frame
+    if (!m_bAllPartsDirty)
+        markDirty(event);
 
-        for (iterPOV = m_virtualPOVs.begin(), iterPOVEnd = m_virtualPOVs.end();
-            iterPOV != iterPOVEnd; ++iterPOV)
-        {
-            if (iterPOV->second.pController)
-                iterPOV->second.pController->activate();
-        }
-    }
-    else
-    {
-        m_bEnabled = false;
+    if (m_bEventsQueueEnabled)
+        m_eventsQueue.push_back(event);
 
-        for (iterKey = m_virtualKeys.begin(), iterKeyEnd = m_virtualKeys.end();
-            iterKey != iterKeyEnd; ++iterKey)
-        {
-            iterKey->second.bToggled = false;
-            iterKey->second.bPressed = false;
-        }
+    if (m_bTransitionsLogEnabled)
+        m_transitions.push_back(event);
 
-        for (iterAxis = m_virtualAxes.begin(), iterAxisEnd = m_virtualAxes.end();
-            iterAxis != iterAxisEnd; ++iterAxis)
-        {
-            iterAxis->second.bChanged   = false;
-            iterAxis->second.iValue     = 0;
-        }
+    if (m_pEventsListener)
+    {
+        ATHENA_INPUTS_TRACE_SCOPE("IVirtualEventsListener::onEvent");
+        m_pEventsListener->onEvent(&event);
+    }
 
-        for (iterPOV = m_virtualPOVs.begin(), iterPOVEnd = m_virtualPOVs.end();
-            iterPOV != iterPOVEnd; ++iterPOV)
+    for (unsigned int i = 0; i < m_subscribers.size(); ++i)
+    {
+        if (m_subscribers[i].filter.accepts(event))
         {
-            iterPOV->second.position            = POV_CENTER;
-            iterPOV->second.previousPosition    = POV_CENTER;
+            ATHENA_INPUTS_TRACE_SCOPE("IVirtualEventsListener::onEvent");
+            m_subscribers[i].pListener->onEvent(&event);
         }
     }
 }
 
 //-----------------------------------------------------------------------
 
-bool VirtualController::isEnabled()
+void VirtualController::processChordKey(tInputEvent* pEvent)
 {
-    return m_bEnabled;
-}
+    // Declarations
+    tChordBitsList::iterator            iterBits;
+    unsigned int                        uiBit;
+
+    iterBits = m_chordBits.find(pEvent->pController);
+    if (iterBits == m_chordBits.end())
+        return;
+
+    uiBit = iterBits->second[pEvent->partID.key];
+    if (uiBit == 0)
+        return;
+
+    --uiBit;
+
+    if (pEvent->value.bPressed)
+        m_uiHeldChordKeys |= (1u << uiBit);
+    else
+        m_uiHeldChordKeys &= ~(1u << uiBit);
+
+    // Only the chords using the key can change of satisfaction, and only their subsets
+    // can change of specificity
+    const std::vector<unsigned int>& chords = m_chordsByBit[uiBit];
+
+    for (unsigned int i = 0; i < chords.size(); ++i)
+    {
+        const tChord& chord = m_chords[chords[i]];
+
+        updateChord(chords[i], pEvent->ulTimeStamp);
+
+        for (unsigned int j = 0; j < chord.subsets.size(); ++j)
+            updateChord(chord.subsets[j], pEvent->ulTimeStamp);
+    }
+}
+
+//-----------------------------------------------------------------------
+
+void VirtualController::updateChord(unsigned int uiChord, unsigned long ulTimestamp)
+{
+    // Declarations
+    tVirtualKey*    pVirtualKey;
+    tVirtualEvent   event;
+    bool            bActive;
+
+    tChord& chord = m_chords[uiChord];
+
+    bActive = ((m_uiHeldChordKeys & chord.uiMask) == chord.uiMask);
+
+    // The most specific chord wins
+    for (unsigned int i = 0; bActive && (i < chord.supersets.size()); ++i)
+    {
+        unsigned int uiMask = m_chords[chord.supersets[i]].uiMask;
+        if ((m_uiHeldChordKeys & uiMask) == uiMask)
+            bActive = false;
+    }
+
+    if (bActive == chord.bActive)
+        return;
+
+    chord.bActive = bActive;
+
+    pVirtualKey = getVirtualKey(chord.virtualID);
+    if (!pVirtualKey)
+        return;
+
+    pVirtualKey->bToggled = true;
+    pVirtualKey->bPressed = bActive;
+    if (bActive)
+        pVirtualKey->ulPressTimestamp   = ulTimestamp;
+    else
+        pVirtualKey->ulReleaseTimestamp = ulTimestamp;
+
+    event.part              = PART_KEY;
+    event.virtualID         = chord.virtualID;
+    event.value.bPressed    = bActive;
+    event.ulTimestamp       = ulTimestamp;
+
+    fireEvent(event);
+}
+
+//-----------------------------------------------------------------------
+
+void VirtualController::rebuildChords()
+{
+    // Declarations
+    unsigned int                            uiNbChords = (unsigned int) m_chords.size();
+    tChordBitsList                          previousBits;
+    tChordBitsList::iterator                iterBits, iterBitsEnd, iterPrevious;
+    std::vector<tChordKey>::const_iterator  iterKey, iterKeyEnd;
+    unsigned int                            uiHeldChordKeys = 0;
+
+    // Allocate the bits again from the chords, so the ones of the real keys not used
+    // anymore are reclaimed
+    previousBits.swap(m_chordBits);
+    m_uiNbChordBits = 0;
+
+    for (unsigned int i = 0; i < uiNbChords; ++i)
+    {
+        tChord& chord = m_chords[i];
+
+        chord.uiMask = 0;
+
+        // A chord using a key of an unplugged controller can't be satisfied anymore
+        for (iterKey = chord.keys.begin(), iterKeyEnd = chord.keys.end(); iterKey != iterKeyEnd; ++iterKey)
+        {
+            if (!iterKey->pController)
+                break;
+        }
+
+        if (iterKey != iterKeyEnd)
+            continue;
+
+        for (iterKey = chord.keys.begin(), iterKeyEnd = chord.keys.end(); iterKey != iterKeyEnd; ++iterKey)
+        {
+            std::vector<unsigned char>& bits = m_chordBits[iterKey->pController];
+            if (bits.empty())
+                bits.resize(256, 0);
+
+            if (bits[iterKey->key] == 0)
+            {
+                assert(m_uiNbChordBits < MAX_CHORD_KEYS);
+                bits[iterKey->key] = (unsigned char) ++m_uiNbChordBits;
+            }
+
+            chord.uiMask |= (1u << (bits[iterKey->key] - 1));
+        }
+    }
+
+    // The real keys held keep their state
+    for (iterBits = m_chordBits.begin(), iterBitsEnd = m_chordBits.end(); iterBits != iterBitsEnd; ++iterBits)
+    {
+        iterPrevious = previousBits.find(iterBits->first);
+        if (iterPrevious == previousBits.end())
+            continue;
+
+        for (unsigned int uiKey = 0; uiKey < 256; ++uiKey)
+        {
+            unsigned int uiBit          = iterBits->second[uiKey];
+            unsigned int uiPreviousBit  = iterPrevious->second[uiKey];
+
+            if ((uiBit != 0) && (uiPreviousBit != 0) && (m_uiHeldChordKeys & (1u << (uiPreviousBit - 1))))
+                uiHeldChordKeys |= (1u << (uiBit - 1));
+        }
+    }
+
+    m_uiHeldChordKeys = uiHeldChordKeys;
+
+    for (unsigned int uiBit = 0; uiBit < MAX_CHORD_KEYS; ++uiBit)
+        m_chordsByBit[uiBit].clear();
+
+    for (unsigned int i = 0; i < uiNbChords; ++i)
+    {
+        tChord& chord = m_chords[i];
+
+        chord.subsets.clear();
+        chord.supersets.clear();
+
+        if (chord.uiMask == 0)
+            continue;
+
+        for (unsigned int uiBit = 0; uiBit < MAX_CHORD_KEYS; ++uiBit)
+        {
+            if (chord.uiMask & (1u << uiBit))
+                m_chordsByBit[uiBit].push_back(i);
+        }
+
+        for (unsigned int j = 0; j < uiNbChords; ++j)
+        {
+            unsigned int uiOtherMask = m_chords[j].uiMask;
+
+            if ((j == i) || (uiOtherMask == 0) || (uiOtherMask == chord.uiMask))
+                continue;
+
+            if ((uiOtherMask & chord.uiMask) == uiOtherMask)
+                chord.subsets.push_back(j);
+            else if ((uiOtherMask & chord.uiMask) == chord.uiMask)
+                chord.supersets.push_back(j);
+        }
+    }
+}
+
+//-----------------------------------------------------------------------
+
+void VirtualController::markDirty(const tVirtualEvent& event)
+{
+    // Declarations
+    tVirtualKey*    pVirtualKey;
+    tVirtualAxis*   pVirtualAxis;
+    tVirtualPOV*    pVirtualPOV;
+
+    // Consecutive events on the same virtual part are only recorded once
+    switch (event.part)
+    {
+    case PART_KEY:
+        pVirtualKey = getVirtualKey(event.virtualID);
+        if (pVirtualKey && (m_dirtyKeys.empty() || (m_dirtyKeys.back() != pVirtualKey)))
+            m_dirtyKeys.push_back(pVirtualKey);
+        break;
+
+    case PART_AXIS:
+        pVirtualAxis = getVirtualAxis(event.virtualID);
+        if (pVirtualAxis && (m_dirtyAxes.empty() || (m_dirtyAxes.back() != pVirtualAxis)))
+            m_dirtyAxes.push_back(pVirtualAxis);
+        break;
+
+    case PART_POV:
+        pVirtualPOV = getVirtualPOV(event.virtualID);
+        if (pVirtualPOV && (m_dirtyPOVs.empty() || (m_dirtyPOVs.back() != pVirtualPOV)))
+            m_dirtyPOVs.push_back(pVirtualPOV);
+        break;
+    }
+}
+
+//-----------------------------------------------------------------------
+
+void VirtualController::resetVirtualKey(tVirtualKey* pVirtualKey)
+{
+    pVirtualKey->bToggled = false;
+}
+
+//-----------------------------------------------------------------------
+
+void VirtualController::resetVirtualAxis(tVirtualAxis* pVirtualAxis)
+{
+    pVirtualAxis->bChanged = false;
+
+    // The relative axes of the mice sum the movements of the frame
+    if ((pVirtualAxis->part == PART_AXIS) && pVirtualAxis->pController &&
+        (pVirtualAxis->pController->getType() == OIS::OISMouse))
+    {
+        pVirtualAxis->iValue            = 0;
+        pVirtualAxis->fValue            = 0.0f;
+        pVirtualAxis->iReportedValue    = 0;
+    }
+}
+
+//-----------------------------------------------------------------------
+
+void VirtualController::resetVirtualPOV(tVirtualPOV* pVirtualPOV)
+{
+    pVirtualPOV->bChanged = false;
+}
+
+//-----------------------------------------------------------------------
+
+void VirtualController::pulseKey(tVirtualID virtualID, unsigned long ulTimestamp)
+{
+    // Declarations
+    tVirtualKey*    pVirtualKey;
+    tVirtualEvent   event;
+
+    pVirtualKey = getVirtualKey(virtualID);
+    if (pVirtualKey)
+    {
+        pVirtualKey->bPressed           = true;
+        pVirtualKey->bToggled           = true;
+        pVirtualKey->ulPressTimestamp   = ulTimestamp;
+
+        m_pulsedKeys.push_back(virtualID);
+    }
+
+    event.part              = PART_KEY;
+    event.virtualID         = virtualID;
+    event.value.bPressed    = true;
+    event.ulTimestamp       = ulTimestamp;
+
+    notifyEvent(event);
+}
+
+//-----------------------------------------------------------------------
+
+void VirtualController::updateHoldThresholds(const tVirtualEvent& event)
+{
+    // Declarations
+    tHoldThresholdsList::iterator       iter;
+    std::vector<unsigned int>::iterator iterIndex, iterIndexEnd;
+
+    iter = m_holdThresholdsByKey.find(event.virtualID);
+    if (iter == m_holdThresholdsByKey.end())
+        return;
+
+    // Fire the thresholds reached before the release
+    if (!event.value.bPressed)
+        processHoldThresholds(event.ulTimestamp);
+
+    for (iterIndex = iter->second.begin(), iterIndexEnd = iter->second.end();
+         iterIndex != iterIndexEnd; ++iterIndex)
+    {
+        tHoldThreshold& threshold = m_holdThresholds[*iterIndex];
+
+        m_holdTimers.cancel(threshold.timer);
+        threshold.timer = TimerWheel::INVALID_TIMER;
+
+        if (event.value.bPressed)
+            threshold.timer = m_holdTimers.schedule(event.ulTimestamp + threshold.uiDuration, *iterIndex);
+    }
+}
+
+//-----------------------------------------------------------------------
+
+void VirtualController::processHoldThresholds(unsigned long ulTimestamp)
+{
+    // Declarations
+    std::vector<TimerWheel::tExpiredTimer>::iterator    iter, iterEnd;
+    tVirtualKey*                                        pVirtualKey;
+
+    m_expiredTimers.clear();
+    m_holdTimers.advance(ulTimestamp, m_expiredTimers);
+
+    for (iter = m_expiredTimers.begin(), iterEnd = m_expiredTimers.end(); iter != iterEnd; ++iter)
+    {
+        tHoldThreshold& threshold = m_holdThresholds[iter->uiData];
+
+        threshold.timer = TimerWheel::INVALID_TIMER;
+
+        // Ignore the thresholds of the keys released before the deadline (the release
+        // being processed counts as after it), or without event (detached)
+        pVirtualKey = getVirtualKey(threshold.virtualKey);
+        if (!pVirtualKey ||
+            (pVirtualKey->ulPressTimestamp + threshold.uiDuration != iter->ulDeadline) ||
+            (!pVirtualKey->bPressed && (pVirtualKey->ulReleaseTimestamp < iter->ulDeadline)))
+        {
+            continue;
+        }
+
+        pulseKey(threshold.thresholdID, iter->ulDeadline);
+    }
+}
+
+//-----------------------------------------------------------------------
+
+void VirtualController::rebuildHoldThresholds()
+{
+    // Declarations
+    tVirtualKey* pVirtualKey;
+
+    m_holdTimers.clear();
+    m_holdThresholdsByKey.clear();
+
+    for (unsigned int i = 0; i < m_holdThresholds.size(); ++i)
+    {
+        tHoldThreshold& threshold = m_holdThresholds[i];
+
+        m_holdThresholdsByKey[threshold.virtualKey].push_back(i);
+
+        // Arm the thresholds of the held keys not reached yet
+        threshold.timer = TimerWheel::INVALID_TIMER;
+
+        pVirtualKey = getVirtualKey(threshold.virtualKey);
+        if (pVirtualKey && pVirtualKey->bPressed &&
+            (pVirtualKey->ulPressTimestamp + threshold.uiDuration > m_ulFrameEndTimestamp))
+        {
+            threshold.timer = m_holdTimers.schedule(pVirtualKey->ulPressTimestamp + threshold.uiDuration, i);
+        }
+    }
+}
+
+//-----------------------------------------------------------------------
+
+void VirtualController::configureKeyRepeat(tVirtualID virtualKey, unsigned int uiDelay,
+                                           unsigned int uiInterval, bool bTurbo)
+{
+    // Declarations
+    tKeyRepeatsList::iterator   iter;
+    tVirtualKey*                pVirtualKey;
+    unsigned long               ulDeadline;
+
+    iter = m_keyRepeats.find(virtualKey);
+    if (iter != m_keyRepeats.end())
+    {
+        m_repeatTimers.cancel(iter->second.timer);
+
+        if (uiInterval == 0)
+        {
+            m_keyRepeats.erase(iter);
+            return;
+        }
+    }
+    else if (uiInterval == 0)
+    {
+        return;
+    }
+
+    tKeyRepeat& repeat = m_keyRepeats[virtualKey];
+
+    repeat.uiDelay      = uiDelay;
+    repeat.uiInterval   = uiInterval;
+    repeat.bTurbo       = bTurbo;
+    repeat.bHeld        = false;
+    repeat.timer        = TimerWheel::INVALID_TIMER;
+
+    // Start the repeats if the key is already held
+    pVirtualKey = getVirtualKey(virtualKey);
+    if (pVirtualKey && pVirtualKey->bPressed)
+    {
+        ulDeadline = pVirtualKey->ulPressTimestamp + uiDelay;
+        if (ulDeadline <= m_ulFrameEndTimestamp)
+            ulDeadline = m_ulFrameEndTimestamp + uiInterval;
+
+        repeat.bHeld = true;
+        repeat.timer = m_repeatTimers.schedule(ulDeadline, virtualKey);
+    }
+}
+
+//-----------------------------------------------------------------------
+
+void VirtualController::updateKeyRepeat(const tVirtualEvent& event)
+{
+    // Declarations
+    tKeyRepeatsList::iterator iter;
+
+    iter = m_keyRepeats.find(event.virtualID);
+    if (iter == m_keyRepeats.end())
+        return;
+
+    if (event.value.bPressed)
+    {
+        if (iter->second.bHeld)
+            return;
+
+        iter->second.bHeld = true;
+        iter->second.timer = m_repeatTimers.schedule(event.ulTimestamp + iter->second.uiDelay,
+                                                     event.virtualID);
+    }
+    else
+    {
+        // Fire the repeats scheduled before the release
+        processKeyRepeats(event.ulTimestamp);
+
+        iter = m_keyRepeats.find(event.virtualID);
+        if (iter == m_keyRepeats.end())
+            return;
+
+        m_repeatTimers.cancel(iter->second.timer);
+        iter->second.bHeld = false;
+        iter->second.timer = TimerWheel::INVALID_TIMER;
+    }
+}
+
+//-----------------------------------------------------------------------
+
+void VirtualController::stopKeyRepeat(tVirtualID virtualKey)
+{
+    // Declarations
+    tKeyRepeatsList::iterator iter;
+
+    iter = m_keyRepeats.find(virtualKey);
+    if (iter == m_keyRepeats.end())
+        return;
+
+    m_repeatTimers.cancel(iter->second.timer);
+    iter->second.bHeld = false;
+    iter->second.timer = TimerWheel::INVALID_TIMER;
+}
+
+//-----------------------------------------------------------------------
+
+void VirtualController::processKeyRepeats(unsigned long ulTimestamp)
+{
+    m_expiredRepeats.clear();
+    m_repeatTimers.advance(ulTimestamp, m_expiredRepeats);
+
+    // The next repeats are scheduled while processing the expired ones: process them too
+    // until the timestamp is reached (when the interval is shorter than the frame)
+    while (!m_expiredRepeats.empty())
+    {
+        processExpiredRepeats();
+
+        m_expiredRepeats.clear();
+        m_repeatTimers.advance(ulTimestamp, m_expiredRepeats);
+    }
+}
+
+//-----------------------------------------------------------------------
+
+void VirtualController::processExpiredRepeats()
+{
+    // Declarations
+    std::vector<TimerWheel::tExpiredTimer>::iterator    iterExpired, iterExpiredEnd;
+    tKeyRepeatsList::iterator                           iter;
+    tVirtualKey*                                        pVirtualKey;
+    tVirtualEvent                                       event;
+    bool                                                bReleasing;
+
+    for (iterExpired = m_expiredRepeats.begin(), iterExpiredEnd = m_expiredRepeats.end();
+         iterExpired != iterExpiredEnd; ++iterExpired)
+    {
+        iter = m_keyRepeats.find(iterExpired->uiData);
+        if ((iter == m_keyRepeats.end()) || !iter->second.bHeld)
+            continue;
+
+        tKeyRepeat& repeat = iter->second;
+
+        pVirtualKey = getVirtualKey(iter->first);
+        if (!pVirtualKey)
+            continue;
+
+        // The release of the key may be being notified (its state is already updated)
+        bReleasing = !pVirtualKey->bPressed && (pVirtualKey->ulReleaseTimestamp >= pVirtualKey->ulPressTimestamp);
+
+        event.part          = PART_KEY;
+        event.virtualID     = iter->first;
+        event.ulTimestamp   = iterExpired->ulDeadline;
+
+        if (repeat.bTurbo)
+        {
+            if (bReleasing)
+                continue;
+
+            pVirtualKey->bPressed = !pVirtualKey->bPressed;
+            pVirtualKey->bToggled = true;
+
+            event.value.bPressed = pVirtualKey->bPressed;
+        }
+        else
+        {
+            if (!bReleasing)
+                pVirtualKey->bToggled = true;
+
+            event.value.bPressed = true;
+        }
+
+        repeat.timer = m_repeatTimers.schedule(iterExpired->ulDeadline + repeat.uiInterval, iter->first);
+
+        m_bNotifyingRepeat = true;
+        notifyEvent(event);
+        m_bNotifyingRepeat = false;
+    }
+}
+
+//-----------------------------------------------------------------------
+
+void VirtualController::setPOVShortcuts(tVirtualID virtualPOV, const std::string& strShortcutUp,
+                                        const std::string& strShortcutDown,
+                                        const std::string& strShortcutLeft,
+                                        const std::string& strShortcutRight)
+{
+    // Assertions
+    assert(InputsUnit::getSingletonPtr());
+
+    if (strShortcutUp.empty())
+    {
+        m_povShortcuts.erase(virtualPOV);
+        return;
+    }
+
+    InputsUnit* pInputsUnit = InputsUnit::getSingletonPtr();
+
+    pInputsUnit->registerShortcut(strShortcutUp, virtualPOV);
+    pInputsUnit->registerShortcut(strShortcutDown, virtualPOV);
+    pInputsUnit->registerShortcut(strShortcutLeft, virtualPOV);
+    pInputsUnit->registerShortcut(strShortcutRight, virtualPOV);
+
+    pInputsUnit->registerShortcut(strShortcutUp + strShortcutLeft, virtualPOV);
+    pInputsUnit->registerShortcut(strShortcutDown + strShortcutLeft, virtualPOV);
+    pInputsUnit->registerShortcut(strShortcutUp + strShortcutRight, virtualPOV);
+    pInputsUnit->registerShortcut(strShortcutDown + strShortcutRight, virtualPOV);
+
+    tVirtualPOVShortcuts& shortcuts = m_povShortcuts[virtualPOV];
+
+    shortcuts.strShortcutUp     = strShortcutUp;
+    shortcuts.strShortcutDown   = strShortcutDown;
+    shortcuts.strShortcutLeft   = strShortcutLeft;
+    shortcuts.strShortcutRight  = strShortcutRight;
+}
+//-----------------------------------------------------------------------
+
+void VirtualController::releasePulsedKeys()
+{
+    // Declarations
+    std::vector<tVirtualID>::iterator   iter, iterEnd;
+    tVirtualKey*                        pVirtualKey;
+    tVirtualEvent                       event;
+
+    for (iter = m_pulsedKeys.begin(), iterEnd = m_pulsedKeys.end(); iter != iterEnd; ++iter)
+    {
+        pVirtualKey = getVirtualKey(*iter);
+        if (!pVirtualKey || !pVirtualKey->bPressed)
+            continue;
+
+        pVirtualKey->bPressed           = false;
+        pVirtualKey->bToggled           = true;
+        pVirtualKey->ulReleaseTimestamp = pVirtualKey->ulPressTimestamp;
+
+        event.part              = PART_KEY;
+        event.virtualID         = *iter;
+        event.value.bPressed    = false;
+        event.ulTimestamp       = pVirtualKey->ulReleaseTimestamp;
+
+        notifyEvent(event);
+    }
+
+    m_pulsedKeys.clear();
+}
+
+//-----------------------------------------------------------------------
+
+template<typename T>
+void VirtualController::replaceReference(const T* pPreviousPart, Controller* pController)
+{
+    // Assertions
+    assert(InputsUnit::getSingletonPtr());
+
+    // Retain the new real controller before releasing the previous one, so a controller
+    // bound again isn't deactivated in-between
+    if (pController)
+        InputsUnit::getSingletonPtr()->_retainController(pController);
+
+    if (pPreviousPart && pPreviousPart->pController)
+        InputsUnit::getSingletonPtr()->_releaseController(pPreviousPart->pController);
+}
+
+//-----------------------------------------------------------------------
+
+void VirtualController::conditionAxes()
+{
+    // Declarations
+    tVirtualAxis*   pPairedAxis;
+    unsigned int    uiCount;
+
+    if (m_modifiedAxes.empty())
+        return;
+
+    // The paired axes of the modified ones are modified too (radial dead zones)
+    uiCount = (unsigned int) m_modifiedAxes.size();
+    for (unsigned int i = 0; i < uiCount; ++i)
+    {
+        if (m_modifiedAxes[i]->conditioning.radialPair != 0)
+        {
+            pPairedAxis = getVirtualAxis(m_modifiedAxes[i]->conditioning.radialPair);
+            if (pPairedAxis)
+                queueAxis(pPairedAxis);
+        }
+    }
+
+    // Condition them, and remove them from the queue
+    uiCount = (unsigned int) m_modifiedAxes.size();
+    conditionAxes(&m_modifiedAxes[0], uiCount);
+
+    for (unsigned int i = 0; i < uiCount; ++i)
+        m_modifiedAxes[i]->bQueued = false;
+
+    m_modifiedAxes.clear();
+}
+
+//-----------------------------------------------------------------------
+
+void VirtualController::conditionAxes(tVirtualAxis* const* pAxes, unsigned int uiCount)
+{
+    // Declarations
+    tVirtualAxis*   pVirtualAxis;
+    tVirtualAxis*   pPairedAxis;
+    unsigned int    uiPaddedCount;
+
+    // Fill the packed arrays (the size is rounded to a multiple of 4, the padding
+    // elements produce 0)
+    uiPaddedCount = (uiCount + 3) & ~3;
+
+    m_axesBatch.values.resize(uiPaddedCount);
+    m_axesBatch.pairedValues.resize(uiPaddedCount);
+    m_axesBatch.deadZones.resize(uiPaddedCount);
+    m_axesBatch.invRanges.resize(uiPaddedCount);
+    m_axesBatch.curves.resize(uiPaddedCount);
+    m_axesBatch.scales.resize(uiPaddedCount);
+    m_axesBatch.results.resize(uiPaddedCount);
+
+    for (unsigned int i = 0; i < uiPaddedCount; ++i)
+    {
+        if (i < uiCount)
+        {
+            pVirtualAxis = pAxes[i];
+            const tAxisConditioning& conditioning = pVirtualAxis->conditioning;
+
+            m_axesBatch.values[i]       = normalizeAxisValue(pVirtualAxis);
+            m_axesBatch.pairedValues[i] = 0.0f;
+            m_axesBatch.deadZones[i]    = conditioning.fDeadZone;
+            m_axesBatch.invRanges[i]    = ((conditioning.fSaturation > conditioning.fDeadZone) ?
+                                                1.0f / (conditioning.fSaturation - conditioning.fDeadZone) :
+                                                1e6f);
+            m_axesBatch.curves[i]       = conditioning.fCurve;
+            m_axesBatch.scales[i]       = (conditioning.bInverted ? -conditioning.fScale : conditioning.fScale);
+
+            if (conditioning.radialPair != 0)
+            {
+                pPairedAxis = getVirtualAxis(conditioning.radialPair);
+                if (pPairedAxis)
+                    m_axesBatch.pairedValues[i] = normalizeAxisValue(pPairedAxis);
+            }
+        }
+        else
+        {
+            m_axesBatch.values[i]       = 0.0f;
+            m_axesBatch.pairedValues[i] = 0.0f;
+            m_axesBatch.deadZones[i]    = 0.0f;
+            m_axesBatch.invRanges[i]    = 1.0f;
+            m_axesBatch.curves[i]       = 0.0f;
+            m_axesBatch.scales[i]       = 0.0f;
+        }
+    }
+
+    // Condition the axes
+    conditionAxesBatch(&m_axesBatch.values[0], &m_axesBatch.pairedValues[0],
+                       &m_axesBatch.deadZones[0], &m_axesBatch.invRanges[0],
+                       &m_axesBatch.curves[0], &m_axesBatch.scales[0],
+                       &m_axesBatch.results[0], uiPaddedCount);
+
+    // Store the results
+    for (unsigned int i = 0; i < uiCount; ++i)
+        pAxes[i]->fValue = m_axesBatch.results[i];
+}
+
+//-----------------------------------------------------------------------
+
+void VirtualController::composePOVs()
+{
+    // Declarations
+    tVirtualPOV*    pVirtualPOV;
+    tVirtualEvent   event;
+    tPOVPosition    position;
+    unsigned int    uiCount = (unsigned int) m_povsBatch.povs.size();
+
+    // Fill the packed arrays (the positions are the masks of the directions engaged)
+    m_povsBatch.upDownValues.resize(uiCount);
+    m_povsBatch.leftRightValues.resize(uiCount);
+    m_povsBatch.thresholds.resize(uiCount);
+    m_povsBatch.hysteresis.resize(uiCount);
+    m_povsBatch.previousMasks.resize(uiCount);
+    m_povsBatch.masks.resize(uiCount);
+
+    for (unsigned int i = 0; i < uiCount; ++i)
+    {
+        const tVirtualPOVRealPartAxes& axes = m_povsBatch.povs[i]->realPart.axes;
+
+        m_povsBatch.upDownValues[i]     = axes.iUpDownPos;
+        m_povsBatch.leftRightValues[i]  = axes.iLeftRightPos;
+        m_povsBatch.thresholds[i]       = axes.iThreshold;
+        m_povsBatch.hysteresis[i]       = axes.iHysteresis;
+        m_povsBatch.previousMasks[i]    = m_povsBatch.povs[i]->position;
+    }
+
+    // Compute the directions engaged
+    composePOVsBatch(&m_povsBatch.upDownValues[0], &m_povsBatch.leftRightValues[0],
+                     &m_povsBatch.thresholds[0], &m_povsBatch.hysteresis[0],
+                     &m_povsBatch.previousMasks[0], &m_povsBatch.masks[0], uiCount);
+
+    // Only the virtual POVs which changed of position fire an event
+    for (unsigned int i = 0; i < uiCount; ++i)
+    {
+        pVirtualPOV = m_povsBatch.povs[i];
+        pVirtualPOV->bQueued = false;
+
+        position = POV_POSITIONS[m_povsBatch.masks[i]];
+        if (position == pVirtualPOV->position)
+            continue;
+
+        pVirtualPOV->previousPosition           = pVirtualPOV->position;
+        pVirtualPOV->position                   = position;
+        pVirtualPOV->ulPreviousChangeTimestamp  = pVirtualPOV->ulLastChangeTimestamp;
+        pVirtualPOV->ulLastChangeTimestamp      = pVirtualPOV->realPart.axes.ulTimestamp;
+        pVirtualPOV->bChanged                   = true;
+
+        event.part              = PART_POV;
+        event.virtualID         = m_povsBatch.virtualIDs[i];
+        event.value.position    = position;
+        event.ulTimestamp       = pVirtualPOV->ulLastChangeTimestamp;
+
+        fireEvent(event);
+    }
+
+    m_povsBatch.virtualIDs.clear();
+    m_povsBatch.povs.clear();
+}
+
+//-----------------------------------------------------------------------
+
+const tVirtualEvent* VirtualController::getStateAt(tControllerPart part, tVirtualID virtualID,
+                                                   unsigned long ulTimestamp) const
+{
+    // Declarations
+    const std::vector<tVirtualEvent>*   pFrameStart;
+    unsigned int                        uiIndex;
+
+    // Search the last transition before the moment
+    for (unsigned int i = (unsigned int) m_transitions.size(); i > 0; --i)
+    {
+        const tVirtualEvent& transition = m_transitions[i - 1];
+
+        if ((transition.part == part) && (transition.virtualID == virtualID) &&
+            (transition.ulTimestamp <= ulTimestamp))
+        {
+            return &transition;
+        }
+    }
+
+    // Search the state at the beginning of the frame (sorted by virtual ID)
+    switch (part)
+    {
+    case PART_KEY:  pFrameStart = &m_frameStartKeys; break;
+    case PART_AXIS: pFrameStart = &m_frameStartAxes; break;
+    default:        pFrameStart = &m_frameStartPOVs; break;
+    }
+
+    uiIndex = findState(*pFrameStart, virtualID);
+    if (uiIndex < pFrameStart->size())
+        return &(*pFrameStart)[uiIndex];
+
+    return 0;
+}
+
+//-----------------------------------------------------------------------
+
+void VirtualController::updateFrameStartStates(bool bAllParts)
+{
+    // Declarations
+    tVirtualKeysList::iterator                  iterKey, iterKeyEnd;
+    tVirtualAxesList::iterator                  iterAxis, iterAxisEnd;
+    tVirtualPOVsList::iterator                  iterPOV, iterPOVEnd;
+    std::vector<tVirtualEvent>::const_iterator  iter, iterEnd;
+    tVirtualKey*                                pVirtualKey;
+    tVirtualAxis*                               pVirtualAxis;
+    tVirtualPOV*                                pVirtualPOV;
+    tVirtualEvent                               event;
+    unsigned int                                uiIndex;
+
+    // Only the virtual parts with transitions during the previous frame have changed
+    // (unless some were reset or added since)
+    if (!bAllParts && (m_frameStartKeys.size() == m_virtualKeys.size()) &&
+        (m_frameStartAxes.size() == m_virtualAxes.size()) &&
+        (m_frameStartPOVs.size() == m_virtualPOVs.size()))
+    {
+        for (iter = m_transitions.begin(), iterEnd = m_transitions.end(); iter != iterEnd; ++iter)
+        {
+            switch (iter->part)
+            {
+            case PART_KEY:
+                pVirtualKey = getVirtualKey(iter->virtualID);
+                uiIndex = findState(m_frameStartKeys, iter->virtualID);
+                if (pVirtualKey && (uiIndex < m_frameStartKeys.size()))
+                {
+                    m_frameStartKeys[uiIndex].value.bPressed = pVirtualKey->bPressed;
+                    m_frameStartKeys[uiIndex].ulTimestamp    = m_ulFrameStartTimestamp;
+                }
+                break;
+
+            case PART_AXIS:
+                pVirtualAxis = getVirtualAxis(iter->virtualID);
+                uiIndex = findState(m_frameStartAxes, iter->virtualID);
+                if (pVirtualAxis && (uiIndex < m_frameStartAxes.size()))
+                {
+                    m_frameStartAxes[uiIndex].value.iValue = pVirtualAxis->iValue;
+                    m_frameStartAxes[uiIndex].ulTimestamp  = m_ulFrameStartTimestamp;
+                }
+                break;
+
+            case PART_POV:
+                pVirtualPOV = getVirtualPOV(iter->virtualID);
+                uiIndex = findState(m_frameStartPOVs, iter->virtualID);
+                if (pVirtualPOV && (uiIndex < m_frameStartPOVs.size()))
+                {
+                    m_frameStartPOVs[uiIndex].value.position = pVirtualPOV->position;
+                    m_frameStartPOVs[uiIndex].ulTimestamp    = m_ulFrameStartTimestamp;
+                }
+                break;
+            }
+        }
+
+        return;
+    }
+
+    // Snapshot all the virtual parts (sorted by virtual ID, like the maps)
+    m_frameStartKeys.clear();
+    m_frameStartAxes.clear();
+    m_frameStartPOVs.clear();
+
+    event.ulTimestamp = m_ulFrameStartTimestamp;
+
+    for (iterKey = m_virtualKeys.begin(), iterKeyEnd = m_virtualKeys.end();
+         iterKey != iterKeyEnd; ++iterKey)
+    {
+        validateVirtualKey(&iterKey->second);
+
+        event.part              = PART_KEY;
+        event.virtualID         = iterKey->first;
+        event.value.bPressed    = iterKey->second.bPressed;
+        m_frameStartKeys.push_back(event);
+    }
+
+    for (iterAxis = m_virtualAxes.begin(), iterAxisEnd = m_virtualAxes.end();
+         iterAxis != iterAxisEnd; ++iterAxis)
+    {
+        validateVirtualAxis(&iterAxis->second);
+
+        event.part          = PART_AXIS;
+        event.virtualID     = iterAxis->first;
+        event.value.iValue  = iterAxis->second.iValue;
+        m_frameStartAxes.push_back(event);
+    }
+
+    for (iterPOV = m_virtualPOVs.begin(), iterPOVEnd = m_virtualPOVs.end();
+         iterPOV != iterPOVEnd; ++iterPOV)
+    {
+        validateVirtualPOV(&iterPOV->second);
+
+        event.part              = PART_POV;
+        event.virtualID         = iterPOV->first;
+        event.value.position    = iterPOV->second.position;
+        m_frameStartPOVs.push_back(event);
+    }
+
+    // All the virtual parts were validated
+    m_bStaleParts = false;
+}
+
+//-----------------------------------------------------------------------
+
+void VirtualController::setEventsListener(IVirtualEventsListener* pEventsListener)
+{
+    m_pEventsListener = pEventsListener;
+}
+
+//-----------------------------------------------------------------------
+
+void VirtualController::addEventsListener(IVirtualEventsListener* pEventsListener,
+                                          const VirtualEventsFilter& filter)
+{
+    // Assertions
+    assert(pEventsListener);
+
+    // Declarations
+    std::vector<tSubscriber>::iterator  iter, iterEnd;
+    tSubscriber                         subscriber;
+
+    // Only update the filter if the listener is already registered
+    for (iter = m_subscribers.begin(), iterEnd = m_subscribers.end(); iter != iterEnd; ++iter)
+    {
+        if (iter->pListener == pEventsListener)
+        {
+            iter->filter = filter;
+            return;
+        }
+    }
+
+    subscriber.pListener    = pEventsListener;
+    subscriber.filter       = filter;
+
+    m_subscribers.push_back(subscriber);
+}
+
+//-----------------------------------------------------------------------
+
+void VirtualController::removeEventsListener(IVirtualEventsListener* pEventsListener)
+{
+    // Declarations
+    std::vector<tSubscriber>::iterator  iter, iterEnd;
+
+    for (iter = m_subscribers.begin(), iterEnd = m_subscribers.end(); iter != iterEnd; ++iter)
+    {
+        if (iter->pListener == pEventsListener)
+        {
+            m_subscribers.erase(iter);
+            break;
+        }
+    }
+}
+
+//-----------------------------------------------------------------------
+
+void VirtualController::enableEventsQueue(bool bEnable, unsigned int uiCapacity)
+{
+    m_bEventsQueueEnabled = bEnable;
+    m_eventsQueue.clear();
+
+    if (bEnable)
+        m_eventsQueue.reserve(uiCapacity);
+    else
+        std::vector<tVirtualEvent>().swap(m_eventsQueue);
+}
+
+//-----------------------------------------------------------------------
+
+void VirtualController::enableTransitionsLog(bool bEnable)
+{
+    m_bTransitionsLogEnabled = bEnable;
+    m_transitions.clear();
+    m_frameStartKeys.clear();
+    m_frameStartAxes.clear();
+    m_frameStartPOVs.clear();
+}
+
+//-----------------------------------------------------------------------
+
+void VirtualController::setComboRecognizer(ComboRecognizer* pComboRecognizer)
+{
+    m_pComboRecognizer = pComboRecognizer;
+
+    if (m_pComboRecognizer)
+    {
+        if (!m_pComboRecognizer->isCompiled())
+            m_pComboRecognizer->compile();
+
+        m_pComboRecognizer->reset(m_comboState);
+    }
+}
+
+//-----------------------------------------------------------------------
+
+void VirtualController::enable(bool bEnable)
+{
+    if (bEnable == m_bEnabled)
+        return;
+
+    m_bEnabled = bEnable;
+
+    if (bEnable)
+        return;
+
+    // The state of the virtual parts is reset when they are accessed for the first time
+    ++m_uiGeneration;
+    m_bStaleParts = true;
+
+    // The releases of the held keys will never be seen: forget their timers and chords
+    if (m_repeatTimers.getNbTimers() > 0)
+    {
+        m_repeatTimers.clear();
+
+        for (tKeyRepeatsList::iterator iter = m_keyRepeats.begin(), iterEnd = m_keyRepeats.end();
+             iter != iterEnd; ++iter)
+        {
+            iter->second.bHeld = false;
+            iter->second.timer = TimerWheel::INVALID_TIMER;
+        }
+    }
+
+    if (m_holdTimers.getNbTimers() > 0)
+    {
+        m_holdTimers.clear();
+
+        for (unsigned int i = 0; i < m_holdThresholds.size(); ++i)
+            m_holdThresholds[i].timer = TimerWheel::INVALID_TIMER;
+    }
+
+    m_uiHeldChordKeys = 0;
+
+    for (unsigned int i = 0; i < m_chords.size(); ++i)
+        m_chords[i].bActive = false;
+}
+
+//-----------------------------------------------------------------------
+
+bool VirtualController::isEnabled()
+{
+    return m_bEnabled;
+}
+
+
+/*************************** MANAGEMENT OF THE REAL CONTROLLERS ***********************/
+
+void VirtualController::_validateVirtualParts()
+{
+    // Declarations
+    tVirtualKeysList::iterator     iterKey, iterKeyEnd;
+    tVirtualAxesList::iterator     iterAxis, iterAxisEnd;
+    tVirtualPOVsList::iterator     iterPOV, iterPOVEnd;
+
+    if (!m_bStaleParts)
+        return;
+
+    for (iterKey = m_virtualKeys.begin(), iterKeyEnd = m_virtualKeys.end();
+         iterKey != iterKeyEnd; ++iterKey)
+    {
+        validateVirtualKey(&iterKey->second);
+    }
+
+    for (iterAxis = m_virtualAxes.begin(), iterAxisEnd = m_virtualAxes.end();
+         iterAxis != iterAxisEnd; ++iterAxis)
+    {
+        validateVirtualAxis(&iterAxis->second);
+    }
+
+    for (iterPOV = m_virtualPOVs.begin(), iterPOVEnd = m_virtualPOVs.end();
+         iterPOV != iterPOVEnd; ++iterPOV)
+    {
+        validateVirtualPOV(&iterPOV->second);
+    }
+
+    m_bStaleParts = false;
+}
+
+//-----------------------------------------------------------------------
+
+void VirtualController::_setKeyState(tVirtualKey* pVirtualKey, bool bPressed)
+{
+    pVirtualKey->bToggled = (pVirtualKey->bPressed != bPressed);
+    pVirtualKey->bPressed = bPressed;
+}
+
+//-----------------------------------------------------------------------
+
+void VirtualController::_setAxisValue(tVirtualAxis* pVirtualAxis, int iValue)
+{
+    pVirtualAxis->bChanged          = (pVirtualAxis->iValue != iValue);
+    pVirtualAxis->iValue            = iValue;
+    pVirtualAxis->iReportedValue    = iValue;
+
+    queueAxis(pVirtualAxis);
+}
+
+//-----------------------------------------------------------------------
+
+void VirtualController::_setPOVPosition(tVirtualPOV* pVirtualPOV, tPOVPosition position)
+{
+    pVirtualPOV->bChanged = (pVirtualPOV->position != position);
+    if (pVirtualPOV->bChanged)
+    {
+        pVirtualPOV->previousPosition = pVirtualPOV->position;
+        pVirtualPOV->position         = position;
+    }
+
+    switch (pVirtualPOV->part)
+    {
+    case PART_KEY:
+        // The directions held are the ones of the position
+        pVirtualPOV->realPart.keys.uiHeld = position;
+        break;
+
+    case PART_AXIS:
+    {
+        tVirtualPOVRealPartAxes& axes = pVirtualPOV->realPart.axes;
+
+        axes.iUpDownPos     = ((position & POV_UP) ? -axes.iThreshold :
+                               ((position & POV_DOWN) ? axes.iThreshold : 0));
+        axes.iLeftRightPos  = ((position & POV_LEFT) ? -axes.iThreshold :
+                               ((position & POV_RIGHT) ? axes.iThreshold : 0));
+        break;
+    }
+
+    default:
+        break;
+    }
+}
+
+//-----------------------------------------------------------------------
+
+void VirtualController::_detachController(Controller* pController,
+                                          std::vector<tVirtualPart> &parts)
+{
+    // Assertions
+    assert(pController);
+
+    // Declarations
+    tKeySourcesList::iterator                       iterSource, iterSourceEnd;
+    tVirtualAxesList::iterator                      iterAxis, iterAxisEnd;
+    tVirtualPOVsList::iterator                      iterPOV, iterPOVEnd;
+    std::vector<tChord>::iterator                   iterChord, iterChordEnd;
+    tVirtualKey*                                    pVirtualKey;
+    tVirtualPart                                    detachedPart;
+
+    for (iterSource = m_keySources.begin(), iterSourceEnd = m_keySources.end();
+         iterSource != iterSourceEnd; ++iterSource)
+    {
+        if (iterSource->second.pController == pController)
+        {
+            iterSource->second.pController = 0;
+
+            pVirtualKey = getVirtualKey(iterSource->first);
+            pVirtualKey->bPressed = false;
+            pVirtualKey->bToggled = false;
+
+            detachedPart.part       = PART_KEY;
+            detachedPart.virtualID  = iterSource->first;
+            parts.push_back(detachedPart);
+
+            stopKeyRepeat(iterSource->first);
+        }
+    }
+
+    for (iterAxis = m_virtualAxes.begin(), iterAxisEnd = m_virtualAxes.end();
+         iterAxis != iterAxisEnd; ++iterAxis)
+    {
+        if (iterAxis->second.pController == pController)
+        {
+            iterAxis->second.pController    = 0;
+            iterAxis->second.bChanged       = false;
+            iterAxis->second.iValue         = 0;
+            iterAxis->second.fValue         = 0.0f;
+            iterAxis->second.iReportedValue = 0;
+
+            detachedPart.part       = PART_AXIS;
+            detachedPart.virtualID  = iterAxis->first;
+            parts.push_back(detachedPart);
+        }
+    }
+
+    for (iterPOV = m_virtualPOVs.begin(), iterPOVEnd = m_virtualPOVs.end();
+         iterPOV != iterPOVEnd; ++iterPOV)
+    {
+        if (iterPOV->second.pController == pController)
+        {
+            iterPOV->second.pController         = 0;
+            iterPOV->second.bChanged            = false;
+            iterPOV->second.position            = POV_CENTER;
+            iterPOV->second.previousPosition    = POV_CENTER;
+
+            if (iterPOV->second.part == PART_KEY)
+            {
+                iterPOV->second.realPart.keys.uiHeld = 0;
+            }
+            else if (iterPOV->second.part == PART_AXIS)
+            {
+                iterPOV->second.realPart.axes.iUpDownPos    = 0;
+                iterPOV->second.realPart.axes.iLeftRightPos = 0;
+            }
+
+            detachedPart.part       = PART_POV;
+            detachedPart.virtualID  = iterPOV->first;
+            parts.push_back(detachedPart);
+        }
+    }
+
+    // The chords using the real controller can't be satisfied anymore (they aren't
+    // bound again if the controller is replugged)
+    if (m_chordBits.find(pController) != m_chordBits.end())
+    {
+        for (iterChord = m_chords.begin(), iterChordEnd = m_chords.end();
+             iterChord != iterChordEnd; ++iterChord)
+        {
+            bool bUsed = false;
+
+            for (unsigned int i = 0; i < iterChord->keys.size(); ++i)
+            {
+                if (iterChord->keys[i].pController == pController)
+                {
+                    iterChord->keys[i].pController = 0;
+                    bUsed = true;
+                }
+            }
+
+            pVirtualKey = getVirtualKey(iterChord->virtualID);
+            if (bUsed && iterChord->bActive && pVirtualKey)
+            {
+                pVirtualKey->bPressed = false;
+                pVirtualKey->bToggled = false;
+
+                stopKeyRepeat(iterChord->virtualID);
+            }
+
+            if (bUsed)
+                iterChord->bActive = false;
+        }
+
+        // Reclaim the bits of the real keys of the controller
+        rebuildChords();
+    }
+}
+
+//-----------------------------------------------------------------------
+
+void VirtualController::_attachController(Controller* pController,
+                                          const std::vector<tVirtualPart> &parts)
+{
+    // Assertions
+    assert(pController);
+
+    // Declarations
+    std::vector<tVirtualPart>::const_iterator   iter, iterEnd;
+    tKeySourcesList::iterator                   iterSource;
+    tVirtualAxis*                               pVirtualAxis;
+    tVirtualPOV*                                pVirtualPOV;
+
+    for (iter = parts.begin(), iterEnd = parts.end(); iter != iterEnd; ++iter)
+    {
+        switch (iter->part)
+        {
+        case PART_KEY:
+            iterSource = m_keySources.find(iter->virtualID);
+            if ((iterSource != m_keySources.end()) && !iterSource->second.pController)
+            {
+                iterSource->second.pController = pController;
+                InputsUnit::getSingletonPtr()->_retainController(pController);
+            }
+            break;
+
+        case PART_AXIS:
+            pVirtualAxis = getVirtualAxis(iter->virtualID);
+            if (pVirtualAxis && !pVirtualAxis->pController)
+            {
+                pVirtualAxis->pController = pController;
+                InputsUnit::getSingletonPtr()->_retainController(pController);
+            }
+            break;
+
+        case PART_POV:
+            pVirtualPOV = getVirtualPOV(iter->virtualID);
+            if (pVirtualPOV && !pVirtualPOV->pController)
+            {
+                pVirtualPOV->pController = pController;
+                InputsUnit::getSingletonPtr()->_retainController(pController);
+            }
+            break;
+
+        default:
+            break;
+        }
+    }
+}
 
 
 /***************************** MANAGEMENT OF THE VIRTUAL PARTS *************************/
@@ -635,21 +2150,24 @@ void VirtualController::registerVirtualKey(tVirtualID virtualID,
     assert(InputsUnit::getSingletonPtr());
 
     // Declarations
-    tVirtualKey virtualKey = { 0 };
+    tVirtualKey         virtualKey = { 0 };
+    tVirtualKeySource   source = { 0 };
 
     if (!getVirtualKey(virtualID))
     {
         if (!strShortcut.empty())
         {
             InputsUnit::getSingletonPtr()->registerShortcut(strShortcut, virtualID);
-            virtualKey.bHasShortcut = true;
+            source.bHasShortcut = true;
         }
         else
         {
-            virtualKey.bHasShortcut = false;
+            source.bHasShortcut = false;
         }
 
+        virtualKey.uiGeneration = m_uiGeneration;
         m_virtualKeys[virtualID] = virtualKey;
+        m_keySources[virtualID]  = source;
     }
 }
 
@@ -661,7 +2179,11 @@ void VirtualController::registerVirtualAxis(tVirtualID virtualID)
     tVirtualAxis virtualAxis = { 0 };
 
     if (!getVirtualAxis(virtualID))
+    {
+        initAxisConditioning(virtualAxis.conditioning, AXIS_RANGE_DIGITAL);
+        virtualAxis.uiGeneration = m_uiGeneration;
         m_virtualAxes[virtualID] = virtualAxis;
+    }
 }
 
 //-----------------------------------------------------------------------
@@ -676,61 +2198,198 @@ void VirtualController::registerVirtualPOV(tVirtualID virtualID,
     assert(InputsUnit::getSingletonPtr());
 
     // Declarations
-    tVirtualPOV virtualPOV = { 0 };
-
-    if (!getVirtualPOV(virtualID))
+    tVirtualPOV virtualPOV = { 0 };
+
+    if (!getVirtualPOV(virtualID))
+    {
+        setPOVShortcuts(virtualID, strShortcutUp, strShortcutDown, strShortcutLeft, strShortcutRight);
+
+        virtualPOV.uiGeneration = m_uiGeneration;
+        m_virtualPOVs[virtualID] = virtualPOV;
+    }
+}
+
+//-----------------------------------------------------------------------
+
+void VirtualController::addVirtualKey(tVirtualID virtualID, Controller* pController,
+                                      tKey key, const std::string& strShortcut)
+{
+    // Assertions
+    assert(InputsUnit::getSingletonPtr());
+
+    // Declarations
+    tVirtualKey         virtualKey = { 0 };
+    tVirtualKeySource   source;
+
+    source.pController  = pController;
+    source.key          = key;
+    virtualKey.bPressed = false;
+    virtualKey.bToggled = false;
+
+    if (!strShortcut.empty())
+    {
+        InputsUnit::getSingletonPtr()->registerShortcut(strShortcut, virtualID);
+        source.bHasShortcut = true;
+    }
+    else
+    {
+        source.bHasShortcut = false;
+    }
+
+    if (removeChord(virtualID))
+        rebuildChords();
+
+    replaceReference(getVirtualKeySource(virtualID), pController);
+    virtualKey.uiGeneration = m_uiGeneration;
+    m_virtualKeys[virtualID] = virtualKey;
+    m_keySources[virtualID]  = source;
+}
+
+//-----------------------------------------------------------------------
+
+void VirtualController::addVirtualKeys(const std::vector<tVirtualKeyBinding>& bindings)
+{
+    // Assertions
+    assert(InputsUnit::getSingletonPtr());
+
+    // Declarations
+    std::vector<tVirtualKeyBinding>::const_iterator     iter, iterEnd;
+    std::vector<InputsUnit::tShortcutRegistration>      shortcuts;
+    InputsUnit::tShortcutRegistration                   shortcut;
+    tVirtualKey                                         virtualKey = { 0 };
+    tVirtualKeySource                                   source;
+    bool                                                bChordsRemoved = false;
+
+    for (iter = bindings.begin(), iterEnd = bindings.end(); iter != iterEnd; ++iter)
     {
-        if (!strShortcutUp.empty())
+        source.pController      = iter->pController;
+        source.key              = iter->key;
+        source.bHasShortcut     = !iter->strShortcut.empty();
+        virtualKey.bPressed     = false;
+        virtualKey.bToggled     = false;
+
+        if (source.bHasShortcut)
         {
-            InputsUnit* pInputsUnit = InputsUnit::getSingletonPtr();
-
-            pInputsUnit->registerShortcut(strShortcutUp, virtualID);
-            pInputsUnit->registerShortcut(strShortcutDown, virtualID);
-            pInputsUnit->registerShortcut(strShortcutLeft, virtualID);
-            pInputsUnit->registerShortcut(strShortcutRight, virtualID);
-
-            pInputsUnit->registerShortcut(strShortcutUp + strShortcutLeft, virtualID);
-            pInputsUnit->registerShortcut(strShortcutDown + strShortcutLeft, virtualID);
-            pInputsUnit->registerShortcut(strShortcutUp + strShortcutRight, virtualID);
-            pInputsUnit->registerShortcut(strShortcutDown + strShortcutRight, virtualID);
-
-            virtualPOV.shortcuts.strShortcutUp      = strShortcutUp;
-            virtualPOV.shortcuts.strShortcutDown    = strShortcutDown;
-            virtualPOV.shortcuts.strShortcutLeft    = strShortcutLeft;
-            virtualPOV.shortcuts.strShortcutRight   = strShortcutRight;
+            shortcut.strShortcut    = iter->strShortcut;
+            shortcut.virtualID      = iter->virtualID;
+            shortcuts.push_back(shortcut);
         }
 
-        m_virtualPOVs[virtualID] = virtualPOV;
+        if (removeChord(iter->virtualID))
+            bChordsRemoved = true;
+
+        replaceReference(getVirtualKeySource(iter->virtualID), iter->pController);
+        virtualKey.uiGeneration = m_uiGeneration;
+        m_virtualKeys[iter->virtualID] = virtualKey;
+        m_keySources[iter->virtualID]  = source;
     }
+
+    if (bChordsRemoved)
+        rebuildChords();
+
+    if (!shortcuts.empty())
+        InputsUnit::getSingletonPtr()->registerShortcuts(shortcuts);
 }
 
 //-----------------------------------------------------------------------
 
-void VirtualController::addVirtualKey(tVirtualID virtualID, Controller* pController,
-                                      tKey key, const std::string& strShortcut)
+void VirtualController::addVirtualChord(tVirtualID virtualID, const std::vector<tChordKey>& keys,
+                                        const std::string& strShortcut)
 {
     // Assertions
     assert(InputsUnit::getSingletonPtr());
 
     // Declarations
-    tVirtualKey virtualKey = { 0 };
+    std::vector<tChordKey>::const_iterator              iter, iterEnd;
+    std::vector<tChord>::const_iterator                 iterChord, iterChordEnd;
+    std::set<std::pair<Controller*, tKey> >             usedKeys;
+    tVirtualKey                                         virtualKey = { 0 };
+    tVirtualKeySource                                   source = { 0 };
+    tChord                                              chord;
+
+    if (keys.empty())
+    {
+        ATHENA_LOG_ERROR("Can't add a chord without any key");
+        return;
+    }
+
+    // Check that a bit can be allocated to each real key used by the chords, once the
+    // previous binding of the virtual key is replaced
+    for (iterChord = m_chords.begin(), iterChordEnd = m_chords.end();
+         iterChord != iterChordEnd; ++iterChord)
+    {
+        if ((iterChord->virtualID == virtualID) || (iterChord->uiMask == 0))
+            continue;
 
-    virtualKey.pController  = pController;
-    virtualKey.key          = key;
-    virtualKey.bPressed     = false;
-    virtualKey.bToggled     = false;
+        for (iter = iterChord->keys.begin(), iterEnd = iterChord->keys.end(); iter != iterEnd; ++iter)
+            usedKeys.insert(std::make_pair(iter->pController, iter->key));
+    }
+
+    for (iter = keys.begin(), iterEnd = keys.end(); iter != iterEnd; ++iter)
+    {
+        assert(iter->pController);
+        usedKeys.insert(std::make_pair(iter->pController, iter->key));
+    }
+
+    if (usedKeys.size() > MAX_CHORD_KEYS)
+    {
+        ATHENA_LOG_ERROR("Can't add a chord, too many different keys are used by the chords");
+        return;
+    }
+
+    // The bits are allocated by rebuildChords()
+    chord.virtualID = virtualID;
+    chord.uiMask    = 0;
+    chord.keys      = keys;
+    chord.bActive   = false;
+
+    // Replace the previous binding of the virtual key
+    removeChord(virtualID);
+
+    replaceReference(getVirtualKeySource(virtualID), 0);
+
+    for (iter = keys.begin(), iterEnd = keys.end(); iter != iterEnd; ++iter)
+        InputsUnit::getSingletonPtr()->_retainController(iter->pController);
 
     if (!strShortcut.empty())
     {
         InputsUnit::getSingletonPtr()->registerShortcut(strShortcut, virtualID);
-        virtualKey.bHasShortcut = true;
+        source.bHasShortcut = true;
     }
-    else
+
+    virtualKey.uiGeneration = m_uiGeneration;
+    m_virtualKeys[virtualID] = virtualKey;
+    m_keySources[virtualID]  = source;
+
+    m_chords.push_back(chord);
+    rebuildChords();
+}
+
+//-----------------------------------------------------------------------
+
+bool VirtualController::removeChord(tVirtualID virtualID)
+{
+    // Declarations
+    std::vector<tChord>::iterator           iterChord, iterChordEnd;
+    std::vector<tChordKey>::const_iterator  iter, iterEnd;
+
+    for (iterChord = m_chords.begin(), iterChordEnd = m_chords.end();
+         iterChord != iterChordEnd; ++iterChord)
     {
-        virtualKey.bHasShortcut = false;
+        if (iterChord->virtualID == virtualID)
+        {
+            for (iter = iterChord->keys.begin(), iterEnd = iterChord->keys.end(); iter != iterEnd; ++iter)
+            {
+                if (iter->pController)
+                    InputsUnit::getSingletonPtr()->_releaseController(iter->pController);
+            }
+
+            m_chords.erase(iterChord);
+            return true;
+        }
     }
 
-    m_virtualKeys[virtualID] = virtualKey;
+    return false;
 }
 
 //-----------------------------------------------------------------------
@@ -747,6 +2406,23 @@ void VirtualController::addVirtualAxis(tVirtualID virtualID, Controller* pContro
     virtualAxis.iValue          = 0;
     virtualAxis.bChanged        = false;
 
+    initAxisConditioning(virtualAxis.conditioning,
+                         ((pController->getType() == OIS::OISJoyStick) ? AXIS_RANGE_ANALOG : AXIS_RANGE_DIGITAL));
+
+    // The movements of the mice are small
+    if (pController->getType() == OIS::OISMouse)
+    {
+        virtualAxis.changePolicy    = AXIS_CHANGE_ALWAYS;
+        virtualAxis.iChangeStep     = 1;
+    }
+    else
+    {
+        virtualAxis.changePolicy    = AXIS_CHANGE_THRESHOLD;
+        virtualAxis.iChangeStep     = 10;
+    }
+
+    replaceReference(getVirtualAxis(virtualID), pController);
+    virtualAxis.uiGeneration = m_uiGeneration;
     m_virtualAxes[virtualID] = virtualAxis;
 }
 
@@ -765,6 +2441,10 @@ void VirtualController::addVirtualAxis(tVirtualID virtualID, Controller* pContro
     virtualAxis.iValue                  = 0;
     virtualAxis.bChanged                = false;
 
+    initAxisConditioning(virtualAxis.conditioning, AXIS_RANGE_DIGITAL);
+
+    replaceReference(getVirtualAxis(virtualID), pController);
+    virtualAxis.uiGeneration = m_uiGeneration;
     m_virtualAxes[virtualID] = virtualAxis;
 }
 
@@ -783,6 +2463,10 @@ void VirtualController::addVirtualAxis(tVirtualID virtualID, Controller* pContro
     virtualAxis.iValue                  = 0;
     virtualAxis.bChanged                = false;
 
+    initAxisConditioning(virtualAxis.conditioning, AXIS_RANGE_DIGITAL);
+
+    replaceReference(getVirtualAxis(virtualID), pController);
+    virtualAxis.uiGeneration = m_uiGeneration;
     m_virtualAxes[virtualID] = virtualAxis;
 }
 
@@ -806,26 +2490,10 @@ void VirtualController::addVirtualPOV(tVirtualID virtualID, Controller* pControl
     virtualPOV.realPart.pov = pov;
     virtualPOV.position     = POV_CENTER;
 
-    if (!strShortcutUp.empty())
-    {
-        InputsUnit* pInputsUnit = InputsUnit::getSingletonPtr();
-
-        pInputsUnit->registerShortcut(strShortcutUp, virtualID);
-        pInputsUnit->registerShortcut(strShortcutDown, virtualID);
-        pInputsUnit->registerShortcut(strShortcutLeft, virtualID);
-        pInputsUnit->registerShortcut(strShortcutRight, virtualID);
-
-        pInputsUnit->registerShortcut(strShortcutUp + strShortcutLeft, virtualID);
-        pInputsUnit->registerShortcut(strShortcutDown + strShortcutLeft, virtualID);
-        pInputsUnit->registerShortcut(strShortcutUp + strShortcutRight, virtualID);
-        pInputsUnit->registerShortcut(strShortcutDown + strShortcutRight, virtualID);
-
-        virtualPOV.shortcuts.strShortcutUp      = strShortcutUp;
-        virtualPOV.shortcuts.strShortcutDown    = strShortcutDown;
-        virtualPOV.shortcuts.strShortcutLeft    = strShortcutLeft;
-        virtualPOV.shortcuts.strShortcutRight   = strShortcutRight;
-    }
+    setPOVShortcuts(virtualID, strShortcutUp, strShortcutDown, strShortcutLeft, strShortcutRight);
 
+    replaceReference(getVirtualPOV(virtualID), pController);
+    virtualPOV.uiGeneration = m_uiGeneration;
     m_virtualPOVs[virtualID] = virtualPOV;
 }
 
@@ -852,26 +2520,10 @@ void VirtualController::addVirtualPOV(tVirtualID virtualID, Controller* pControl
     virtualPOV.realPart.keys.keyRight   = keyRight;
     virtualPOV.position                 = POV_CENTER;
 
-    if (!strShortcutUp.empty())
-    {
-        InputsUnit* pInputsUnit = InputsUnit::getSingletonPtr();
-
-        pInputsUnit->registerShortcut(strShortcutUp, virtualID);
-        pInputsUnit->registerShortcut(strShortcutDown, virtualID);
-        pInputsUnit->registerShortcut(strShortcutLeft, virtualID);
-        pInputsUnit->registerShortcut(strShortcutRight, virtualID);
-
-        pInputsUnit->registerShortcut(strShortcutUp + strShortcutLeft, virtualID);
-        pInputsUnit->registerShortcut(strShortcutDown + strShortcutLeft, virtualID);
-        pInputsUnit->registerShortcut(strShortcutUp + strShortcutRight, virtualID);
-        pInputsUnit->registerShortcut(strShortcutDown + strShortcutRight, virtualID);
-
-        virtualPOV.shortcuts.strShortcutUp      = strShortcutUp;
-        virtualPOV.shortcuts.strShortcutDown    = strShortcutDown;
-        virtualPOV.shortcuts.strShortcutLeft    = strShortcutLeft;
-        virtualPOV.shortcuts.strShortcutRight   = strShortcutRight;
-    }
+    setPOVShortcuts(virtualID, strShortcutUp, strShortcutDown, strShortcutLeft, strShortcutRight);
 
+    replaceReference(getVirtualPOV(virtualID), pController);
+    virtualPOV.uiGeneration = m_uiGeneration;
     m_virtualPOVs[virtualID] = virtualPOV;
 }
 
@@ -896,30 +2548,34 @@ void VirtualController::addVirtualPOV(tVirtualID virtualID, Controller* pControl
     virtualPOV.realPart.axes.axisLeftRight  = axisLeftRight;
     virtualPOV.realPart.axes.iUpDownPos     = 0;
     virtualPOV.realPart.axes.iLeftRightPos  = 0;
-    virtualPOV.realPart.axes.tempPosition   = POV_CENTER;
+    virtualPOV.realPart.axes.iThreshold     = 100;
+    virtualPOV.realPart.axes.iHysteresis    = 0;
     virtualPOV.position                     = POV_CENTER;
 
-    if (!strShortcutUp.empty())
-    {
-        InputsUnit* pInputsUnit = InputsUnit::getSingletonPtr();
+    setPOVShortcuts(virtualID, strShortcutUp, strShortcutDown, strShortcutLeft, strShortcutRight);
 
-        pInputsUnit->registerShortcut(strShortcutUp, virtualID);
-        pInputsUnit->registerShortcut(strShortcutDown, virtualID);
-        pInputsUnit->registerShortcut(strShortcutLeft, virtualID);
-        pInputsUnit->registerShortcut(strShortcutRight, virtualID);
+    replaceReference(getVirtualPOV(virtualID), pController);
+    virtualPOV.uiGeneration = m_uiGeneration;
+    m_virtualPOVs[virtualID] = virtualPOV;
+}
 
-        pInputsUnit->registerShortcut(strShortcutUp + strShortcutLeft, virtualID);
-        pInputsUnit->registerShortcut(strShortcutDown + strShortcutLeft, virtualID);
-        pInputsUnit->registerShortcut(strShortcutUp + strShortcutRight, virtualID);
-        pInputsUnit->registerShortcut(strShortcutDown + strShortcutRight, virtualID);
+//-----------------------------------------------------------------------
 
-        virtualPOV.shortcuts.strShortcutUp      = strShortcutUp;
-        virtualPOV.shortcuts.strShortcutDown    = strShortcutDown;
-        virtualPOV.shortcuts.strShortcutLeft    = strShortcutLeft;
-        virtualPOV.shortcuts.strShortcutRight   = strShortcutRight;
-    }
+void VirtualController::setPOVThresholds(tVirtualID virtualPOV, int iThreshold, int iHysteresis)
+{
+    // Assertions
+    assert(iThreshold > 0);
+    assert((iHysteresis >= 0) && (iHysteresis < iThreshold));
 
-    m_virtualPOVs[virtualID] = virtualPOV;
+    // Declarations
+    tVirtualPOV* pVirtualPOV;
+
+    pVirtualPOV = getVirtualPOV(virtualPOV);
+    if (pVirtualPOV && (pVirtualPOV->part == PART_AXIS))
+    {
+        pVirtualPOV->realPart.axes.iThreshold   = iThreshold;
+        pVirtualPOV->realPart.axes.iHysteresis  = iHysteresis;
+    }
 }
 
 //-----------------------------------------------------------------------
@@ -927,11 +2583,13 @@ void VirtualController::addVirtualPOV(tVirtualID virtualID, Controller* pControl
 bool VirtualController::isKeyPressed(tVirtualID virtualKey)
 {
     // Declarations
-    std::map<tVirtualID, tVirtualKey>::iterator iter;
+    tVirtualKeysList::iterator iter;
 
     iter = m_virtualKeys.find(virtualKey);
     if (iter != m_virtualKeys.end())
     {
+        validateVirtualKey(&iter->second);
+
         return iter->second.bPressed;
     }
 
@@ -940,14 +2598,77 @@ bool VirtualController::isKeyPressed(tVirtualID virtualKey)
 
 //-----------------------------------------------------------------------
 
+bool VirtualController::isKeyPressedAt(tVirtualID virtualKey, unsigned long ulTimestamp)
+{
+    if (!m_bTransitionsLogEnabled)
+        return isKeyPressed(virtualKey);
+
+    const tVirtualEvent* pState = getStateAt(PART_KEY, virtualKey, ulTimestamp);
+
+    return (pState ? pState->value.bPressed : false);
+}
+
+//-----------------------------------------------------------------------
+
+float VirtualController::getKeyPressedFraction(tVirtualID virtualKey, unsigned long ulStart,
+                                               unsigned long ulEnd)
+{
+    // Declarations
+    const tVirtualEvent*    pState;
+    bool                    bPressed;
+    unsigned long           ulLast;
+    unsigned long           ulPressedDuration = 0;
+
+    if (!m_bTransitionsLogEnabled)
+        return (isKeyPressed(virtualKey) ? 1.0f : 0.0f);
+
+    pState = getStateAt(PART_KEY, virtualKey, ulStart);
+    if (!pState)
+        return 0.0f;
+
+    bPressed = pState->value.bPressed;
+
+    if (ulEnd <= ulStart)
+        return (bPressed ? 1.0f : 0.0f);
+
+    // Accumulate the durations of the presses during the interval
+    ulLast = ulStart;
+
+    for (unsigned int i = 0; i < m_transitions.size(); ++i)
+    {
+        const tVirtualEvent& transition = m_transitions[i];
+
+        if ((transition.part != PART_KEY) || (transition.virtualID != virtualKey) ||
+            (transition.ulTimestamp <= ulStart) || (transition.ulTimestamp > ulEnd))
+        {
+            continue;
+        }
+
+        if (bPressed)
+            ulPressedDuration += transition.ulTimestamp - ulLast;
+
+        ulLast      = transition.ulTimestamp;
+        bPressed    = transition.value.bPressed;
+    }
+
+    if (bPressed)
+        ulPressedDuration += ulEnd - ulLast;
+
+    return (float) ulPressedDuration / (float) (ulEnd - ulStart);
+}
+
+//-----------------------------------------------------------------------
+
 bool VirtualController::wasKeyToggled(tVirtualID virtualKey)
 {
     // Declarations
-    std::map<tVirtualID, tVirtualKey>::iterator iter;
+    tVirtualKeysList::iterator iter;
 
     iter = m_virtualKeys.find(virtualKey);
     if (iter != m_virtualKeys.end())
     {
+        validateVirtualKey(&iter->second);
+
         return iter->second.bToggled;
     }
 
@@ -959,11 +2680,13 @@ bool VirtualController::wasKeyToggled(tVirtualID virtualKey)
 bool VirtualController::wasKeyPressed(tVirtualID virtualKey)
 {
     // Declarations
-    std::map<tVirtualID, tVirtualKey>::iterator iter;
+    tVirtualKeysList::iterator iter;
 
     iter = m_virtualKeys.find(virtualKey);
     if (iter != m_virtualKeys.end())
     {
+        validateVirtualKey(&iter->second);
+
         return iter->second.bPressed && iter->second.bToggled;
     }
 
@@ -975,11 +2698,13 @@ bool VirtualController::wasKeyPressed(tVirtualID virtualKey)
 bool VirtualController::wasKeyReleased(tVirtualID virtualKey)
 {
     // Declarations
-    std::map<tVirtualID, tVirtualKey>::iterator iter;
+    tVirtualKeysList::iterator iter;
 
     iter = m_virtualKeys.find(virtualKey);
     if (iter != m_virtualKeys.end())
     {
+        validateVirtualKey(&iter->second);
+
         return !iter->second.bPressed && iter->second.bToggled;
     }
 
@@ -991,11 +2716,13 @@ bool VirtualController::wasKeyReleased(tVirtualID virtualKey)
 unsigned int VirtualController::getKeyPressedDuration(tVirtualID virtualKey)
 {
     // Declarations
-    std::map<tVirtualID, tVirtualKey>::iterator iter;
+    tVirtualKeysList::iterator iter;
 
     iter = m_virtualKeys.find(virtualKey);
     if (iter != m_virtualKeys.end())
     {
+        validateVirtualKey(&iter->second);
+
         if (iter->second.bPressed)
             return 0;
 
@@ -1007,14 +2734,86 @@ unsigned int VirtualController::getKeyPressedDuration(tVirtualID virtualKey)
 
 //-----------------------------------------------------------------------
 
+unsigned int VirtualController::getKeyHeldDuration(tVirtualID virtualKey)
+{
+    // Declarations
+    tVirtualKey* pVirtualKey;
+
+    pVirtualKey = getVirtualKey(virtualKey);
+    if (pVirtualKey && pVirtualKey->bPressed &&
+        (m_ulFrameEndTimestamp > pVirtualKey->ulPressTimestamp))
+    {
+        return m_ulFrameEndTimestamp - pVirtualKey->ulPressTimestamp;
+    }
+
+    return 0;
+}
+
+//-----------------------------------------------------------------------
+
+void VirtualController::addHoldThreshold(tVirtualID virtualKey, unsigned int uiDuration,
+                                         tVirtualID thresholdID)
+{
+    // Assertions
+    assert(uiDuration > 0);
+
+    // Declarations
+    tHoldThreshold threshold;
+
+    threshold.virtualKey    = virtualKey;
+    threshold.uiDuration    = uiDuration;
+    threshold.thresholdID   = thresholdID;
+    threshold.timer         = TimerWheel::INVALID_TIMER;
+
+    m_holdThresholds.push_back(threshold);
+
+    rebuildHoldThresholds();
+}
+
+//-----------------------------------------------------------------------
+
+void VirtualController::removeHoldThresholds(tVirtualID virtualKey)
+{
+    // Declarations
+    std::vector<tHoldThreshold>::iterator iter;
+
+    for (iter = m_holdThresholds.begin(); iter != m_holdThresholds.end(); )
+    {
+        if (iter->virtualKey == virtualKey)
+            iter = m_holdThresholds.erase(iter);
+        else
+            ++iter;
+    }
+
+    rebuildHoldThresholds();
+}
+
+//-----------------------------------------------------------------------
+
+void VirtualController::setKeyRepeat(tVirtualID virtualKey, unsigned int uiDelay,
+                                     unsigned int uiInterval)
+{
+    configureKeyRepeat(virtualKey, uiDelay, uiInterval, false);
+}
+
+//-----------------------------------------------------------------------
+
+void VirtualController::setKeyTurbo(tVirtualID virtualKey, unsigned int uiInterval)
+{
+    configureKeyRepeat(virtualKey, uiInterval, uiInterval, true);
+}
+//-----------------------------------------------------------------------
+
 int VirtualController::getAxisValue(tVirtualID virtualAxis)
 {
     // Declarations
-    std::map<tVirtualID, tVirtualAxis>::iterator    iter;
+    tVirtualAxesList::iterator iter;
 
     iter = m_virtualAxes.find(virtualAxis);
     if (iter != m_virtualAxes.end())
     {
+        validateVirtualAxis(&iter->second);
+
         return iter->second.iValue;
     }
 
@@ -1023,14 +2822,28 @@ int VirtualController::getAxisValue(tVirtualID virtualAxis)
 
 //-----------------------------------------------------------------------
 
+int VirtualController::getAxisValueAt(tVirtualID virtualAxis, unsigned long ulTimestamp)
+{
+    if (!m_bTransitionsLogEnabled)
+        return getAxisValue(virtualAxis);
+
+    const tVirtualEvent* pState = getStateAt(PART_AXIS, virtualAxis, ulTimestamp);
+
+    return (pState ? pState->value.iValue : 0);
+}
+
+//-----------------------------------------------------------------------
+
 bool VirtualController::wasAxisChanged(tVirtualID virtualAxis)
 {
     // Declarations
-    std::map<tVirtualID, tVirtualAxis>::iterator    iter;
+    tVirtualAxesList::iterator iter;
 
     iter = m_virtualAxes.find(virtualAxis);
     if (iter != m_virtualAxes.end())
     {
+        validateVirtualAxis(&iter->second);
+
         return iter->second.bChanged;
     }
 
@@ -1039,14 +2852,99 @@ bool VirtualController::wasAxisChanged(tVirtualID virtualAxis)
 
 //-----------------------------------------------------------------------
 
+float VirtualController::getAxisConditionedValue(tVirtualID virtualAxis)
+{
+    // Declarations
+    tVirtualAxesList::iterator iter;
+
+    iter = m_virtualAxes.find(virtualAxis);
+    if (iter != m_virtualAxes.end())
+    {
+        validateVirtualAxis(&iter->second);
+
+        return iter->second.fValue;
+    }
+
+    return 0.0f;
+}
+
+//-----------------------------------------------------------------------
+
+void VirtualController::setAxisConditioning(tVirtualID virtualAxis,
+                                            const tAxisConditioning& conditioning)
+{
+    // Assertions
+    assert(conditioning.iRange > 0);
+
+    // Declarations
+    tVirtualAxis* pVirtualAxis;
+
+    pVirtualAxis = getVirtualAxis(virtualAxis);
+    if (pVirtualAxis)
+    {
+        pVirtualAxis->conditioning = conditioning;
+
+        // Update the conditioned value of the axis and of its paired one, without
+        // conditioning the other axes modified during the frame
+        tVirtualAxis* axes[2] = { pVirtualAxis, 0 };
+        unsigned int uiCount = 1;
+
+        if (conditioning.radialPair != 0)
+        {
+            axes[1] = getVirtualAxis(conditioning.radialPair);
+            if (axes[1] && (axes[1] != pVirtualAxis))
+                ++uiCount;
+        }
+
+        conditionAxes(axes, uiCount);
+    }
+}
+
+//-----------------------------------------------------------------------
+
+const tAxisConditioning* VirtualController::getAxisConditioning(tVirtualID virtualAxis)
+{
+    // Declarations
+    tVirtualAxis* pVirtualAxis;
+
+    pVirtualAxis = getVirtualAxis(virtualAxis);
+    if (pVirtualAxis)
+        return &pVirtualAxis->conditioning;
+
+    return 0;
+}
+
+//-----------------------------------------------------------------------
+
+void VirtualController::setAxisChangePolicy(tVirtualID virtualAxis, tAxisChangePolicy policy,
+                                            int iStep)
+{
+    // Assertions
+    assert(iStep > 0);
+
+    // Declarations
+    tVirtualAxis* pVirtualAxis;
+
+    pVirtualAxis = getVirtualAxis(virtualAxis);
+    if (pVirtualAxis)
+    {
+        pVirtualAxis->changePolicy  = policy;
+        pVirtualAxis->iChangeStep   = iStep;
+    }
+}
+
+//-----------------------------------------------------------------------
+
 tPOVPosition VirtualController::getPOVPosition(tVirtualID virtualPOV)
 {
     // Declarations
-    std::map<tVirtualID, tVirtualPOV>::iterator iter;
+    tVirtualPOVsList::iterator iter;
 
     iter = m_virtualPOVs.find(virtualPOV);
     if (iter != m_virtualPOVs.end())
     {
+        validateVirtualPOV(&iter->second);
+
         return iter->second.position;
     }
 
@@ -1055,14 +2953,28 @@ tPOVPosition VirtualController::getPOVPosition(tVirtualID virtualPOV)
 
 //-----------------------------------------------------------------------
 
+tPOVPosition VirtualController::getPOVPositionAt(tVirtualID virtualPOV, unsigned long ulTimestamp)
+{
+    if (!m_bTransitionsLogEnabled)
+        return getPOVPosition(virtualPOV);
+
+    const tVirtualEvent* pState = getStateAt(PART_POV, virtualPOV, ulTimestamp);
+
+    return (pState ? pState->value.position : POV_CENTER);
+}
+
+//-----------------------------------------------------------------------
+
 tPOVPosition VirtualController::getPOVPreviousPosition(tVirtualID virtualPOV)
 {
     // Declarations
-    std::map<tVirtualID, tVirtualPOV>::iterator iter;
+    tVirtualPOVsList::iterator iter;
 
     iter = m_virtualPOVs.find(virtualPOV);
     if (iter != m_virtualPOVs.end())
     {
+        validateVirtualPOV(&iter->second);
+
         return iter->second.previousPosition;
     }
 
@@ -1074,11 +2986,13 @@ tPOVPosition VirtualController::getPOVPreviousPosition(tVirtualID virtualPOV)
 bool VirtualController::wasPOVChanged(tVirtualID virtualPOV)
 {
     // Declarations
-    std::map<tVirtualID, tVirtualPOV>::iterator iter;
+    tVirtualPOVsList::iterator iter;
 
     iter = m_virtualPOVs.find(virtualPOV);
     if (iter != m_virtualPOVs.end())
     {
+        validateVirtualPOV(&iter->second);
+
         return iter->second.bChanged;
     }
 
@@ -1091,26 +3005,26 @@ tPOVPosition VirtualController::getPOVPositionFromShortcut(tVirtualID virtualPOV
                                                            const std::string& strShortcut)
 {
     // Declarations
-    std::map<tVirtualID, tVirtualPOV>::iterator iter;
+    tPOVShortcutsList::iterator iter;
 
-    iter = m_virtualPOVs.find(virtualPOV);
-    if (iter != m_virtualPOVs.end())
+    iter = m_povShortcuts.find(virtualPOV);
+    if (iter != m_povShortcuts.end())
     {
-        if (strShortcut == iter->second.shortcuts.strShortcutUp)
+        if (strShortcut == iter->second.strShortcutUp)
             return POV_UP;
-        else if (strShortcut == iter->second.shortcuts.strShortcutDown)
+        else if (strShortcut == iter->second.strShortcutDown)
             return POV_DOWN;
-        else if (strShortcut == iter->second.shortcuts.strShortcutLeft)
+        else if (strShortcut == iter->second.strShortcutLeft)
             return POV_LEFT;
-        else if (strShortcut == iter->second.shortcuts.strShortcutRight)
+        else if (strShortcut == iter->second.strShortcutRight)
             return POV_RIGHT;
-        else if (strShortcut == iter->second.shortcuts.strShortcutDown + iter->second.shortcuts.strShortcutLeft)
+        else if (strShortcut == iter->second.strShortcutDown + iter->second.strShortcutLeft)
             return POV_DOWNLEFT;
-        else if (strShortcut == iter->second.shortcuts.strShortcutUp + iter->second.shortcuts.strShortcutLeft)
+        else if (strShortcut == iter->second.strShortcutUp + iter->second.strShortcutLeft)
             return POV_UPLEFT;
-        else if (strShortcut == iter->second.shortcuts.strShortcutDown + iter->second.shortcuts.strShortcutRight)
+        else if (strShortcut == iter->second.strShortcutDown + iter->second.strShortcutRight)
             return POV_DOWNRIGHT;
-        else if (strShortcut == iter->second.shortcuts.strShortcutUp + iter->second.shortcuts.strShortcutRight)
+        else if (strShortcut == iter->second.strShortcutUp + iter->second.strShortcutRight)
             return POV_UPRIGHT;
         else
             return POV_CENTER;
@@ -1121,14 +3035,43 @@ tPOVPosition VirtualController::getPOVPositionFromShortcut(tVirtualID virtualPOV
 
 //-----------------------------------------------------------------------
 
+const tVirtualKeySource* VirtualController::getVirtualKeySource(tVirtualID virtualKey)
+{
+    // Declarations
+    tKeySourcesList::iterator iter;
+
+    iter = m_keySources.find(virtualKey);
+    if (iter != m_keySources.end())
+        return &iter->second;
+
+    return 0;
+}
+
+//-----------------------------------------------------------------------
+
+const tVirtualPOVShortcuts* VirtualController::getPOVShortcuts(tVirtualID virtualPOV)
+{
+    // Declarations
+    tPOVShortcutsList::iterator iter;
+
+    iter = m_povShortcuts.find(virtualPOV);
+    if (iter != m_povShortcuts.end())
+        return &iter->second;
+
+    return 0;
+}
+//-----------------------------------------------------------------------
+
 unsigned int VirtualController::getPOVPressedDuration(tVirtualID virtualPOV)
 {
     // Declarations
-    std::map<tVirtualID, tVirtualPOV>::iterator iter;
+    tVirtualPOVsList::iterator iter;
 
     iter = m_virtualPOVs.find(virtualPOV);
     if (iter != m_virtualPOVs.end())
     {
+        validateVirtualPOV(&iter->second);
+
         if (iter->second.previousPosition == POV_CENTER)
             return 0;
 
@@ -1140,6 +3083,23 @@ unsigned int VirtualController::getPOVPressedDuration(tVirtualID virtualPOV)
 
 //-----------------------------------------------------------------------
 
+unsigned int VirtualController::getPOVHeldDuration(tVirtualID virtualPOV)
+{
+    // Declarations
+    tVirtualPOV* pVirtualPOV;
+
+    pVirtualPOV = getVirtualPOV(virtualPOV);
+    if (pVirtualPOV && (pVirtualPOV->position != POV_CENTER) &&
+        (m_ulFrameEndTimestamp > pVirtualPOV->ulLastChangeTimestamp))
+    {
+        return m_ulFrameEndTimestamp - pVirtualPOV->ulLastChangeTimestamp;
+    }
+
+    return 0;
+}
+
+//-----------------------------------------------------------------------
+
 bool VirtualController::isKey(tVirtualID virtualID)
 {
     return (m_virtualKeys.find(virtualID) != m_virtualKeys.end());
@@ -1181,7 +3141,7 @@ const tVirtualKey& VirtualController::getVirtualKey(unsigned int uiIndex, tVirtu
     assert(uiIndex < (unsigned int) m_virtualKeys.size());
 
     // Declarations
-    std::map<tVirtualID, tVirtualKey>::iterator iter;
+    tVirtualKeysList::iterator iter;
     unsigned int i = 0;
 
     iter = m_virtualKeys.begin();
@@ -1191,6 +3151,8 @@ const tVirtualKey& VirtualController::getVirtualKey(unsigned int uiIndex, tVirtu
         ++i;
     }
 
+    validateVirtualKey(&iter->second);
+
     id = iter->first;
     return iter->second;
 }
@@ -1203,7 +3165,7 @@ const tVirtualAxis& VirtualController::getVirtualAxis(unsigned int uiIndex, tVir
     assert(uiIndex < (unsigned int) m_virtualAxes.size());
 
     // Declarations
-    std::map<tVirtualID, tVirtualAxis>::iterator iter;
+    tVirtualAxesList::iterator iter;
     unsigned int i = 0;
 
     iter = m_virtualAxes.begin();
@@ -1213,6 +3175,8 @@ const tVirtualAxis& VirtualController::getVirtualAxis(unsigned int uiIndex, tVir
         ++i;
     }
 
+    validateVirtualAxis(&iter->second);
+
     id = iter->first;
     return iter->second;
 }
@@ -1225,7 +3189,7 @@ const tVirtualPOV& VirtualController::getVirtualPOV(unsigned int uiIndex, tVirtu
     assert(uiIndex < (unsigned int) m_virtualPOVs.size());
 
     // Declarations
-    std::map<tVirtualID, tVirtualPOV>::iterator iter;
+    tVirtualPOVsList::iterator iter;
     unsigned int i = 0;
 
     iter = m_virtualPOVs.begin();
@@ -1235,6 +3199,8 @@ const tVirtualPOV& VirtualController::getVirtualPOV(unsigned int uiIndex, tVirtu
         ++i;
     }
 
+    validateVirtualPOV(&iter->second);
+
     id = iter->first;
     return iter->second;
 }
@@ -1244,11 +3210,12 @@ const tVirtualPOV& VirtualController::getVirtualPOV(unsigned int uiIndex, tVirtu
 tVirtualKey* VirtualController::getVirtualKey(tVirtualID id)
 {
     // Declarations
-    std::map<tVirtualID, tVirtualKey>::iterator iter;
+    tVirtualKeysList::iterator iter;
 
     iter = m_virtualKeys.find(id);
     if (iter != m_virtualKeys.end())
     {
+        validateVirtualKey(&iter->second);
         return &iter->second;
     }
 
@@ -1260,11 +3227,12 @@ tVirtualKey* VirtualController::getVirtualKey(tVirtualID id)
 tVirtualAxis* VirtualController::getVirtualAxis(tVirtualID id)
 {
     // Declarations
-    std::map<tVirtualID, tVirtualAxis>::iterator iter;
+    tVirtualAxesList::iterator iter;
 
     iter = m_virtualAxes.find(id);
     if (iter != m_virtualAxes.end())
     {
+        validateVirtualAxis(&iter->second);
         return &iter->second;
     }
 
@@ -1276,11 +3244,12 @@ tVirtualAxis* VirtualController::getVirtualAxis(tVirtualID id)
 tVirtualPOV* VirtualController::getVirtualPOV(tVirtualID id)
 {
     // Declarations
-    std::map<tVirtualID, tVirtualPOV>::iterator iter;
+    tVirtualPOVsList::iterator iter;
 
     iter = m_virtualPOVs.find(id);
     if (iter != m_virtualPOVs.end())
     {
+        validateVirtualPOV(&iter->second);
         return &iter->second;
     }
 
@@ -0,0 +1,83 @@
+/** @file   VirtualEventsFilter.cpp
+    @author Philip Abbet
+
+    Implementation of the class 'Athena::Inputs::VirtualEventsFilter'
+*/
+
+#include <Athena-Inputs/VirtualEventsFilter.h>
+
+
+using namespace Athena;
+using namespace Athena::Inputs;
+using namespace std;
+
+
+/****************************** CONSTRUCTION / DESTRUCTION *****************************/
+
+VirtualEventsFilter::VirtualEventsFilter()
+: m_uiParts(0)
+{
+}
+
+//-----------------------------------------------------------------------
+
+VirtualEventsFilter::~VirtualEventsFilter()
+{
+}
+
+
+/************************************** METHODS ****************************************/
+
+void VirtualEventsFilter::add(tVirtualID virtualID)
+{
+    add(virtualID, PART_KEY);
+    add(virtualID, PART_AXIS);
+    add(virtualID, PART_POV);
+}
+
+//-----------------------------------------------------------------------
+
+void VirtualEventsFilter::add(tVirtualID virtualID, tControllerPart part)
+{
+    unsigned int uiBit = virtualID * BITS_PER_ID + part;
+
+    if ((uiBit >> 5) >= m_bits.size())
+        m_bits.resize((uiBit >> 5) + 1, 0);
+
+    m_bits[uiBit >> 5] |= (1u << (uiBit & 31));
+}
+
+//-----------------------------------------------------------------------
+
+void VirtualEventsFilter::remove(tVirtualID virtualID)
+{
+    for (unsigned int uiBit = virtualID * BITS_PER_ID; uiBit < (virtualID + 1) * BITS_PER_ID; ++uiBit)
+    {
+        if ((uiBit >> 5) < m_bits.size())
+            m_bits[uiBit >> 5] &= ~(1u << (uiBit & 31));
+    }
+}
+
+//-----------------------------------------------------------------------
+
+void VirtualEventsFilter::addPart(tControllerPart part)
+{
+    m_uiParts |= (1u << part);
+}
+
+//-----------------------------------------------------------------------
+
+void VirtualEventsFilter::addAll()
+{
+    addPart(PART_KEY);
+    addPart(PART_AXIS);
+    addPart(PART_POV);
+}
+
+//-----------------------------------------------------------------------
+
+void VirtualEventsFilter::clear()
+{
+    m_bits.clear();
+    m_uiParts = 0;
+}
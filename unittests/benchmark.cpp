@@ -0,0 +1,154 @@
+#include <Athena-Inputs/InputHistory.h>
+#include <Athena-Inputs/SharedEventsRing.h>
+#include <Athena-Inputs/StateEncoder.h>
+#include "environments/InputsTestEnvironment.h"
+#include <iostream>
+#include <iomanip>
+
+using namespace Athena::Inputs;
+using namespace std;
+
+
+static const unsigned int NB_FRAMES         = 10000;
+static const unsigned int EVENTS_PER_FRAME  = 16;
+static const unsigned int NB_KEYS           = 64;
+static const unsigned int NB_AXES           = 4;
+
+
+static void report(const char* strName, unsigned long ulDuration, unsigned int uiCount)
+{
+    cout << setw(32) << left << strName
+         << setw(10) << right << ulDuration << " us total   "
+         << setw(8) << fixed << setprecision(3) << (double) ulDuration / uiCount << " us each" << endl;
+}
+
+
+int main()
+{
+    InputsTestEnvironment env;
+    unsigned long ulStart;
+    unsigned int i, j;
+
+    // Footprint of the virtual parts
+    cout << "sizeof(tVirtualKey)             " << sizeof(tVirtualKey) << " bytes" << endl
+         << "sizeof(tVirtualAxis)            " << sizeof(tVirtualAxis) << " bytes" << endl
+         << "sizeof(tVirtualPOV)             " << sizeof(tVirtualPOV) << " bytes" << endl
+         << "sizeof(VirtualController)       " << sizeof(VirtualController) << " bytes" << endl
+         << endl;
+
+    for (i = 0; i < NB_KEYS; ++i)
+        env.pVirtualController->addVirtualKey(i + 1, env.pController, (tKey) i);
+
+    for (i = 0; i < NB_AXES; ++i)
+        env.pVirtualController->addVirtualAxis(i + 1, env.pController, (tAxis) i);
+
+    const Arena::tStats& arenaStats = env.pVirtualController->getArenaStats();
+
+    cout << "Arena of the virtual controller " << arenaStats.ulUsedSize << " bytes used, "
+         << arenaStats.ulReservedSize << " bytes reserved (" << NB_KEYS << " keys, "
+         << NB_AXES << " axes)" << endl
+         << endl;
+
+    // Events processing
+    ulStart = Controller::getPreciseTimestamp();
+
+    for (i = 0; i < NB_FRAMES; ++i)
+    {
+        for (j = 0; j < EVENTS_PER_FRAME / 2; ++j)
+        {
+            env.pressKey((tKey) ((i + j) % NB_KEYS), ((i + j) & 1) != 0);
+            env.moveAxis((tAxis) (j % NB_AXES), (int) ((i * 37 + j * 101) % 65536) - 32768);
+        }
+
+        env.pInputsUnit->process();
+    }
+
+    report("InputsUnit::process (16 events)", Controller::getPreciseTimestamp() - ulStart, NB_FRAMES);
+
+    // History
+    InputHistory history(env.pVirtualController, 128);
+
+    ulStart = Controller::getPreciseTimestamp();
+
+    for (i = 0; i < NB_FRAMES; ++i)
+        history.recordFrame(i);
+
+    report("InputHistory::recordFrame", Controller::getPreciseTimestamp() - ulStart, NB_FRAMES);
+
+    ulStart = Controller::getPreciseTimestamp();
+
+    for (i = 0; i < NB_FRAMES; ++i)
+        history.restoreFrame(NB_FRAMES - 1 - (i % 128));
+
+    report("InputHistory::restoreFrame", Controller::getPreciseTimestamp() - ulStart, NB_FRAMES);
+
+    // Encoding
+    StateEncoder encoder(env.pVirtualController);
+    StateEncoder::tState reference, state, decoded;
+    vector<unsigned char> buffer(encoder.getMaxEncodedSize());
+    unsigned long ulNbBytes = 0;
+
+    encoder.initState(reference);
+    encoder.initState(state);
+    encoder.initState(decoded);
+    encoder.capture(state);
+
+    ulStart = Controller::getPreciseTimestamp();
+
+    for (i = 0; i < NB_FRAMES; ++i)
+        ulNbBytes += encoder.encode(reference, state, &buffer[0], (unsigned int) buffer.size());
+
+    report("StateEncoder::encode", Controller::getPreciseTimestamp() - ulStart, NB_FRAMES);
+
+    ulStart = Controller::getPreciseTimestamp();
+
+    for (i = 0; i < NB_FRAMES; ++i)
+        encoder.decode(reference, &buffer[0], (unsigned int) buffer.size(), decoded);
+
+    report("StateEncoder::decode", Controller::getPreciseTimestamp() - ulStart, NB_FRAMES);
+
+    ulStart = Controller::getPreciseTimestamp();
+
+    for (i = 0; i < NB_FRAMES; ++i)
+        encoder.apply((i & 1) ? state : reference);
+
+    report("StateEncoder::apply", Controller::getPreciseTimestamp() - ulStart, NB_FRAMES);
+
+    cout << "    " << (ulNbBytes / NB_FRAMES) << " bytes per encoded state" << endl;
+
+    // Shared events ring
+    SharedEventsRing writer;
+    SharedEventsRing reader;
+    SharedEventsRing::tEvent events[256];
+    tInputEvent event;
+    unsigned long ulNbRead = 0;
+
+    if (writer.create("Athena-Inputs-Benchmark", 1024) && reader.open("Athena-Inputs-Benchmark"))
+    {
+        writer.addDevice(OIS::OISJoyStick, 1, "Gamepad", "Gamepad#0");
+
+        event.pController       = 0;
+        event.part              = PART_KEY;
+        event.partID.key        = 0;
+        event.value.bPressed    = true;
+
+        ulStart = Controller::getPreciseTimestamp();
+
+        for (i = 0; i < NB_FRAMES; ++i)
+        {
+            for (j = 0; j < EVENTS_PER_FRAME; ++j)
+            {
+                event.ulTimeStamp = i;
+                writer.write(0, event);
+            }
+
+            ulNbRead += reader.read(events, 256);
+        }
+
+        report("SharedEventsRing (16 events)", Controller::getPreciseTimestamp() - ulStart, NB_FRAMES);
+
+        cout << "    " << ulNbRead << " events read, " << reader.getNbLostEvents() << " lost" << endl;
+    }
+
+    return 0;
+}
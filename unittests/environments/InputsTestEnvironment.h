@@ -0,0 +1,89 @@
+#ifndef _INPUTSTESTENVIRONMENT_H_
+#define _INPUTSTESTENVIRONMENT_H_
+
+#include <Athena-Inputs/InputsUnit.h>
+#include <Athena-Inputs/RemoteController.h>
+#include <Athena-Inputs/VirtualController.h>
+#include <string.h>
+
+
+//---------------------------------------------------------------------------------------
+/// @brief  An Inputs Unit with a gamepad whose events are given by the test, and a
+///         virtual controller
+///
+/// The Inputs Unit isn't initialized: no real controller is opened. The timestamps of
+/// the events start at the current time (see Controller::getTimestamp()), like the
+/// frames processed by the virtual controller.
+//---------------------------------------------------------------------------------------
+struct InputsTestEnvironment
+{
+    Athena::Inputs::InputsUnit*         pInputsUnit;
+    Athena::Inputs::RemoteController*   pController;
+    Athena::Inputs::VirtualController*  pVirtualController;
+    unsigned long                       ulTimestamp;
+
+
+    InputsTestEnvironment()
+    : ulTimestamp(Athena::Inputs::Controller::getTimestamp())
+    {
+        Athena::Inputs::SharedEventsRing::tDevice device;
+
+        memset(&device, 0, sizeof(device));
+        device.uiType   = OIS::OISJoyStick;
+        device.uiIndex  = 1;
+        strcpy(device.strName, "Test");
+        strcpy(device.strIdentity, "Test#0");
+
+        pInputsUnit         = new Athena::Inputs::InputsUnit();
+        pController         = new Athena::Inputs::RemoteController(device);
+        pInputsUnit->_addController(pController);
+        pVirtualController  = pInputsUnit->createVirtualController("Test");
+    }
+
+    ~InputsTestEnvironment()
+    {
+        delete pInputsUnit;
+    }
+
+
+    void pressKey(Athena::Inputs::tKey key, bool bPressed)
+    {
+        Athena::Inputs::tInputEvent event;
+
+        event.pController       = pController;
+        event.part              = Athena::Inputs::PART_KEY;
+        event.partID.key        = key;
+        event.value.bPressed    = bPressed;
+        event.ulTimeStamp       = ++ulTimestamp;
+
+        pInputsUnit->onEvent(&event);
+    }
+
+    void moveAxis(Athena::Inputs::tAxis axis, int iValue)
+    {
+        Athena::Inputs::tInputEvent event;
+
+        event.pController   = pController;
+        event.part          = Athena::Inputs::PART_AXIS;
+        event.partID.axis   = axis;
+        event.value.iValue  = iValue;
+        event.ulTimeStamp   = ++ulTimestamp;
+
+        pInputsUnit->onEvent(&event);
+    }
+
+    void movePOV(Athena::Inputs::tPOV pov, Athena::Inputs::tPOVPosition position)
+    {
+        Athena::Inputs::tInputEvent event;
+
+        event.pController       = pController;
+        event.part              = Athena::Inputs::PART_POV;
+        event.partID.pov        = pov;
+        event.value.position    = position;
+        event.ulTimeStamp       = ++ulTimestamp;
+
+        pInputsUnit->onEvent(&event);
+    }
+};
+
+#endif
@@ -0,0 +1,7 @@
+#include <UnitTest++.h>
+
+
+int main()
+{
+    return UnitTest::RunAllTests();
+}
@@ -0,0 +1,37 @@
+#include <UnitTest++.h>
+#include <Athena-Inputs/Arena.h>
+
+using namespace Athena::Inputs;
+
+
+SUITE(ArenaTests)
+{
+    TEST(BlocksAreAligned)
+    {
+        Arena arena(256);
+
+        // Small blocks, blocks filling several chunks, and big blocks with their own
+        // chunk
+        for (size_t size = 1; size <= 1024; size += 7)
+        {
+            void* pBlock = arena.allocate(size);
+            CHECK_EQUAL(0u, ((size_t) pBlock) & 15);
+        }
+    }
+
+
+    TEST(ReleasedBlockIsReused)
+    {
+        Arena arena;
+
+        void* pSmall = arena.allocate(24);
+        void* pBig = arena.allocate(8192);
+
+        arena.deallocate(pSmall, 24);
+        arena.deallocate(pBig, 8192);
+
+        CHECK(arena.allocate(20) == pSmall);
+        CHECK(arena.allocate(8192) == pBig);
+        CHECK_EQUAL(2u, arena.getStats().ulNbReuses);
+    }
+}
@@ -0,0 +1,67 @@
+#include <UnitTest++.h>
+#include <Athena-Inputs/Controller.h>
+
+using namespace Athena::Inputs;
+
+
+SUITE(ControllerTests)
+{
+    TEST(PreciseTimestampIsMonotonic)
+    {
+        unsigned long ulPrevious = Controller::getPreciseTimestamp();
+
+        for (unsigned int i = 0; i < 10000; ++i)
+        {
+            unsigned long ulNow = Controller::getPreciseTimestamp();
+            CHECK(ulNow >= ulPrevious);
+            ulPrevious = ulNow;
+        }
+    }
+
+
+    TEST(PreciseTimestampIsFinerThanAMillisecond)
+    {
+        // Several distinct values must be read during a single millisecond
+        UNITTEST_TIME_CONSTRAINT(100);
+
+        unsigned long ulStart = Controller::getPreciseTimestamp();
+        unsigned long ulPrevious = ulStart;
+        unsigned int uiNbValues = 0;
+
+        while (ulPrevious - ulStart < 1000)
+        {
+            unsigned long ulNow = Controller::getPreciseTimestamp();
+            if (ulNow != ulPrevious)
+            {
+                ++uiNbValues;
+                ulPrevious = ulNow;
+            }
+        }
+
+        CHECK(uiNbValues > 1);
+    }
+
+
+    TEST(PreciseTimestampIsInMicroseconds)
+    {
+        // Both clocks don't share the same origin on every platform: only compare
+        // the durations they measure
+        UNITTEST_TIME_CONSTRAINT(200);
+
+        unsigned long ulStart = Controller::getTimestamp();
+        while (Controller::getTimestamp() == ulStart)
+            ;
+
+        ulStart = Controller::getTimestamp();
+        unsigned long ulPreciseStart = Controller::getPreciseTimestamp();
+
+        while (Controller::getTimestamp() - ulStart < 50)
+            ;
+
+        unsigned long ulPreciseElapsed = Controller::getPreciseTimestamp() - ulPreciseStart;
+
+        // The millisecond clock may be coarse (about 16ms with GetTickCount())
+        CHECK(ulPreciseElapsed >= 30000);
+        CHECK(ulPreciseElapsed <= 70000);
+    }
+}
@@ -0,0 +1,247 @@
+#include <UnitTest++.h>
+#include <Athena-Inputs/InputHistory.h>
+#include <Athena-Inputs/StateEncoder.h>
+#include "environments/InputsTestEnvironment.h"
+
+using namespace Athena::Inputs;
+
+
+struct InputHistoryTestEnvironment: public InputsTestEnvironment
+{
+    static const tVirtualID KEY     = 1;
+    static const tVirtualID AXIS    = 2;
+    static const tVirtualID POV     = 3;
+
+    InputHistoryTestEnvironment()
+    {
+        pVirtualController->addVirtualKey(KEY, pController, 0);
+        pVirtualController->addVirtualAxis(AXIS, pController, (tAxis) 0);
+        pVirtualController->addVirtualPOV(POV, pController, (tPOV) 0);
+    }
+};
+
+
+//---------------------------------------------------------------------------------------
+/// @brief  Stand-in for the connection with a remote peer: the state of the virtual
+///         controller of the peer is encoded on its side, and decoded on the local one
+//---------------------------------------------------------------------------------------
+struct Loopback
+{
+    StateEncoder            encoder;
+    StateEncoder            decoder;
+    StateEncoder::tState    sentReference;
+    StateEncoder::tState    sentState;
+    StateEncoder::tState    receivedReference;
+    StateEncoder::tState    receivedState;
+    unsigned char           buffer[64];
+    unsigned int            uiSize;
+
+
+    Loopback(VirtualController* pPeer, VirtualController* pReplica)
+    : encoder(pPeer), decoder(pReplica), uiSize(0)
+    {
+        encoder.initState(sentReference);
+        encoder.initState(sentState);
+        decoder.initState(receivedReference);
+        decoder.initState(receivedState);
+    }
+
+    // Peer side
+    void send()
+    {
+        encoder.capture(sentState);
+        uiSize = encoder.encode(sentReference, sentState, buffer, sizeof(buffer));
+        sentReference = sentState;
+    }
+
+    // Local side
+    const StateEncoder::tState& receive()
+    {
+        decoder.decode(receivedReference, buffer, uiSize, receivedState);
+        receivedReference = receivedState;
+        return receivedState;
+    }
+};
+
+
+SUITE(InputHistoryTests)
+{
+    TEST_FIXTURE(InputHistoryTestEnvironment, RecordAndRestore)
+    {
+        InputHistory history(pVirtualController, 4);
+
+        pressKey(0, true);
+        moveAxis(0, 1000);
+        movePOV(0, POV_UP);
+        pInputsUnit->process();
+        history.recordFrame(1);
+
+        pressKey(0, false);
+        moveAxis(0, -500);
+        movePOV(0, POV_CENTER);
+        pInputsUnit->process();
+        history.recordFrame(2);
+
+        CHECK(history.hasFrame(1));
+        CHECK(history.hasFrame(2));
+        CHECK(!history.compareFrames(1, 2));
+        CHECK(history.compareFrame(2));
+        CHECK(!history.compareFrame(1));
+
+        CHECK(history.restoreFrame(1));
+        CHECK(pVirtualController->isKeyPressed(KEY));
+        CHECK_EQUAL(1000, pVirtualController->getAxisValue(AXIS));
+        CHECK_EQUAL(POV_UP, pVirtualController->getPOVPosition(POV));
+        CHECK(history.compareFrame(1));
+
+        CHECK(history.restoreFrame(2));
+        CHECK(!pVirtualController->isKeyPressed(KEY));
+        CHECK_EQUAL(-500, pVirtualController->getAxisValue(AXIS));
+        CHECK_EQUAL(POV_CENTER, pVirtualController->getPOVPosition(POV));
+    }
+
+
+    TEST_FIXTURE(InputHistoryTestEnvironment, Patch)
+    {
+        InputHistory history(pVirtualController, 4);
+
+        pressKey(0, true);
+        moveAxis(0, 1000);
+        pInputsUnit->process();
+        history.recordFrame(1);
+
+        // Patching a frame with its own state doesn't need a rollback
+        CHECK(!history.patchKey(1, KEY, true));
+        CHECK(!history.patchAxis(1, AXIS, 1000));
+        CHECK(!history.patchPOV(1, POV, POV_CENTER));
+
+        CHECK(history.patchKey(1, KEY, false));
+        CHECK(history.patchAxis(1, AXIS, 250));
+        CHECK(history.patchPOV(1, POV, POV_DOWNRIGHT));
+        CHECK(!history.compareFrame(1));
+
+        CHECK(history.restoreFrame(1));
+        CHECK(!pVirtualController->isKeyPressed(KEY));
+        CHECK(pVirtualController->wasKeyReleased(KEY));
+        CHECK_EQUAL(250, pVirtualController->getAxisValue(AXIS));
+        CHECK_EQUAL(POV_DOWNRIGHT, pVirtualController->getPOVPosition(POV));
+        CHECK(history.compareFrame(1));
+    }
+
+
+    TEST_FIXTURE(InputHistoryTestEnvironment, OldestFramesAreOverwritten)
+    {
+        InputHistory history(pVirtualController, 4);
+
+        for (unsigned long ulFrame = 1; ulFrame <= 6; ++ulFrame)
+        {
+            moveAxis(0, (int) ulFrame * 100);
+            pInputsUnit->process();
+            history.recordFrame(ulFrame);
+        }
+
+        CHECK(!history.hasFrame(1));
+        CHECK(!history.hasFrame(2));
+        CHECK(history.hasFrame(3));
+        CHECK(history.hasFrame(6));
+
+        CHECK(!history.restoreFrame(2));
+        CHECK(!history.patchAxis(2, AXIS, 0));
+
+        CHECK(history.restoreFrame(3));
+        CHECK_EQUAL(300, pVirtualController->getAxisValue(AXIS));
+    }
+
+
+    TEST_FIXTURE(InputHistoryTestEnvironment, UnknownVirtualParts)
+    {
+        InputHistory history(pVirtualController, 4);
+
+        pInputsUnit->process();
+        history.recordFrame(1);
+
+        CHECK(!history.patchKey(1, 100, true));
+        CHECK(!history.patchAxis(1, 100, 10));
+        CHECK(!history.patchPOV(1, 100, POV_UP));
+    }
+
+
+    TEST_FIXTURE(InputHistoryTestEnvironment, RollbackWithTheStateOfARemotePeer)
+    {
+        // The local replica of the virtual controller of the peer
+        VirtualController* pReplica = pInputsUnit->createVirtualController("Replica");
+        tAxisConditioning conditioning = *pVirtualController->getAxisConditioning(AXIS);
+
+        conditioning.fDeadZone = 0.2f;
+        conditioning.fCurve    = 1.0f;
+        pVirtualController->setAxisConditioning(AXIS, conditioning);
+
+        pReplica->registerVirtualKey(KEY);
+        pReplica->registerVirtualAxis(AXIS);
+        pReplica->registerVirtualPOV(POV);
+        pReplica->setAxisConditioning(AXIS, conditioning);
+
+        Loopback loopback(pVirtualController, pReplica);
+        InputHistory history(pReplica, 8);
+
+        // The frame is simulated locally without the input of the peer
+        pInputsUnit->process();
+        history.recordFrame(1);
+
+        // The peer's input for that frame arrives later
+        pressKey(0, true);
+        moveAxis(0, 24576);
+        movePOV(0, POV_UPLEFT);
+        pInputsUnit->process();
+        loopback.send();
+
+        const StateEncoder::tState& state = loopback.receive();
+
+        bool bRollback = history.patchKey(1, KEY, (state.keyBits[0] & 1) != 0);
+        bRollback = history.patchAxis(1, AXIS, state.axisValues[0]) || bRollback;
+        bRollback = history.patchPOV(1, POV, state.povPositions[0]) || bRollback;
+        CHECK(bRollback);
+
+        // Rollback: the replica has the state of the peer, including the derived one
+        CHECK(history.restoreFrame(1));
+        CHECK(pReplica->isKeyPressed(KEY));
+        CHECK(pReplica->wasKeyPressed(KEY));
+        CHECK_EQUAL(24576, pReplica->getAxisValue(AXIS));
+        CHECK(pReplica->wasAxisChanged(AXIS));
+        CHECK(pVirtualController->getAxisConditionedValue(AXIS) > 0.0f);
+        CHECK_CLOSE(pVirtualController->getAxisConditionedValue(AXIS),
+                    pReplica->getAxisConditionedValue(AXIS), 0.0001f);
+        CHECK_EQUAL(POV_UPLEFT, pReplica->getPOVPosition(POV));
+    }
+
+
+    TEST_FIXTURE(InputHistoryTestEnvironment, RestoredPOVMadeFromKeysContinuesFromItsPosition)
+    {
+        const tVirtualID KEYS_POV = 4;
+
+        pVirtualController->addVirtualPOV(KEYS_POV, pController, 10, 11, 12, 13);
+
+        InputHistory history(pVirtualController, 4);
+
+        // UP + LEFT held
+        pressKey(10, true);
+        pressKey(12, true);
+        pInputsUnit->process();
+        history.recordFrame(1);
+
+        pressKey(10, false);
+        pressKey(12, false);
+        pInputsUnit->process();
+        CHECK_EQUAL(POV_CENTER, pVirtualController->getPOVPosition(KEYS_POV));
+
+        // After the rollback, the real keys of the position are considered held
+        CHECK(history.restoreFrame(1));
+        CHECK_EQUAL(POV_UPLEFT, pVirtualController->getPOVPosition(KEYS_POV));
+
+        pInputsUnit->process();
+
+        pressKey(12, false);
+        pInputsUnit->process();
+        CHECK_EQUAL(POV_UP, pVirtualController->getPOVPosition(KEYS_POV));
+    }
+}
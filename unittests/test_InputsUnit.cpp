@@ -0,0 +1,93 @@
+#include <UnitTest++.h>
+#include "environments/InputsTestEnvironment.h"
+
+using namespace Athena::Inputs;
+
+
+static void addRegistration(std::vector<InputsUnit::tVirtualIDRegistration>& registrations,
+                            const std::string& strName, tVirtualID virtualID)
+{
+    InputsUnit::tVirtualIDRegistration registration;
+
+    registration.strName    = strName;
+    registration.virtualID  = virtualID;
+
+    registrations.push_back(registration);
+}
+
+
+static void addRegistration(std::vector<InputsUnit::tShortcutRegistration>& registrations,
+                            const std::string& strShortcut, tVirtualID virtualID)
+{
+    InputsUnit::tShortcutRegistration registration;
+
+    registration.strShortcut    = strShortcut;
+    registration.virtualID      = virtualID;
+
+    registrations.push_back(registration);
+}
+
+
+SUITE(InputsUnitTests)
+{
+    TEST_FIXTURE(InputsTestEnvironment, RegisterVirtualIDsAfterTheExistingOnes)
+    {
+        std::vector<InputsUnit::tVirtualIDRegistration> registrations;
+
+        pInputsUnit->registerVirtualID("A", 5);
+
+        addRegistration(registrations, "B", 0);
+        addRegistration(registrations, "C", 0);
+        addRegistration(registrations, "D", 10);
+        addRegistration(registrations, "E", 0);
+
+        CHECK_EQUAL(4u, pInputsUnit->registerVirtualIDs(registrations));
+        CHECK_EQUAL(5, pInputsUnit->getVirtualID("A"));
+        CHECK_EQUAL(6, pInputsUnit->getVirtualID("B"));
+        CHECK_EQUAL(7, pInputsUnit->getVirtualID("C"));
+        CHECK_EQUAL(10, pInputsUnit->getVirtualID("D"));
+        CHECK_EQUAL(11, pInputsUnit->getVirtualID("E"));
+    }
+
+
+    TEST_FIXTURE(InputsTestEnvironment, RejectExistingVirtualIDs)
+    {
+        std::vector<InputsUnit::tVirtualIDRegistration> registrations;
+
+        pInputsUnit->registerVirtualID("A", 5);
+
+        // Like registerVirtualID(), an existing name without supplied ID isn't an error
+        addRegistration(registrations, "A", 0);
+        addRegistration(registrations, "A", 3);
+        addRegistration(registrations, "F", 5);
+        addRegistration(registrations, "G", 12);
+        addRegistration(registrations, "G", 13);
+        addRegistration(registrations, "H", 12);
+
+        CHECK_EQUAL(1u, pInputsUnit->registerVirtualIDs(registrations));
+        CHECK_EQUAL(5, pInputsUnit->getVirtualID("A"));
+        CHECK_EQUAL(0, pInputsUnit->getVirtualID("F"));
+        CHECK_EQUAL(12, pInputsUnit->getVirtualID("G"));
+        CHECK_EQUAL(0, pInputsUnit->getVirtualID("H"));
+    }
+
+
+    TEST_FIXTURE(InputsTestEnvironment, RegisterShortcuts)
+    {
+        std::vector<InputsUnit::tShortcutRegistration> registrations;
+
+        pInputsUnit->registerShortcut("X", 1);
+
+        addRegistration(registrations, "X", 2);
+        addRegistration(registrations, "Y", 3);
+        addRegistration(registrations, "Y", 4);
+        addRegistration(registrations, "Z", 5);
+
+        // The first registration of a shortcut wins
+        CHECK_EQUAL(2u, pInputsUnit->registerShortcuts(registrations));
+        CHECK_EQUAL(1, pInputsUnit->getVirtualIDFromShortcut("X"));
+        CHECK_EQUAL(3, pInputsUnit->getVirtualIDFromShortcut("Y"));
+        CHECK_EQUAL(5, pInputsUnit->getVirtualIDFromShortcut("Z"));
+        CHECK_EQUAL("Z", pInputsUnit->getShortcutFromVirtualID(5));
+    }
+}
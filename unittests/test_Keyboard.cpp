@@ -0,0 +1,185 @@
+#include <UnitTest++.h>
+#include <Athena-Inputs/Keyboard.h>
+#include "environments/InputsTestEnvironment.h"
+
+using namespace Athena::Inputs;
+
+
+//---------------------------------------------------------------------------------------
+/// @brief  An OIS keyboard whose key presses are given by the test, and notified to its
+///         listener at the next capture
+//---------------------------------------------------------------------------------------
+class FakeOISKeyboard: public OIS::Keyboard
+{
+public:
+    FakeOISKeyboard()
+    : OIS::Keyboard("Test", true, 0, 0), m_pListener(0)
+    {
+    }
+
+    void press(OIS::KeyCode key, unsigned int uiText)
+    {
+        tPress press = { key, uiText };
+        m_presses.push_back(press);
+    }
+
+    virtual void setEventCallback(OIS::KeyListener* pListener) { m_pListener = pListener; }
+    virtual void setBuffered(bool buffered) { mBuffered = buffered; }
+    virtual OIS::Interface* queryInterface(OIS::Interface::IType type) { return 0; }
+    virtual void _initialize() {}
+    virtual bool isKeyDown(OIS::KeyCode key) const { return false; }
+    virtual const std::string& getAsString(OIS::KeyCode kc) { return m_strName; }
+    virtual void copyKeyStates(char keys[256]) const {}
+
+    virtual void capture()
+    {
+        for (unsigned int i = 0; i < m_presses.size(); ++i)
+        {
+            OIS::KeyEvent event(this, m_presses[i].key, m_presses[i].uiText);
+
+            m_pListener->keyPressed(event);
+            m_pListener->keyReleased(event);
+        }
+
+        m_presses.clear();
+    }
+
+private:
+    struct tPress
+    {
+        OIS::KeyCode    key;
+        unsigned int    uiText;
+    };
+
+    OIS::KeyListener*   m_pListener;
+    std::vector<tPress> m_presses;
+    std::string         m_strName;
+};
+
+
+//---------------------------------------------------------------------------------------
+/// @brief  A keyboard owning its fake OIS keyboard (there is no OIS input manager to
+///         destroy it)
+//---------------------------------------------------------------------------------------
+class TestKeyboard: public Keyboard
+{
+public:
+    TestKeyboard(FakeOISKeyboard* pOISKeyboard)
+    : Keyboard(pOISKeyboard)
+    {
+    }
+
+    virtual ~TestKeyboard()
+    {
+        delete m_pOISObject;
+        m_pOISObject = 0;
+    }
+};
+
+
+struct KeyboardTestEnvironment: public InputsTestEnvironment
+{
+    FakeOISKeyboard*    pOISKeyboard;
+    TestKeyboard*       pKeyboard;
+
+    KeyboardTestEnvironment()
+    {
+        pOISKeyboard    = new FakeOISKeyboard();
+        pKeyboard       = new TestKeyboard(pOISKeyboard);
+        pInputsUnit->_addController(pKeyboard);
+    }
+};
+
+
+SUITE(KeyboardTests)
+{
+    TEST_FIXTURE(KeyboardTestEnvironment, CharactersOfTheLastCapture)
+    {
+        pKeyboard->setCharacterMode(true);
+
+        pOISKeyboard->press(OIS::KC_A, 'a');
+        pOISKeyboard->press(OIS::KC_A, 0xE9);
+        pInputsUnit->process();
+
+        CHECK_EQUAL(2u, pKeyboard->getTextLength());
+        CHECK_EQUAL((unsigned int) 'a', pKeyboard->getText()[0]);
+        CHECK_EQUAL(0xE9u, pKeyboard->getText()[1]);
+
+        // The characters of the previous frame are discarded
+        pInputsUnit->process();
+        CHECK_EQUAL(0u, pKeyboard->getTextLength());
+
+        pKeyboard->setCharacterMode(false);
+    }
+
+
+    TEST_FIXTURE(KeyboardTestEnvironment, NoKeyEventInCharacterMode)
+    {
+        pVirtualController->addVirtualKey(1, pKeyboard, OIS::KC_A);
+        pVirtualController->enableEventsQueue(true);
+
+        pKeyboard->setCharacterMode(true);
+
+        // The keys without character are ignored
+        pOISKeyboard->press(OIS::KC_A, 'a');
+        pOISKeyboard->press(OIS::KC_LEFT, 0);
+        pInputsUnit->process();
+
+        CHECK_EQUAL(1u, pKeyboard->getTextLength());
+        CHECK_EQUAL(0u, pVirtualController->getNbEvents());
+
+        pKeyboard->setCharacterMode(false);
+
+        pOISKeyboard->press(OIS::KC_A, 'a');
+        pInputsUnit->process();
+
+        CHECK_EQUAL(0u, pKeyboard->getTextLength());
+        CHECK_EQUAL(2u, pVirtualController->getNbEvents());
+    }
+
+
+    TEST_FIXTURE(KeyboardTestEnvironment, SurrogatePairsCombined)
+    {
+        pKeyboard->setCharacterMode(true);
+
+        pOISKeyboard->press(OIS::KC_UNASSIGNED, 0xD83D);
+        pOISKeyboard->press(OIS::KC_UNASSIGNED, 0xDE00);
+        pInputsUnit->process();
+
+        CHECK_EQUAL(1u, pKeyboard->getTextLength());
+        CHECK_EQUAL(0x1F600u, pKeyboard->getText()[0]);
+
+        pKeyboard->setCharacterMode(false);
+    }
+
+
+    TEST_FIXTURE(KeyboardTestEnvironment, CharactersDroppedWhenTheBufferIsFull)
+    {
+        pKeyboard->setCharacterMode(true);
+
+        for (unsigned int i = 0; i < Keyboard::TEXT_BUFFER_SIZE + 3; ++i)
+            pOISKeyboard->press(OIS::KC_A, 'a' + (i % 26));
+
+        pInputsUnit->process();
+
+        // The first characters are kept
+        CHECK_EQUAL(Keyboard::TEXT_BUFFER_SIZE, pKeyboard->getTextLength());
+        CHECK_EQUAL((unsigned int) 'a', pKeyboard->getText()[0]);
+        CHECK_EQUAL(3u, pKeyboard->getNbDroppedCharacters());
+
+        pKeyboard->setCharacterMode(false);
+    }
+
+
+    TEST_FIXTURE(KeyboardTestEnvironment, KeyboardActiveInCharacterMode)
+    {
+        // Nothing is bound to the keyboard
+        CHECK(!pKeyboard->isActive());
+
+        pKeyboard->setCharacterMode(true);
+        CHECK(pKeyboard->isActive());
+
+        pKeyboard->setCharacterMode(false);
+        CHECK(!pKeyboard->isActive());
+    }
+}
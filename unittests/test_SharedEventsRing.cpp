@@ -0,0 +1,192 @@
+#include <UnitTest++.h>
+#include <Athena-Inputs/SharedEventsRing.h>
+#include <string.h>
+#include <sstream>
+
+#if ATHENA_PLATFORM == ATHENA_PLATFORM_WIN32
+#   include <process.h>
+#   define getpid _getpid
+#else
+#   include <unistd.h>
+#endif
+
+using namespace Athena::Inputs;
+
+
+/// Name of the shared memory, unique to the process (several runs of the tests can be
+/// in progress on the same machine)
+static std::string getRingName()
+{
+    std::ostringstream stream;
+    stream << "Athena-Inputs-UnitTests-" << getpid();
+    return stream.str();
+}
+
+static const std::string RING_NAME = getRingName();
+
+
+static void writeKeyEvent(SharedEventsRing& ring, unsigned int uiDevice, tKey key,
+                          bool bPressed, unsigned long ulTimestamp)
+{
+    tInputEvent event;
+
+    memset(&event, 0, sizeof(event));
+    event.part              = PART_KEY;
+    event.partID.key        = key;
+    event.value.bPressed    = bPressed;
+    event.ulTimeStamp       = ulTimestamp;
+
+    ring.write(uiDevice, event);
+}
+
+
+SUITE(SharedEventsRingTests)
+{
+    TEST(CreationAndOpening)
+    {
+        SharedEventsRing writer;
+        SharedEventsRing reader;
+
+        CHECK(!reader.open(RING_NAME));
+
+        CHECK(writer.create(RING_NAME, 100));
+        CHECK(writer.isOpen());
+        CHECK_EQUAL(128u, writer.getCapacity());
+
+        CHECK_EQUAL(0u, writer.addDevice(OIS::OISKeyboard, 0, "Keyboard", "Keyboard"));
+        CHECK_EQUAL(1u, writer.addDevice(OIS::OISJoyStick, 1, "Gamepad", "Gamepad#0"));
+
+        CHECK(reader.open(RING_NAME));
+        CHECK_EQUAL(128u, reader.getCapacity());
+        CHECK_EQUAL(2u, reader.getNbDevices());
+        CHECK_EQUAL((unsigned int) OIS::OISJoyStick, reader.getDevice(1).uiType);
+        CHECK_EQUAL(1u, reader.getDevice(1).uiIndex);
+        CHECK_EQUAL(std::string("Gamepad"), std::string(reader.getDevice(1).strName));
+        CHECK_EQUAL(std::string("Gamepad#0"), std::string(reader.getDevice(1).strIdentity));
+
+        reader.close();
+        writer.close();
+
+        CHECK(!reader.open(RING_NAME));
+    }
+
+
+    TEST(WriteAndRead)
+    {
+        SharedEventsRing writer;
+        SharedEventsRing reader;
+        SharedEventsRing::tEvent events[16];
+        tInputEvent event;
+
+        CHECK(writer.create(RING_NAME, 16));
+        writer.addDevice(OIS::OISJoyStick, 1, "Gamepad", "Gamepad#0");
+
+        // The events written before the opening are ignored
+        writeKeyEvent(writer, 0, 1, true, 1);
+
+        CHECK(reader.open(RING_NAME));
+        CHECK_EQUAL(0u, reader.read(events, 16));
+
+        writeKeyEvent(writer, 0, 5, true, 10);
+
+        memset(&event, 0, sizeof(event));
+        event.part          = PART_AXIS;
+        event.partID.axis   = 2;
+        event.value.iValue  = -1234;
+        event.ulTimeStamp   = 11;
+        writer.write(0, event);
+
+        writeKeyEvent(writer, 0, 5, false, 12);
+
+        CHECK_EQUAL(3u, reader.read(events, 16));
+
+        CHECK_EQUAL(10ul, events[0].getTimeStamp());
+        CHECK_EQUAL((unsigned int) PART_KEY, (unsigned int) events[0].part);
+        CHECK_EQUAL(5u, (unsigned int) events[0].partID);
+        CHECK_EQUAL(1, events[0].iValue);
+
+        CHECK_EQUAL((unsigned int) PART_AXIS, (unsigned int) events[1].part);
+        CHECK_EQUAL(2u, (unsigned int) events[1].partID);
+        CHECK_EQUAL(-1234, events[1].iValue);
+
+        CHECK_EQUAL(0, events[2].iValue);
+
+        CHECK_EQUAL(0u, reader.read(events, 16));
+        CHECK_EQUAL(0ul, reader.getNbLostEvents());
+    }
+
+
+    TEST(ReadInSeveralCalls)
+    {
+        SharedEventsRing writer;
+        SharedEventsRing reader;
+        SharedEventsRing::tEvent events[4];
+
+        CHECK(writer.create(RING_NAME, 16));
+        writer.addDevice(OIS::OISJoyStick, 1, "Gamepad", "Gamepad#0");
+        CHECK(reader.open(RING_NAME));
+
+        for (unsigned long i = 0; i < 10; ++i)
+            writeKeyEvent(writer, 0, 1, true, i);
+
+        CHECK_EQUAL(4u, reader.read(events, 4));
+        CHECK_EQUAL(0ul, events[0].getTimeStamp());
+        CHECK_EQUAL(4u, reader.read(events, 4));
+        CHECK_EQUAL(4ul, events[0].getTimeStamp());
+        CHECK_EQUAL(2u, reader.read(events, 4));
+        CHECK_EQUAL(8ul, events[0].getTimeStamp());
+        CHECK_EQUAL(0ul, reader.getNbLostEvents());
+    }
+
+
+    TEST(OverwrittenEventsAreCounted)
+    {
+        SharedEventsRing writer;
+        SharedEventsRing reader;
+        SharedEventsRing::tEvent events[16];
+
+        CHECK(writer.create(RING_NAME, 8));
+        writer.addDevice(OIS::OISJoyStick, 1, "Gamepad", "Gamepad#0");
+        CHECK(reader.open(RING_NAME));
+
+        for (unsigned long i = 0; i < 20; ++i)
+            writeKeyEvent(writer, 0, 1, true, i);
+
+        // The slot being written counts as overwritten: only the last 7 events remain
+        CHECK_EQUAL(7u, reader.read(events, 16));
+        CHECK_EQUAL(13ul, reader.getNbLostEvents());
+
+        for (unsigned int i = 0; i < 7; ++i)
+            CHECK_EQUAL(13ul + i, events[i].getTimeStamp());
+
+        // The reader keeps up again
+        writeKeyEvent(writer, 0, 1, false, 20);
+
+        CHECK_EQUAL(1u, reader.read(events, 16));
+        CHECK_EQUAL(20ul, events[0].getTimeStamp());
+        CHECK_EQUAL(13ul, reader.getNbLostEvents());
+    }
+
+
+    TEST(TimestampsAreNotTruncated)
+    {
+        SharedEventsRing writer;
+        SharedEventsRing reader;
+        SharedEventsRing::tEvent events[4];
+
+        // More than 32 bits when 'unsigned long' allows it (the uptime in milliseconds
+        // exceeds 32 bits after 49 days)
+        const unsigned long ulTimestamp = (sizeof(unsigned long) > 4 ?
+                                           ((((unsigned long) 0x12) << 16) << 16) | 0x345678 :
+                                           0xFFFFFFF0ul);
+
+        CHECK(writer.create(RING_NAME, 4));
+        writer.addDevice(OIS::OISJoyStick, 1, "Gamepad", "Gamepad#0");
+        CHECK(reader.open(RING_NAME));
+
+        writeKeyEvent(writer, 0, 1, true, ulTimestamp);
+
+        CHECK_EQUAL(1u, reader.read(events, 4));
+        CHECK_EQUAL(ulTimestamp, events[0].getTimeStamp());
+    }
+}
@@ -0,0 +1,156 @@
+#include <UnitTest++.h>
+#include <Athena-Inputs/StateEncoder.h>
+#include "environments/InputsTestEnvironment.h"
+
+using namespace Athena::Inputs;
+
+
+struct StateEncoderTestEnvironment: public InputsTestEnvironment
+{
+    StateEncoderTestEnvironment()
+    {
+        // More than 32 keys, so the keys use several words
+        for (tVirtualID virtualID = 1; virtualID <= 40; ++virtualID)
+            pVirtualController->addVirtualKey(virtualID, pController, (tKey) virtualID);
+
+        pVirtualController->addVirtualAxis(1, pController, (tAxis) 0);
+        pVirtualController->addVirtualAxis(2, pController, (tAxis) 1);
+        pVirtualController->addVirtualPOV(1, pController, (tPOV) 0);
+    }
+};
+
+
+SUITE(StateEncoderTests)
+{
+    TEST_FIXTURE(StateEncoderTestEnvironment, UnchangedStateFitsInOneByte)
+    {
+        StateEncoder encoder(pVirtualController);
+        StateEncoder::tState reference, state, decoded;
+        unsigned char buffer[64];
+
+        encoder.initState(reference);
+        encoder.initState(state);
+        encoder.initState(decoded);
+
+        pressKey(3, true);
+        moveAxis(0, 12345);
+        pInputsUnit->process();
+
+        encoder.capture(reference);
+        encoder.capture(state);
+
+        CHECK_EQUAL(1u, encoder.encode(reference, state, buffer, sizeof(buffer)));
+        CHECK_EQUAL(1u, encoder.decode(reference, buffer, 1, decoded));
+        CHECK(decoded.keyBits == state.keyBits);
+        CHECK(decoded.axisValues == state.axisValues);
+        CHECK(decoded.povPositions == state.povPositions);
+    }
+
+
+    TEST_FIXTURE(StateEncoderTestEnvironment, RoundTrip)
+    {
+        StateEncoder encoder(pVirtualController);
+        StateEncoder::tState reference, state, decoded;
+        unsigned char buffer[64];
+        unsigned int uiSize;
+
+        encoder.initState(reference);
+        encoder.initState(state);
+        encoder.initState(decoded);
+
+        CHECK(encoder.getMaxEncodedSize() <= sizeof(buffer));
+
+        pressKey(1, true);
+        pressKey(35, true);
+        moveAxis(0, -32768);
+        moveAxis(1, 7);
+        movePOV(0, POV_UPLEFT);
+        pInputsUnit->process();
+
+        encoder.capture(state);
+
+        uiSize = encoder.encode(reference, state, buffer, sizeof(buffer));
+        CHECK(uiSize > 1);
+        CHECK(uiSize <= encoder.getMaxEncodedSize());
+
+        CHECK_EQUAL(uiSize, encoder.decode(reference, buffer, uiSize, decoded));
+        CHECK(decoded.keyBits == state.keyBits);
+        CHECK(decoded.axisValues == state.axisValues);
+        CHECK(decoded.povPositions == state.povPositions);
+
+        // Apply the decoded state to the virtual controller
+        pressKey(1, false);
+        pressKey(35, false);
+        moveAxis(0, 0);
+        moveAxis(1, 0);
+        movePOV(0, POV_CENTER);
+        pInputsUnit->process();
+
+        encoder.apply(decoded);
+
+        CHECK(pVirtualController->isKeyPressed(1));
+        CHECK(!pVirtualController->isKeyPressed(2));
+        CHECK(pVirtualController->isKeyPressed(35));
+        CHECK_EQUAL(-32768, pVirtualController->getAxisValue(1));
+        CHECK_EQUAL(7, pVirtualController->getAxisValue(2));
+        CHECK_EQUAL(POV_UPLEFT, pVirtualController->getPOVPosition(1));
+
+        // The conditioned values are computed from the applied values
+        CHECK_CLOSE(-1.0f, pVirtualController->getAxisConditionedValue(1), 0.001f);
+        CHECK_CLOSE(7.0f / 32767.0f, pVirtualController->getAxisConditionedValue(2), 0.001f);
+    }
+
+
+    TEST_FIXTURE(StateEncoderTestEnvironment, Quantization)
+    {
+        StateEncoder encoder(pVirtualController, 4);
+        StateEncoder::tState reference, state, decoded;
+        unsigned char buffer[64];
+        unsigned int uiSize;
+
+        encoder.initState(reference);
+        encoder.initState(state);
+        encoder.initState(decoded);
+
+        moveAxis(0, 1000);
+        moveAxis(1, -1000);
+        pInputsUnit->process();
+
+        encoder.capture(state);
+
+        uiSize = encoder.encode(reference, state, buffer, sizeof(buffer));
+        CHECK_EQUAL(uiSize, encoder.decode(reference, buffer, uiSize, decoded));
+
+        encoder.apply(decoded);
+
+        // The low bits are dropped
+        CHECK_EQUAL(992, pVirtualController->getAxisValue(1));
+        CHECK_EQUAL(-1008, pVirtualController->getAxisValue(2));
+        CHECK_CLOSE(992.0f / 32767.0f, pVirtualController->getAxisConditionedValue(1), 0.0001f);
+        CHECK_CLOSE(-1008.0f / 32767.0f, pVirtualController->getAxisConditionedValue(2), 0.0001f);
+    }
+
+
+    TEST_FIXTURE(StateEncoderTestEnvironment, InvalidEncodedState)
+    {
+        StateEncoder encoder(pVirtualController);
+        StateEncoder::tState reference, state, decoded;
+        unsigned char buffer[64];
+        unsigned int uiSize;
+
+        encoder.initState(reference);
+        encoder.initState(state);
+        encoder.initState(decoded);
+
+        pressKey(1, true);
+        moveAxis(0, 30000);
+        pInputsUnit->process();
+
+        encoder.capture(state);
+
+        uiSize = encoder.encode(reference, state, buffer, sizeof(buffer));
+
+        CHECK_EQUAL(0u, encoder.encode(reference, state, buffer, uiSize - 1));
+        CHECK_EQUAL(0u, encoder.decode(reference, buffer, uiSize - 1, decoded));
+    }
+}
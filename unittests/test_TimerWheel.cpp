@@ -0,0 +1,94 @@
+#include <UnitTest++.h>
+#include <Athena-Inputs/TimerWheel.h>
+
+using namespace Athena::Inputs;
+
+
+SUITE(TimerWheelTests)
+{
+    TEST(TimerExpiresAtItsDeadline)
+    {
+        TimerWheel wheel;
+        std::vector<TimerWheel::tExpiredTimer> expired;
+
+        wheel.schedule(1000, 1);
+
+        wheel.advance(999, expired);
+        CHECK_EQUAL(0, expired.size());
+
+        wheel.advance(1000, expired);
+        CHECK_EQUAL(1, expired.size());
+        CHECK_EQUAL(1, expired[0].uiData);
+        CHECK_EQUAL(0, wheel.getNbTimers());
+    }
+
+
+    TEST(LargeDeadlineOnFreshWheelDoesntProcessTheElapsedTime)
+    {
+        // A deadline based on the uptime of the machine: the wheel must not process
+        // every millisecond since 0
+        UNITTEST_TIME_CONSTRAINT(100);
+
+        const unsigned long ulNow = 4000000000UL;
+
+        TimerWheel wheel;
+        std::vector<TimerWheel::tExpiredTimer> expired;
+
+        wheel.schedule(ulNow + 500, 1);
+
+        wheel.advance(ulNow, expired);
+        CHECK_EQUAL(0, expired.size());
+
+        wheel.advance(ulNow + 500, expired);
+        CHECK_EQUAL(1, expired.size());
+    }
+
+
+    TEST(EarlierDeadlineScheduledAfterALaterOneIsntDelayed)
+    {
+        TimerWheel wheel;
+        std::vector<TimerWheel::tExpiredTimer> expired;
+
+        wheel.schedule(100000, 1);
+        wheel.schedule(99050, 2);
+
+        wheel.advance(99050, expired);
+        CHECK_EQUAL(1, expired.size());
+        CHECK_EQUAL(2, expired[0].uiData);
+
+        wheel.advance(100000, expired);
+        CHECK_EQUAL(2, expired.size());
+        CHECK_EQUAL(1, expired[1].uiData);
+    }
+
+
+    TEST(ReachedDeadlineExpiresAtNextAdvance)
+    {
+        TimerWheel wheel;
+        std::vector<TimerWheel::tExpiredTimer> expired;
+
+        wheel.schedule(2000, 1);
+        wheel.advance(1500, expired);
+
+        wheel.schedule(1200, 2);
+        wheel.advance(1501, expired);
+
+        CHECK_EQUAL(1, expired.size());
+        CHECK_EQUAL(2, expired[0].uiData);
+    }
+
+
+    TEST(CancelledTimerDoesntExpire)
+    {
+        TimerWheel wheel;
+        std::vector<TimerWheel::tExpiredTimer> expired;
+
+        TimerWheel::tTimerID timer = wheel.schedule(1000, 1);
+
+        CHECK(wheel.cancel(timer));
+        CHECK(!wheel.cancel(timer));
+
+        wheel.advance(2000, expired);
+        CHECK_EQUAL(0, expired.size());
+    }
+}
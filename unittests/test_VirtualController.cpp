@@ -0,0 +1,721 @@
+#include <UnitTest++.h>
+#include <Athena-Inputs/ComboRecognizer.h>
+#include <Athena-Inputs/IVirtualEventsListener.h>
+#include <Athena-Inputs/StateEncoder.h>
+#include "environments/InputsTestEnvironment.h"
+
+using namespace Athena::Inputs;
+
+
+struct RecordingListener: public IVirtualEventsListener
+{
+    std::vector<tVirtualEvent> events;
+
+    virtual void onEvent(tVirtualEvent* pEvent)
+    {
+        events.push_back(*pEvent);
+    }
+};
+
+
+struct VirtualControllerTestEnvironment: public InputsTestEnvironment
+{
+    static const tVirtualID KEY     = 1;
+    static const tVirtualID AXIS    = 2;
+    static const tVirtualID POV     = 3;
+
+    VirtualControllerTestEnvironment()
+    {
+        pVirtualController->addVirtualKey(KEY, pController, 0);
+        pVirtualController->addVirtualAxis(AXIS, pController, (tAxis) 0);
+        pVirtualController->addVirtualPOV(POV, pController, (tPOV) 0);
+        pVirtualController->enableEventsQueue(true);
+    }
+
+    unsigned int countEvents(tVirtualID virtualID, bool bPressed)
+    {
+        const tVirtualEvent* pEvents = pVirtualController->getEvents();
+        unsigned int uiCount = 0;
+
+        for (unsigned int i = 0; i < pVirtualController->getNbEvents(); ++i)
+        {
+            if ((pEvents[i].part == PART_KEY) && (pEvents[i].virtualID == virtualID) &&
+                (pEvents[i].value.bPressed == bPressed))
+            {
+                ++uiCount;
+            }
+        }
+
+        return uiCount;
+    }
+
+    unsigned int countAxisEvents(tVirtualID virtualID)
+    {
+        const tVirtualEvent* pEvents = pVirtualController->getEvents();
+        unsigned int uiCount = 0;
+
+        for (unsigned int i = 0; i < pVirtualController->getNbEvents(); ++i)
+        {
+            if ((pEvents[i].part == PART_AXIS) && (pEvents[i].virtualID == virtualID))
+                ++uiCount;
+        }
+
+        return uiCount;
+    }
+};
+
+
+SUITE(VirtualControllerTests)
+{
+    TEST_FIXTURE(VirtualControllerTestEnvironment, RepeatConfiguredOnHeldKey)
+    {
+        // The deadlines are based on the uptime of the machine: the timer wheel must
+        // not process every millisecond since 0
+        UNITTEST_TIME_CONSTRAINT(100);
+
+        pressKey(0, true);
+        pInputsUnit->process();
+
+        pVirtualController->setKeyRepeat(KEY, 100, 50);
+
+        // The repeats scheduled before the release are fired with it
+        ulTimestamp += 1000;
+        pressKey(0, false);
+        pInputsUnit->process();
+
+        CHECK_EQUAL(19, countEvents(KEY, true));
+        CHECK_EQUAL(1, countEvents(KEY, false));
+        CHECK(!pVirtualController->isKeyPressed(KEY));
+    }
+
+
+    TEST_FIXTURE(VirtualControllerTestEnvironment, ChordPressedAfterReenabling)
+    {
+        const tVirtualID CHORD = 10;
+
+        std::vector<tChordKey> keys(2);
+        keys[0].pController = pController;
+        keys[0].key         = 1;
+        keys[1].pController = pController;
+        keys[1].key         = 2;
+
+        pVirtualController->addVirtualChord(CHORD, keys);
+
+        pressKey(1, true);
+        pressKey(2, true);
+        pInputsUnit->process();
+        CHECK(pVirtualController->isKeyPressed(CHORD));
+
+        pressKey(1, false);
+        pressKey(2, false);
+        pInputsUnit->process();
+        CHECK(!pVirtualController->isKeyPressed(CHORD));
+
+        pVirtualController->enable(false);
+        pInputsUnit->process();
+        pVirtualController->enable(true);
+
+        // The state written by the chord must not be reset as stale when read
+        pressKey(1, true);
+        pressKey(2, true);
+        pInputsUnit->process();
+        CHECK(pVirtualController->isKeyPressed(CHORD));
+        CHECK(pVirtualController->wasKeyPressed(CHORD));
+    }
+
+
+    TEST_FIXTURE(VirtualControllerTestEnvironment, ComboPressedAfterReenabling)
+    {
+        const tVirtualID KEY2   = 4;
+        const tVirtualID COMBO  = 20;
+
+        ComboRecognizer recognizer;
+        std::vector<ComboRecognizer::tStep> steps(2);
+
+        steps[0].virtualID  = KEY;
+        steps[0].part       = PART_KEY;
+        steps[0].ulMaxDelay = 0;
+        steps[1].virtualID  = KEY2;
+        steps[1].part       = PART_KEY;
+        steps[1].ulMaxDelay = 200;
+
+        CHECK(recognizer.addCombo(COMBO, steps));
+
+        pVirtualController->addVirtualKey(KEY2, pController, 1);
+        pVirtualController->registerVirtualKey(COMBO);
+        pVirtualController->setComboRecognizer(&recognizer);
+
+        pressKey(0, true);
+        pressKey(0, false);
+        pressKey(1, true);
+        pressKey(1, false);
+        pInputsUnit->process();
+        CHECK(pVirtualController->wasKeyPressed(COMBO));
+
+        // The virtual key of the combo is released at the next frame
+        pInputsUnit->process();
+        CHECK(!pVirtualController->isKeyPressed(COMBO));
+
+        pVirtualController->enable(false);
+        pInputsUnit->process();
+        pVirtualController->enable(true);
+
+        // The state written by the combo must not be reset as stale when read
+        pressKey(0, true);
+        pressKey(0, false);
+        pressKey(1, true);
+        pressKey(1, false);
+        pInputsUnit->process();
+        CHECK(pVirtualController->isKeyPressed(COMBO));
+        CHECK(pVirtualController->wasKeyPressed(COMBO));
+
+        pVirtualController->setComboRecognizer(0);
+    }
+
+
+    TEST_FIXTURE(VirtualControllerTestEnvironment, HoldThresholdPulsedAfterReenabling)
+    {
+        const tVirtualID THRESHOLD = 30;
+
+        pVirtualController->registerVirtualKey(THRESHOLD);
+        pVirtualController->addHoldThreshold(KEY, 100, THRESHOLD);
+
+        pVirtualController->enable(false);
+        pInputsUnit->process();
+        pVirtualController->enable(true);
+
+        // Released before the threshold
+        pressKey(0, true);
+        ulTimestamp += 50;
+        pressKey(0, false);
+        pInputsUnit->process();
+        CHECK_EQUAL(0, countEvents(THRESHOLD, true));
+
+        // The threshold reached before the release is fired with it
+        pressKey(0, true);
+        ulTimestamp += 500;
+        pressKey(0, false);
+        pInputsUnit->process();
+        CHECK_EQUAL(1, countEvents(THRESHOLD, true));
+        CHECK(pVirtualController->isKeyPressed(THRESHOLD));
+        CHECK(pVirtualController->wasKeyPressed(THRESHOLD));
+
+        pInputsUnit->process();
+        CHECK(!pVirtualController->isKeyPressed(THRESHOLD));
+    }
+
+
+    TEST_FIXTURE(VirtualControllerTestEnvironment, RepeatsPulsedAfterReenabling)
+    {
+        pVirtualController->setKeyRepeat(KEY, 100, 50);
+
+        pressKey(0, true);
+        pInputsUnit->process();
+
+        // The repeats of the key held while disabled are forgotten
+        pVirtualController->enable(false);
+        pInputsUnit->process();
+        pVirtualController->enable(true);
+
+        pressKey(0, false);
+        pInputsUnit->process();
+        CHECK_EQUAL(0, countEvents(KEY, true));
+
+        pressKey(0, true);
+        ulTimestamp += 200;
+        pressKey(0, false);
+        pInputsUnit->process();
+        CHECK_EQUAL(4, countEvents(KEY, true));
+        CHECK(!pVirtualController->isKeyPressed(KEY));
+    }
+
+
+    TEST_FIXTURE(VirtualControllerTestEnvironment, StateAtMomentsOfTheFrame)
+    {
+        pVirtualController->enableTransitionsLog(true);
+
+        pressKey(0, true);
+        moveAxis(0, 1000);
+        pInputsUnit->process();
+
+        unsigned long ulStart = ulTimestamp;
+
+        ulTimestamp += 99;
+        pressKey(0, false);
+        ulTimestamp += 99;
+        moveAxis(0, -1000);
+        pInputsUnit->process();
+
+        // The state at the beginning of the frame is the one at the end of the previous
+        // frame
+        CHECK(pVirtualController->isKeyPressedAt(KEY, ulStart));
+        CHECK(!pVirtualController->isKeyPressedAt(KEY, ulStart + 100));
+        CHECK_CLOSE(0.5f, pVirtualController->getKeyPressedFraction(KEY, ulStart, ulStart + 200), 0.01f);
+        CHECK_EQUAL(1000, pVirtualController->getAxisValueAt(AXIS, ulStart + 100));
+        CHECK_EQUAL(-1000, pVirtualController->getAxisValueAt(AXIS, ulStart + 200));
+
+        // Without transition, the state is the one of the previous frame
+        pInputsUnit->process();
+        CHECK(!pVirtualController->isKeyPressedAt(KEY, ulStart));
+        CHECK_EQUAL(-1000, pVirtualController->getAxisValueAt(AXIS, ulStart));
+        CHECK_EQUAL(POV_CENTER, pVirtualController->getPOVPositionAt(POV, ulStart));
+    }
+
+
+    TEST_FIXTURE(VirtualControllerTestEnvironment, ReattachOnlyTheDetachedParts)
+    {
+        std::vector<tVirtualPart> parts;
+
+        // Unbound parts using the same virtual ID as the key
+        pVirtualController->registerVirtualAxis(KEY);
+        pVirtualController->registerVirtualPOV(KEY);
+
+        pVirtualController->_detachController(pController, parts);
+        CHECK_EQUAL(3u, parts.size());
+
+        pVirtualController->_attachController(pController, parts);
+
+        pressKey(0, true);
+        moveAxis(0, 1000);
+        movePOV(0, POV_UP);
+        pInputsUnit->process();
+
+        CHECK(pVirtualController->isKeyPressed(KEY));
+        CHECK_EQUAL(1000, pVirtualController->getAxisValue(AXIS));
+        CHECK_EQUAL(POV_UP, pVirtualController->getPOVPosition(POV));
+
+        // The unbound parts are still unbound
+        CHECK_EQUAL(0, pVirtualController->getAxisValue(KEY));
+        CHECK_EQUAL(POV_CENTER, pVirtualController->getPOVPosition(KEY));
+    }
+
+
+    TEST_FIXTURE(VirtualControllerTestEnvironment, ControllerWithListenersStaysActive)
+    {
+        struct tListener: public IEventsListener
+        {
+            virtual void onEvent(tInputEvent* pEvent) {}
+        } listener;
+
+        pController->registerListener(&listener);
+
+        // The virtual parts bound to the controller are removed
+        pInputsUnit->destroyVirtualController(pVirtualController);
+        pVirtualController = 0;
+        CHECK(pController->isActive());
+
+        pController->removeListener(&listener);
+        CHECK(!pController->isActive());
+
+        pController->registerListener(&listener);
+        CHECK(pController->isActive());
+
+        pController->removeListener(&listener);
+    }
+
+
+    TEST_FIXTURE(VirtualControllerTestEnvironment, KeySources)
+    {
+        std::vector<tVirtualPart> parts;
+
+        pVirtualController->registerVirtualKey(10);
+
+        const tVirtualKeySource* pSource = pVirtualController->getVirtualKeySource(KEY);
+        CHECK(pSource != 0);
+        CHECK(pSource->pController == pController);
+        CHECK_EQUAL(0, pSource->key);
+
+        CHECK(pVirtualController->getVirtualKeySource(10)->pController == 0);
+        CHECK(pVirtualController->getVirtualKeySource(11) == 0);
+
+        // The source is unbound when the controller is detached
+        pVirtualController->_detachController(pController, parts);
+        CHECK(pSource->pController == 0);
+
+        pVirtualController->_attachController(pController, parts);
+        CHECK(pSource->pController == pController);
+    }
+
+
+    TEST_FIXTURE(VirtualControllerTestEnvironment, AxisConditioning)
+    {
+        tAxisConditioning conditioning = *pVirtualController->getAxisConditioning(AXIS);
+
+        // Range
+        conditioning.iRange = 1000;
+        pVirtualController->setAxisConditioning(AXIS, conditioning);
+
+        moveAxis(0, 500);
+        pInputsUnit->process();
+        CHECK_CLOSE(0.5f, pVirtualController->getAxisConditionedValue(AXIS), 0.001f);
+
+        moveAxis(0, -2000);
+        pInputsUnit->process();
+        CHECK_CLOSE(-1.0f, pVirtualController->getAxisConditionedValue(AXIS), 0.001f);
+
+        // Dead zone
+        conditioning.fDeadZone = 0.2f;
+        pVirtualController->setAxisConditioning(AXIS, conditioning);
+
+        moveAxis(0, 100);
+        pInputsUnit->process();
+        CHECK_CLOSE(0.0f, pVirtualController->getAxisConditionedValue(AXIS), 0.001f);
+
+        moveAxis(0, 600);
+        pInputsUnit->process();
+        CHECK_CLOSE(0.5f, pVirtualController->getAxisConditionedValue(AXIS), 0.001f);
+
+        // Response curve (cubic), applied to the current value without waiting for a move
+        conditioning.fCurve = 1.0f;
+        pVirtualController->setAxisConditioning(AXIS, conditioning);
+        CHECK_CLOSE(0.125f, pVirtualController->getAxisConditionedValue(AXIS), 0.001f);
+    }
+
+
+    TEST_FIXTURE(VirtualControllerTestEnvironment, SetAxisConditioningOnlyConditionsThatAxis)
+    {
+        pVirtualController->addVirtualAxis(4, pController, (tAxis) 1);
+
+        // The axis is conditioned at the end of the frame
+        pVirtualController->_setAxisValue(pVirtualController->getVirtualAxis(AXIS), 16384);
+
+        tAxisConditioning conditioning = *pVirtualController->getAxisConditioning(4);
+        conditioning.fScale = 0.5f;
+        pVirtualController->setAxisConditioning(4, conditioning);
+
+        CHECK_CLOSE(0.0f, pVirtualController->getAxisConditionedValue(AXIS), 0.001f);
+
+        pVirtualController->_conditionAxes();
+        CHECK_CLOSE(0.5f, pVirtualController->getAxisConditionedValue(AXIS), 0.001f);
+    }
+
+
+    TEST_FIXTURE(VirtualControllerTestEnvironment, POVMadeFromAxesComputedOncePerFrame)
+    {
+        unsigned int uiNbEvents = 0;
+
+        pVirtualController->addVirtualPOV(10, pController, (tAxis) 2, (tAxis) 3);
+        pVirtualController->addVirtualPOV(11, pController, (tAxis) 4, (tAxis) 5);
+
+        // The moves of the axes of the two POVs are interleaved
+        moveAxis(2, -32768);
+        moveAxis(4, 32767);
+        moveAxis(3, -32768);
+        moveAxis(5, 32767);
+        pInputsUnit->process();
+
+        CHECK_EQUAL(POV_UPLEFT, pVirtualController->getPOVPosition(10));
+        CHECK_EQUAL(POV_DOWNRIGHT, pVirtualController->getPOVPosition(11));
+
+        const tVirtualEvent* pEvents = pVirtualController->getEvents();
+        for (unsigned int i = 0; i < pVirtualController->getNbEvents(); ++i)
+        {
+            if (pEvents[i].part == PART_POV)
+                ++uiNbEvents;
+        }
+
+        CHECK_EQUAL(2u, uiNbEvents);
+    }
+
+
+    TEST_FIXTURE(VirtualControllerTestEnvironment, EventsQueueInTheOrderOfTheFrame)
+    {
+        pressKey(0, true);
+        moveAxis(0, 1000);
+        movePOV(0, POV_UP);
+        pInputsUnit->process();
+
+        const tVirtualEvent* pEvents = pVirtualController->getEvents();
+        CHECK_EQUAL(3u, pVirtualController->getNbEvents());
+
+        CHECK_EQUAL(PART_KEY, pEvents[0].part);
+        CHECK_EQUAL(KEY, pEvents[0].virtualID);
+        CHECK(pEvents[0].value.bPressed);
+
+        CHECK_EQUAL(PART_AXIS, pEvents[1].part);
+        CHECK_EQUAL(AXIS, pEvents[1].virtualID);
+        CHECK_EQUAL(1000, pEvents[1].value.iValue);
+
+        CHECK_EQUAL(PART_POV, pEvents[2].part);
+        CHECK_EQUAL(POV, pEvents[2].virtualID);
+        CHECK_EQUAL(POV_UP, pEvents[2].value.position);
+    }
+
+
+    TEST_FIXTURE(VirtualControllerTestEnvironment, EventsQueueClearedAtEachFrame)
+    {
+        pressKey(0, true);
+        pInputsUnit->process();
+        CHECK_EQUAL(1u, pVirtualController->getNbEvents());
+
+        pInputsUnit->process();
+        CHECK_EQUAL(0u, pVirtualController->getNbEvents());
+        CHECK(pVirtualController->getEvents() == 0);
+    }
+
+
+    TEST_FIXTURE(VirtualControllerTestEnvironment, ListenerNotifiedWithAndWithoutEventsQueue)
+    {
+        RecordingListener listener;
+
+        pVirtualController->setEventsListener(&listener);
+
+        pressKey(0, true);
+        pInputsUnit->process();
+        CHECK_EQUAL(1u, listener.events.size());
+        CHECK_EQUAL(1u, pVirtualController->getNbEvents());
+
+        pVirtualController->enableEventsQueue(false);
+        CHECK(!pVirtualController->isEventsQueueEnabled());
+
+        pressKey(0, false);
+        pInputsUnit->process();
+        CHECK_EQUAL(2u, listener.events.size());
+        CHECK_EQUAL(0u, pVirtualController->getNbEvents());
+
+        pVirtualController->setEventsListener(0);
+    }
+
+
+    TEST_FIXTURE(VirtualControllerTestEnvironment, ListenersOnlyNotifiedOfTheirEvents)
+    {
+        RecordingListener keysListener, axisListener, allListener;
+        VirtualEventsFilter filter;
+
+        filter.addPart(PART_KEY);
+        pVirtualController->addEventsListener(&keysListener, filter);
+
+        filter.clear();
+        filter.add(AXIS, PART_AXIS);
+        pVirtualController->addEventsListener(&axisListener, filter);
+
+        filter.addAll();
+        pVirtualController->addEventsListener(&allListener, filter);
+
+        pressKey(0, true);
+        moveAxis(0, 1000);
+        movePOV(0, POV_UP);
+        pInputsUnit->process();
+
+        CHECK_EQUAL(1u, keysListener.events.size());
+        CHECK_EQUAL(PART_KEY, keysListener.events[0].part);
+
+        CHECK_EQUAL(1u, axisListener.events.size());
+        CHECK_EQUAL(PART_AXIS, axisListener.events[0].part);
+
+        CHECK_EQUAL(3u, allListener.events.size());
+    }
+
+
+    TEST_FIXTURE(VirtualControllerTestEnvironment, ReplaceAndRemoveTheFilterOfAListener)
+    {
+        RecordingListener listener;
+        VirtualEventsFilter filter;
+
+        filter.add(KEY, PART_KEY);
+        pVirtualController->addEventsListener(&listener, filter);
+
+        // Adding the listener again replaces its filter (it isn't notified twice)
+        filter.clear();
+        filter.add(AXIS, PART_AXIS);
+        pVirtualController->addEventsListener(&listener, filter);
+
+        pressKey(0, true);
+        moveAxis(0, 1000);
+        pInputsUnit->process();
+
+        CHECK_EQUAL(1u, listener.events.size());
+        CHECK_EQUAL(PART_AXIS, listener.events[0].part);
+
+        pVirtualController->removeEventsListener(&listener);
+
+        moveAxis(0, -1000);
+        pInputsUnit->process();
+
+        CHECK_EQUAL(1u, listener.events.size());
+    }
+
+
+    TEST_FIXTURE(VirtualControllerTestEnvironment, ModifiedPartsResetAtTheNextFrame)
+    {
+        pressKey(0, true);
+        pressKey(0, false);
+        pressKey(0, true);
+        moveAxis(0, 1000);
+        movePOV(0, POV_UP);
+        pInputsUnit->process();
+
+        CHECK(pVirtualController->wasKeyToggled(KEY));
+        CHECK(pVirtualController->wasAxisChanged(AXIS));
+        CHECK(pVirtualController->wasPOVChanged(POV));
+
+        pInputsUnit->process();
+
+        CHECK(!pVirtualController->wasKeyToggled(KEY));
+        CHECK(!pVirtualController->wasAxisChanged(AXIS));
+        CHECK(!pVirtualController->wasPOVChanged(POV));
+        CHECK(pVirtualController->isKeyPressed(KEY));
+    }
+
+
+    TEST_FIXTURE(VirtualControllerTestEnvironment, PartsSetWithoutEventResetAtTheNextFrame)
+    {
+        StateEncoder encoder(pVirtualController);
+        StateEncoder::tState state;
+
+        encoder.initState(state);
+        state.keyBits[0]        = 1;
+        state.axisValues[0]     = 1000;
+        state.povPositions[0]   = POV_UP;
+
+        encoder.apply(state);
+
+        CHECK(pVirtualController->wasKeyToggled(KEY));
+        CHECK(pVirtualController->wasAxisChanged(AXIS));
+        CHECK(pVirtualController->wasPOVChanged(POV));
+
+        pInputsUnit->process();
+
+        CHECK(!pVirtualController->wasKeyToggled(KEY));
+        CHECK(!pVirtualController->wasAxisChanged(AXIS));
+        CHECK(!pVirtualController->wasPOVChanged(POV));
+
+        // The following frames only reset the parts modified by the events
+        pressKey(0, false);
+        pInputsUnit->process();
+        CHECK(pVirtualController->wasKeyToggled(KEY));
+
+        pInputsUnit->process();
+        CHECK(!pVirtualController->wasKeyToggled(KEY));
+    }
+
+
+    TEST_FIXTURE(VirtualControllerTestEnvironment, SmallMovesOfTheGamepadsNotReported)
+    {
+        // The default threshold of the gamepads is 10
+        moveAxis(0, 9);
+        pInputsUnit->process();
+
+        CHECK_EQUAL(0u, countAxisEvents(AXIS));
+        CHECK_EQUAL(1u, pVirtualController->getNbCoalescedEvents());
+        CHECK(!pVirtualController->wasAxisChanged(AXIS));
+
+        // The value is updated anyway
+        CHECK_EQUAL(9, pVirtualController->getAxisValue(AXIS));
+
+        moveAxis(0, 10);
+        pInputsUnit->process();
+
+        CHECK_EQUAL(1u, countAxisEvents(AXIS));
+        CHECK(pVirtualController->wasAxisChanged(AXIS));
+    }
+
+
+    TEST_FIXTURE(VirtualControllerTestEnvironment, ThresholdMeasuredFromTheLastReport)
+    {
+        const tVirtualEvent* pEvents;
+
+        pVirtualController->setAxisChangePolicy(AXIS, AXIS_CHANGE_THRESHOLD, 100);
+
+        // A slow drift is reported once it is large enough
+        moveAxis(0, 40);
+        moveAxis(0, 80);
+        moveAxis(0, 120);
+        moveAxis(0, 160);
+        moveAxis(0, 200);
+        moveAxis(0, 240);
+        pInputsUnit->process();
+
+        pEvents = pVirtualController->getEvents();
+        CHECK_EQUAL(2u, countAxisEvents(AXIS));
+        CHECK_EQUAL(120, pEvents[0].value.iValue);
+        CHECK_EQUAL(240, pEvents[1].value.iValue);
+
+        moveAxis(0, 141);
+        pInputsUnit->process();
+        CHECK_EQUAL(0u, countAxisEvents(AXIS));
+
+        moveAxis(0, 140);
+        pInputsUnit->process();
+        CHECK_EQUAL(1u, countAxisEvents(AXIS));
+    }
+
+
+    TEST_FIXTURE(VirtualControllerTestEnvironment, QuantizedMovesReportedInOtherBuckets)
+    {
+        const tVirtualEvent* pEvents;
+
+        pVirtualController->setAxisChangePolicy(AXIS, AXIS_CHANGE_QUANTIZED, 100);
+
+        // The buckets of the negative values are rounded towards minus infinity
+        moveAxis(0, 50);
+        moveAxis(0, 99);
+        moveAxis(0, 100);
+        moveAxis(0, -1);
+        moveAxis(0, -100);
+        moveAxis(0, -101);
+        pInputsUnit->process();
+
+        pEvents = pVirtualController->getEvents();
+        CHECK_EQUAL(3u, countAxisEvents(AXIS));
+        CHECK_EQUAL(100, pEvents[0].value.iValue);
+        CHECK_EQUAL(-1, pEvents[1].value.iValue);
+        CHECK_EQUAL(-101, pEvents[2].value.iValue);
+    }
+
+
+    TEST_FIXTURE(VirtualControllerTestEnvironment, AllMovesReported)
+    {
+        pVirtualController->setAxisChangePolicy(AXIS, AXIS_CHANGE_ALWAYS);
+
+        moveAxis(0, 1);
+        moveAxis(0, 2);
+        moveAxis(0, 1);
+        pInputsUnit->process();
+
+        CHECK_EQUAL(3u, countAxisEvents(AXIS));
+        CHECK_EQUAL(0u, pVirtualController->getNbCoalescedEvents());
+    }
+
+
+    TEST_FIXTURE(VirtualControllerTestEnvironment, AddSeveralVirtualKeys)
+    {
+        std::vector<tVirtualKeyBinding> bindings(3);
+
+        bindings[0].virtualID   = 10;
+        bindings[0].pController = pController;
+        bindings[0].key         = 1;
+        bindings[0].strShortcut = "Jump";
+
+        bindings[1].virtualID   = 11;
+        bindings[1].pController = pController;
+        bindings[1].key         = 2;
+
+        // Replaces the existing virtual key
+        bindings[2].virtualID   = KEY;
+        bindings[2].pController = pController;
+        bindings[2].key         = 3;
+        bindings[2].strShortcut = "Fire";
+
+        pVirtualController->addVirtualKeys(bindings);
+
+        CHECK_EQUAL(10, pInputsUnit->getVirtualIDFromShortcut("Jump"));
+        CHECK_EQUAL(KEY, pInputsUnit->getVirtualIDFromShortcut("Fire"));
+        CHECK(pVirtualController->getVirtualKeySource(10)->bHasShortcut);
+        CHECK(!pVirtualController->getVirtualKeySource(11)->bHasShortcut);
+
+        pressKey(1, true);
+        pressKey(3, true);
+        pInputsUnit->process();
+
+        CHECK(pVirtualController->isKeyPressed(10));
+        CHECK(!pVirtualController->isKeyPressed(11));
+        CHECK(pVirtualController->isKeyPressed(KEY));
+
+        // The real key previously bound isn't used anymore
+        pressKey(3, false);
+        pressKey(0, true);
+        pInputsUnit->process();
+        CHECK(!pVirtualController->isKeyPressed(KEY));
+    }
+}
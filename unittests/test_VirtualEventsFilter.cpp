@@ -0,0 +1,91 @@
+#include <UnitTest++.h>
+#include <Athena-Inputs/VirtualEventsFilter.h>
+
+using namespace Athena::Inputs;
+
+
+static tVirtualEvent makeEvent(tVirtualID virtualID, tControllerPart part)
+{
+    tVirtualEvent event;
+
+    event.virtualID     = virtualID;
+    event.part          = part;
+    event.ulTimestamp   = 0;
+
+    return event;
+}
+
+
+SUITE(VirtualEventsFilterTests)
+{
+    TEST(NewFilterDoesntAcceptAnything)
+    {
+        VirtualEventsFilter filter;
+
+        CHECK(!filter.accepts(makeEvent(0, PART_KEY)));
+        CHECK(!filter.accepts(makeEvent(1000, PART_AXIS)));
+    }
+
+
+    TEST(AcceptAllThePartsOfAVirtualID)
+    {
+        VirtualEventsFilter filter;
+
+        filter.add(40);
+
+        CHECK(filter.accepts(makeEvent(40, PART_KEY)));
+        CHECK(filter.accepts(makeEvent(40, PART_AXIS)));
+        CHECK(filter.accepts(makeEvent(40, PART_POV)));
+        CHECK(!filter.accepts(makeEvent(39, PART_KEY)));
+        CHECK(!filter.accepts(makeEvent(41, PART_KEY)));
+    }
+
+
+    TEST(AcceptOnePartOfAVirtualID)
+    {
+        VirtualEventsFilter filter;
+
+        filter.add(3, PART_AXIS);
+
+        CHECK(filter.accepts(makeEvent(3, PART_AXIS)));
+        CHECK(!filter.accepts(makeEvent(3, PART_KEY)));
+        CHECK(!filter.accepts(makeEvent(3, PART_POV)));
+    }
+
+
+    TEST(RemoveAVirtualID)
+    {
+        VirtualEventsFilter filter;
+
+        filter.add(3);
+        filter.add(4);
+        filter.addPart(PART_POV);
+
+        filter.remove(3);
+
+        CHECK(!filter.accepts(makeEvent(3, PART_KEY)));
+        CHECK(filter.accepts(makeEvent(4, PART_KEY)));
+
+        // The parts accepted for all the virtual IDs are still accepted
+        CHECK(filter.accepts(makeEvent(3, PART_POV)));
+    }
+
+
+    TEST(AcceptWholeParts)
+    {
+        VirtualEventsFilter filter;
+
+        filter.addPart(PART_AXIS);
+
+        CHECK(filter.accepts(makeEvent(0, PART_AXIS)));
+        CHECK(filter.accepts(makeEvent(1000, PART_AXIS)));
+        CHECK(!filter.accepts(makeEvent(0, PART_KEY)));
+
+        filter.addAll();
+        CHECK(filter.accepts(makeEvent(1000, PART_KEY)));
+        CHECK(filter.accepts(makeEvent(1000, PART_POV)));
+
+        filter.clear();
+        CHECK(!filter.accepts(makeEvent(1000, PART_AXIS)));
+    }
+}